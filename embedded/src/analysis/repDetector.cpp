@@ -0,0 +1,100 @@
+#include <cmath>
+#include "repDetector.h"
+
+RepDetector::RepDetector() noexcept
+{
+    reset();
+}
+
+void RepDetector::reset()
+{
+    reps = 0;
+}
+
+size_t RepDetector::analyze(const VelocitySegment &segment, RepMetrics *out, size_t maxReps)
+{
+    if (segment.count == 0 || segment.periodUs == 0)
+        return 0;
+
+    const float dt = segment.periodUs * 1e-6f;
+    const size_t maxPhaseEntries = Config::RepDetection::MAX_PHASE_DURATION * 1000ULL / segment.periodUs;
+
+    size_t found = 0;
+    bool eccentricPending = false;
+    size_t eccentricStart = 0;
+
+    // Current phase [phaseStart, i); active* bound the entries above MIN_VELOCITY,
+    // so a bar drifting slowly at lockout does not stretch the phase
+    size_t phaseStart = 0;
+    size_t activeStart = 0;
+    size_t activeEnd = 0;
+    bool active = false;
+    float displacement = 0.0f;
+    float peak = 0.0f;
+
+    for (size_t i = 0; i <= segment.count; i++)
+    {
+        bool end = i == segment.count;
+        if (!end && i > phaseStart &&
+            std::signbit(segment.velocity[i]) == std::signbit(segment.velocity[phaseStart]))
+        {
+            float v = segment.velocity[i];
+            float speed = std::fabs(v);
+            displacement += v * dt;
+            peak = std::fmax(peak, speed);
+            if (speed >= Config::RepDetection::MIN_VELOCITY)
+            {
+                if (!active)
+                    activeStart = i;
+                active = true;
+                activeEnd = i + 1;
+            }
+            continue;
+        }
+
+        // A sign change or the end of the segment closes the phase
+        if (active)
+        {
+            size_t length = activeEnd - activeStart;
+
+            if (length > maxPhaseEntries)
+            {
+                // A phase this long is drift, not a rep
+                eccentricPending = false;
+            }
+            else if (displacement < 0.0f)
+            {
+                if (!eccentricPending)
+                    eccentricStart = activeStart;
+                eccentricPending = true;
+            }
+            else if (displacement >= Config::RepDetection::MIN_RANGE && found < maxReps)
+            {
+                size_t tensionStart = eccentricPending ? eccentricStart : activeStart;
+
+                RepMetrics &rep = out[found++];
+                rep.repNumber = ++reps;
+                rep.endTimeMs = static_cast<uint32_t>((segment.startUs + activeEnd * static_cast<uint64_t>(segment.periodUs)) / 1000);
+                rep.meanConcentricVelocity = displacement / (length * dt);
+                rep.peakConcentricVelocity = peak;
+                rep.rangeOfMotion = displacement;
+                rep.concentricMs = static_cast<uint32_t>(length * segment.periodUs / 1000);
+                rep.timeUnderTensionMs = static_cast<uint32_t>((activeEnd - tensionStart) * segment.periodUs / 1000);
+                eccentricPending = false;
+            }
+        }
+
+        if (!end)
+        {
+            float v = segment.velocity[i];
+            phaseStart = i;
+            displacement = v * dt;
+            peak = std::fabs(v);
+            active = peak >= Config::RepDetection::MIN_VELOCITY;
+            activeStart = i;
+            activeEnd = i + 1;
+        }
+    }
+
+    return found;
+}
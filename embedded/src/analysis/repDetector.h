@@ -0,0 +1,52 @@
+#pragma once
+#include "config/config.h"
+#include "integration/velocityIntegrator.h"
+
+/**
+ * @brief Metrics of one completed repetition
+ */
+struct RepMetrics
+{
+    uint16_t repNumber;
+    uint32_t endTimeMs;           // Device time at the top of the rep
+    float meanConcentricVelocity; // m/s
+    float peakConcentricVelocity; // m/s
+    float rangeOfMotion;          // m, concentric displacement
+    uint32_t concentricMs;
+    uint32_t timeUnderTensionMs;  // Eccentric and concentric phase
+};
+
+/**
+ * @brief Segments repetitions from drift-corrected vertical velocity
+ *
+ * Runs once per motion segment of the VelocityIntegrator, so reps are
+ * reported at the next pause (lockout or rack) rather than at the turning
+ * point. The segment is split at velocity zero crossings into eccentric
+ * (down) and concentric (up) phases; phases whose peak stays below
+ * Config::RepDetection::MIN_VELOCITY are noise. A rep is a concentric phase
+ * that travelled at least Config::RepDetection::MIN_RANGE, and its time
+ * under tension starts at the eccentric phase before it, if any.
+ */
+class RepDetector
+{
+public:
+    RepDetector() noexcept;
+
+    /**
+     * @brief Restarts rep numbering
+     */
+    void reset();
+
+    /**
+     * @brief Finds the reps in a motion segment
+     * @param out Destination buffer
+     * @param maxReps Capacity of the destination buffer
+     * @return Number of reps written to out
+     */
+    size_t analyze(const VelocitySegment &segment, RepMetrics *out, size_t maxReps);
+
+    [[nodiscard]] uint16_t repCount() const noexcept { return reps; }
+
+private:
+    uint16_t reps;
+};
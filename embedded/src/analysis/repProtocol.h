@@ -0,0 +1,46 @@
+#pragma once
+#include <cmath>
+#include <cstdint>
+#include "analysis/repDetector.h"
+
+/**
+ * @brief Wire format of the rep characteristic
+ *
+ * One notification per completed rep, so a client that only needs per-rep
+ * metrics can leave the high-rate stream unsubscribed. All fields are
+ * little-endian.
+ */
+struct __attribute__((packed)) RepSummaryPacket
+{
+    uint16_t repNumber;     // Since connect or the last calibration
+    uint32_t endTimeMs;     // Device time at the top of the rep
+    uint16_t meanVelocity;  // mm/s, mean concentric velocity
+    uint16_t peakVelocity;  // mm/s
+    uint16_t rangeOfMotion; // mm
+    uint16_t concentricMs;
+    uint16_t timeUnderTensionMs;
+};
+
+/**
+ * @brief Converts metrics to the packet, saturating at the uint16 range
+ */
+inline RepSummaryPacket encodeRepSummary(const RepMetrics &rep)
+{
+    auto milli = [](float value) -> uint16_t
+    {
+        float scaled = std::round(value * 1000.0f);
+        return scaled <= 0.0f ? 0 : scaled >= 65535.0f ? 65535 : static_cast<uint16_t>(scaled);
+    };
+    auto ms = [](uint32_t value) -> uint16_t
+    { return value > 65535 ? 65535 : static_cast<uint16_t>(value); };
+
+    RepSummaryPacket packet;
+    packet.repNumber = rep.repNumber;
+    packet.endTimeMs = rep.endTimeMs;
+    packet.meanVelocity = milli(rep.meanConcentricVelocity);
+    packet.peakVelocity = milli(rep.peakConcentricVelocity);
+    packet.rangeOfMotion = milli(rep.rangeOfMotion);
+    packet.concentricMs = ms(rep.concentricMs);
+    packet.timeUnderTensionMs = ms(rep.timeUnderTensionMs);
+    return packet;
+}
@@ -0,0 +1,35 @@
+#include "setTracker.h"
+
+SetTracker::SetTracker() noexcept
+{
+    reset();
+}
+
+void SetTracker::reset()
+{
+    reps = 0;
+    lastEndMs = 0;
+    bestMeanVelocity = 0.0f;
+    lastMeanVelocity = 0.0f;
+}
+
+void SetTracker::addRep(const RepMetrics &rep)
+{
+    if (reps > 0 && rep.endTimeMs - lastEndMs > Config::RepDetection::SET_REST_TIMEOUT)
+    {
+        reset();
+    }
+
+    reps++;
+    lastEndMs = rep.endTimeMs;
+    lastMeanVelocity = rep.meanConcentricVelocity;
+    if (rep.meanConcentricVelocity > bestMeanVelocity)
+        bestMeanVelocity = rep.meanConcentricVelocity;
+}
+
+float SetTracker::velocityLoss() const
+{
+    if (bestMeanVelocity <= 0.0f)
+        return 0.0f;
+    return (bestMeanVelocity - lastMeanVelocity) / bestMeanVelocity * 100.0f;
+}
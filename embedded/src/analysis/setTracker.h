@@ -0,0 +1,31 @@
+#pragma once
+#include "analysis/repDetector.h"
+
+/**
+ * @brief Groups reps into sets and tracks the velocity loss within a set
+ *
+ * A rep that ends more than Config::RepDetection::SET_REST_TIMEOUT after
+ * the previous one starts a new set. Velocity loss is the drop of the mean
+ * concentric velocity from the fastest rep of the set to the last one.
+ */
+class SetTracker
+{
+public:
+    SetTracker() noexcept;
+
+    void reset();
+    void addRep(const RepMetrics &rep);
+
+    [[nodiscard]] uint16_t repsInSet() const noexcept { return reps; }
+
+    /**
+     * @brief Velocity loss of the last rep, in percent of the fastest rep
+     */
+    [[nodiscard]] float velocityLoss() const;
+
+private:
+    uint16_t reps;
+    uint32_t lastEndMs;
+    float bestMeanVelocity;
+    float lastMeanVelocity;
+};
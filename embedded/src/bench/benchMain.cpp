@@ -0,0 +1,256 @@
+#include <M5StickCPlus2.h>
+#include <algorithm>
+#include <cmath>
+#include "calibration/sensorCorrection.h"
+#include "config/config.h"
+#include "display/displayController.h"
+#include "fusion/madgwickFilter.h"
+#include "integration/velocityIntegrator.h"
+#include "sensor/acquisitionProfile.h"
+#include "sensor/correctedSample.h"
+#include "sensor/imuBatch.h"
+#include "stream/sampleBatcher.h"
+#include "utils/logger.h"
+
+/**
+ * @brief On-target microbenchmark of the firmware stages
+ *
+ * Built by the m5stick-c-plus2-bench env instead of the application:
+ *
+ *   pio run -e m5stick-c-plus2-bench -t upload -t monitor
+ *
+ * Runs a canned full-FIFO batch of a synthetic lift through correction,
+ * fusion, integration, every stream encoding and a display line redraw,
+ * timing each call with the CPU cycle counter. Prints min and median
+ * cycles per call and per sample, and the share of the sample period at
+ * the fastest acquisition profile, then repeats every few seconds.
+ *
+ * Cycle counts are per core and stay comparable across builds, so float vs
+ * fixed-point or flash vs IRAM placement of a hot function shows up as a
+ * change in cycles rather than noise in wall time. The median hides the
+ * occasional interrupt landing in a measurement.
+ */
+
+namespace
+{
+    constexpr char MODULE_NAME[] = "BENCH";
+    constexpr size_t ITERATIONS = 200;
+    constexpr uint32_t REPEAT_INTERVAL = 10000; // ms
+    constexpr AcquisitionProfile PROFILE = AcquisitionProfile::OLYMPIC_MAX;
+
+    struct StageResult
+    {
+        uint32_t minCycles;
+        uint32_t medianCycles;
+        uint32_t maxCycles;
+    };
+
+    class DiscardSink : public FrameSink
+    {
+    public:
+        void sendFrame(const uint8_t * /*data*/, size_t /*length*/) override {}
+    };
+
+    RawImuBatch rawBatch;
+    ImuBatch batch;
+    CorrectedSample samples[RawImuBatch::CAPACITY];
+    uint32_t cycles[ITERATIONS];
+    uint32_t nextIndex = 0;
+
+    SensorCorrection correction;
+    MadgwickFilter fusion;
+    VelocityIntegrator velocityIntegrator;
+    DiscardSink discardSink;
+    SampleBatcher sampleBatcher(discardSink);
+    DisplayController deviceDisplay;
+
+    /**
+     * @brief Fills the raw batch with a vertical lift at 1 Hz, quantized like the FIFO
+     */
+    void buildCannedBatch()
+    {
+        const ProfileSettings &settings = profileSettings(PROFILE);
+        uint32_t periodUs = settings.samplePeriodUs();
+
+        for (size_t i = 0; i < RawImuBatch::CAPACITY; i++)
+        {
+            float t = i * periodUs * 1e-6f;
+            float lift = 0.4f * sinf(2.0f * static_cast<float>(M_PI) * t);
+            float accel[3] = {0.02f, -0.03f, 1.0f + lift};          // g
+            float gyro[3] = {1.5f * lift, 0.4f, -0.8f * lift};      // °/s
+            for (int axis = 0; axis < 3; axis++)
+            {
+                rawBatch.accel[axis][i] = static_cast<int16_t>(lroundf(accel[axis] * settings.accelLsbPerG));
+                rawBatch.gyro[axis][i] = static_cast<int16_t>(lroundf(gyro[axis] * settings.gyroLsbPerDps));
+            }
+            rawBatch.temperature[i] = static_cast<int16_t>(
+                (31.0f - Config::IMU::Fifo::TEMP_OFFSET) * Config::IMU::Fifo::TEMP_LSB_PER_DEG);
+        }
+        rawBatch.count = RawImuBatch::CAPACITY;
+        rawBatch.firstIndex = 0;
+        rawBatch.firstTimestampUs = 0;
+        rawBatch.periodUs = periodUs;
+        rawBatch.clockPeriodQ16 = periodUs << 16;
+        rawBatch.accelRes = 1.0f / settings.accelLsbPerG;
+        rawBatch.gyroRes = 1.0f / settings.gyroLsbPerDps;
+
+        // A valid calibration, so correction runs its full path
+        CalibrationData data;
+        data.accelMatrix = Matrix3::identity();
+        data.accelOffset = Vector3D(0.01f, -0.02f, 0.005f);
+        data.gyroBias = Vector3D(0.3f, -0.2f, 0.1f);
+        data.temperature = 30.0f;
+        data.method = CalibrationMethod::SIX_POSITION;
+        data.isValid = true;
+        correction.publish(data);
+    }
+
+    /**
+     * @brief Gives the canned samples indices following the previous run
+     *
+     * Keeps the batcher and integrator seeing one continuous stream.
+     */
+    void advanceSamples()
+    {
+        for (CorrectedSample &sample : samples)
+        {
+            sample.imu.index = nextIndex;
+            sample.imu.timestampUs = static_cast<uint64_t>(nextIndex) * rawBatch.periodUs;
+            nextIndex++;
+        }
+    }
+
+    /**
+     * @brief Times ITERATIONS calls of run after one untimed warm-up call
+     * @param prepare Untimed setup before every call
+     */
+    template <typename Prepare, typename Run>
+    StageResult measure(Prepare &&prepare, Run &&run)
+    {
+        prepare();
+        run(); // Warms the flash cache
+
+        for (size_t i = 0; i < ITERATIONS; i++)
+        {
+            prepare();
+            uint32_t start = ESP.getCycleCount();
+            run();
+            cycles[i] = ESP.getCycleCount() - start;
+            if (i % 16 == 15)
+                yield(); // Let the idle task feed the watchdog
+        }
+
+        std::sort(cycles, cycles + ITERATIONS);
+        StageResult result;
+        result.minCycles = cycles[0];
+        result.medianCycles = cycles[ITERATIONS / 2];
+        result.maxCycles = cycles[ITERATIONS - 1];
+        return result;
+    }
+
+    template <typename Run>
+    StageResult measure(Run &&run)
+    {
+        return measure([] {}, run);
+    }
+
+    void printRow(const char *name, size_t samplesPerCall, const StageResult &result)
+    {
+        uint32_t mhz = ESP.getCpuFreqMHz();
+        uint32_t periodUs = profileSettings(PROFILE).samplePeriodUs();
+        float perSample = static_cast<float>(result.medianCycles) / samplesPerCall;
+        float budget = perSample / mhz / periodUs * 100.0f;
+        Serial.printf("%-16s %10lu %10lu %10lu %10.0f %9.2f %7.2f%%\n", name,
+                      static_cast<unsigned long>(result.minCycles), static_cast<unsigned long>(result.medianCycles),
+                      static_cast<unsigned long>(result.maxCycles), perSample, perSample / mhz, budget);
+    }
+
+    void runBenchmarks()
+    {
+        const ProfileSettings &settings = profileSettings(PROFILE);
+        const size_t count = RawImuBatch::CAPACITY;
+
+        Serial.printf("\nStage cycles at %lu MHz, %u samples per call, %s profile (%lu us per sample)\n",
+                      static_cast<unsigned long>(ESP.getCpuFreqMHz()), static_cast<unsigned>(count),
+                      settings.name, static_cast<unsigned long>(settings.samplePeriodUs()));
+        Serial.printf("%-16s %10s %10s %10s %10s %9s %8s\n", "stage", "min", "median", "max", "per sample",
+                      "us/sample", "budget");
+
+        printRow("correction", count, measure([] { correction.correctBatch(rawBatch, batch); }));
+
+        float dt = rawBatch.periodUs * 1e-6f;
+        printRow("fusion", count, measure([dt] {
+                     for (size_t i = 0; i < count; i++)
+                     {
+                         Vector3D accel(batch.accel[0][i], batch.accel[1][i], batch.accel[2][i]);
+                         Vector3D gyro(batch.gyro[0][i], batch.gyro[1][i], batch.gyro[2][i]);
+                         fusion.update(accel, gyro, dt);
+                         samples[i].imu.accel = accel;
+                         samples[i].imu.gyro = gyro;
+                         samples[i].orientation = fusion.orientation();
+                         samples[i].linearAccel = fusion.linearAcceleration(accel);
+                     }
+                 }));
+
+        for (size_t i = 0; i < count; i++)
+        {
+            samples[i].imu.temperature = RawImuBatch::toCelsius(rawBatch.temperature[i]);
+            samples[i].isCorrected = true;
+            samples[i].profile = PROFILE;
+        }
+
+        printRow("integration", count, measure(advanceSamples, [] {
+                     for (const CorrectedSample &sample : samples)
+                         velocityIntegrator.update(sample, rawBatch.periodUs);
+                 }));
+
+        const struct
+        {
+            const char *name;
+            StreamFormat format;
+        } encodings[] = {
+            {"encode float32", StreamFormat::FLOAT32},
+            {"encode int16", StreamFormat::INT16},
+            {"encode delta", StreamFormat::INT16_DELTA},
+            {"encode fusion", StreamFormat::FUSION},
+        };
+        sampleBatcher.setMtu(Config::Stream::PREFERRED_MTU);
+        sampleBatcher.setScale(settings.accelLsbPerG, settings.gyroLsbPerDps);
+        for (const auto &encoding : encodings)
+        {
+            sampleBatcher.setFormat(encoding.format);
+            sampleBatcher.reset();
+            printRow(encoding.name, count, measure(advanceSamples, [] {
+                         for (const CorrectedSample &sample : samples)
+                             sampleBatcher.add(sample, rawBatch.periodUs);
+                     }));
+        }
+
+        // Alternating values, so every call redraws the velocity line
+        deviceDisplay.wakeDisplay();
+        bool flip = false;
+        printRow("display line", 1, measure([&flip] {
+                     flip = !flip;
+                     deviceDisplay.updateVelocity(flip ? 1.23f : -1.23f);
+                 }));
+    }
+}
+
+void setup()
+{
+    Serial.begin(115200);
+    Logger::begin();
+    M5.begin();
+
+    buildCannedBatch();
+    deviceDisplay.begin();
+    Logger::logf(Logger::Level::INFO, MODULE_NAME, "Running %u iterations per stage",
+                 static_cast<unsigned>(ITERATIONS));
+    Logger::flush();
+}
+
+void loop()
+{
+    runBenchmarks();
+    delay(REPEAT_INTERVAL);
+}
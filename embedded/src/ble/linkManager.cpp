@@ -0,0 +1,168 @@
+#include <cstring>
+#include "linkManager.h"
+
+constexpr char LinkManager::MODULE_NAME[];
+
+namespace
+{
+    LinkInfoPacket disconnectedInfo()
+    {
+        return LinkInfoPacket{Config::Stream::DEFAULT_MTU, 0, 0, 0, Config::Stream::DEFAULT_DATA_LENGTH, 1};
+    }
+}
+
+LinkManager::LinkManager() noexcept
+    : server(nullptr),
+      characteristic(nullptr),
+      notifyDescriptor(nullptr),
+      linkMux(portMUX_INITIALIZER_UNLOCKED),
+      connected(false),
+      newConnection(false),
+      changed(false),
+      peer{},
+      current(disconnectedInfo()),
+      paramsPending(false),
+      requestMin(0),
+      requestMax(0),
+      requestLatency(0),
+      requestTimeout(0)
+{
+}
+
+void LinkManager::begin(BLEServer *bleServer, BLECharacteristic *linkCharacteristic, BLE2902 *descriptor)
+{
+    server = bleServer;
+    characteristic = linkCharacteristic;
+    notifyDescriptor = descriptor;
+    BLEDevice::setMTU(Config::Stream::PREFERRED_MTU);
+
+    LinkInfoPacket packet = disconnectedInfo();
+    characteristic->setValue(reinterpret_cast<uint8_t *>(&packet), sizeof(packet));
+}
+
+void LinkManager::onConnect(const esp_ble_gatts_cb_param_t *param)
+{
+    portENTER_CRITICAL(&linkMux);
+    memcpy(peer, param->connect.remote_bda, sizeof(peer));
+    current = disconnectedInfo();
+    current.connInterval = param->connect.conn_params.interval;
+    current.latency = param->connect.conn_params.latency;
+    current.supervisionTimeout = param->connect.conn_params.timeout;
+    connected = true;
+    newConnection = true;
+    changed = true;
+    portEXIT_CRITICAL(&linkMux);
+}
+
+void LinkManager::onDisconnect()
+{
+    portENTER_CRITICAL(&linkMux);
+    connected = false;
+    current = disconnectedInfo();
+    changed = true;
+    portEXIT_CRITICAL(&linkMux);
+}
+
+void LinkManager::onMtuChanged(uint16_t mtu)
+{
+    portENTER_CRITICAL(&linkMux);
+    current.mtu = mtu;
+    changed = true;
+    portEXIT_CRITICAL(&linkMux);
+}
+
+void LinkManager::onGapEvent(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param)
+{
+    portENTER_CRITICAL(&linkMux);
+    if (event == ESP_GAP_BLE_UPDATE_CONN_PARAMS_EVT && param->update_conn_params.status == ESP_BT_STATUS_SUCCESS)
+    {
+        current.connInterval = param->update_conn_params.conn_int;
+        current.latency = param->update_conn_params.latency;
+        current.supervisionTimeout = param->update_conn_params.timeout;
+        changed = true;
+    }
+    else if (event == ESP_GAP_BLE_SET_PKT_LENGTH_COMPLETE_EVT && param->pkt_data_length_cmpl.status == ESP_BT_STATUS_SUCCESS)
+    {
+        current.txDataLength = param->pkt_data_length_cmpl.params.tx_len;
+        changed = true;
+    }
+    portEXIT_CRITICAL(&linkMux);
+}
+
+void LinkManager::requestConnectionParams(uint16_t minInterval, uint16_t maxInterval, uint16_t latency, uint16_t timeout)
+{
+    portENTER_CRITICAL(&linkMux);
+    paramsPending = paramsPending || minInterval != requestMin || maxInterval != requestMax ||
+                    latency != requestLatency || timeout != requestTimeout;
+    requestMin = minInterval;
+    requestMax = maxInterval;
+    requestLatency = latency;
+    requestTimeout = timeout;
+    portEXIT_CRITICAL(&linkMux);
+}
+
+void LinkManager::update()
+{
+    portENTER_CRITICAL(&linkMux);
+    bool isConnected = connected;
+    bool justConnected = newConnection;
+    bool sendParams = connected && (paramsPending || newConnection) && requestMax > 0;
+    bool publish = changed;
+    esp_bd_addr_t address;
+    memcpy(address, peer, sizeof(address));
+    LinkInfoPacket packet = current;
+    uint16_t minInterval = requestMin;
+    uint16_t maxInterval = requestMax;
+    uint16_t latency = requestLatency;
+    uint16_t timeout = requestTimeout;
+    newConnection = false;
+    changed = false;
+    if (sendParams)
+        paramsPending = false;
+    portEXIT_CRITICAL(&linkMux);
+
+    if (justConnected)
+    {
+        esp_err_t result = esp_ble_gap_set_pkt_data_len(address, Config::Stream::MAX_DATA_LENGTH);
+        if (result != ESP_OK)
+        {
+            Logger::logf(Logger::Level::WARN, MODULE_NAME, "Data length request failed: %d", result);
+        }
+    }
+
+    if (sendParams && server)
+    {
+        Logger::logf(Logger::Level::DEBUG, MODULE_NAME, "Requesting interval %u-%u, latency %u",
+                     minInterval, maxInterval, latency);
+        server->updateConnParams(address, minInterval, maxInterval, latency, timeout);
+    }
+
+    if (publish && characteristic)
+    {
+        Logger::logf(Logger::Level::INFO, MODULE_NAME,
+                     "MTU %u, interval %.2f ms, latency %u, timeout %u ms, data length %u",
+                     packet.mtu, packet.connInterval * 1.25f, packet.latency,
+                     packet.supervisionTimeout * 10u, packet.txDataLength);
+        characteristic->setValue(reinterpret_cast<uint8_t *>(&packet), sizeof(packet));
+        if (isConnected && notifyDescriptor && notifyDescriptor->getNotifications())
+        {
+            characteristic->notify();
+        }
+    }
+}
+
+uint16_t LinkManager::mtu()
+{
+    portENTER_CRITICAL(&linkMux);
+    uint16_t value = current.mtu;
+    portEXIT_CRITICAL(&linkMux);
+    return value;
+}
+
+LinkInfoPacket LinkManager::info()
+{
+    portENTER_CRITICAL(&linkMux);
+    LinkInfoPacket packet = current;
+    portEXIT_CRITICAL(&linkMux);
+    return packet;
+}
@@ -0,0 +1,68 @@
+#pragma once
+#include <BLEDevice.h>
+#include <BLEServer.h>
+#include <BLE2902.h>
+#include "ble/linkProtocol.h"
+#include "config/config.h"
+#include "utils/logger.h"
+
+/**
+ * @brief Negotiates and reports the parameters of the BLE connection
+ *
+ * The client starts the MTU exchange (BLEDevice::setMTU only sets what we
+ * accept); the device asks for data length extension on connect and for
+ * connection intervals through requestConnectionParams. The ESP32 radio
+ * only has the LE 1M PHY, so the PHY is reported but never changed.
+ *
+ * The on* callbacks run on the BLE task and only record state; update()
+ * acts on it from the comms task, so no callback blocks the BLE stack.
+ */
+class LinkManager
+{
+public:
+    static constexpr char MODULE_NAME[] = "LINK";
+
+    LinkManager() noexcept;
+
+    void begin(BLEServer *server, BLECharacteristic *linkCharacteristic, BLE2902 *notifyDescriptor);
+
+    void onConnect(const esp_ble_gatts_cb_param_t *param);
+    void onDisconnect();
+    void onMtuChanged(uint16_t mtu);
+    void onGapEvent(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param);
+
+    /**
+     * @brief Asks the central for new connection parameters
+     *
+     * Ignored while disconnected; the current request is sent again for
+     * every new connection.
+     * @param minInterval 1.25 ms units
+     * @param maxInterval 1.25 ms units
+     * @param timeout 10 ms units
+     */
+    void requestConnectionParams(uint16_t minInterval, uint16_t maxInterval, uint16_t latency, uint16_t timeout);
+
+    /**
+     * @brief Sends pending requests and publishes changed link parameters
+     */
+    void update();
+
+    [[nodiscard]] uint16_t mtu();
+    [[nodiscard]] LinkInfoPacket info();
+
+private:
+    BLEServer *server;
+    BLECharacteristic *characteristic;
+    BLE2902 *notifyDescriptor;
+    portMUX_TYPE linkMux;        // Guards the fields below, written by the BLE task
+    bool connected;
+    bool newConnection;          // Connected since the last update()
+    bool changed;                // info differs from the published value
+    esp_bd_addr_t peer;
+    LinkInfoPacket current;
+    bool paramsPending;
+    uint16_t requestMin;
+    uint16_t requestMax;
+    uint16_t requestLatency;
+    uint16_t requestTimeout;
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief Wire format of the link characteristic
+ *
+ * The parameters the connection actually runs with, notified whenever one
+ * of them changes. All fields are little-endian.
+ */
+struct __attribute__((packed)) LinkInfoPacket
+{
+    uint16_t mtu;                // ATT MTU
+    uint16_t connInterval;       // 1.25 ms units
+    uint16_t latency;            // Connection events the device may skip
+    uint16_t supervisionTimeout; // 10 ms units
+    uint16_t txDataLength;       // LL payload bytes, 27 without data length extension
+    uint8_t phy;                 // 1 = LE 1M, 2 = LE 2M
+};
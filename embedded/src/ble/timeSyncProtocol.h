@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+
+static constexpr uint8_t TIME_SYNC_PROTOCOL_VERSION = 1;
+
+/**
+ * @brief Written by the app to the time sync characteristic, without response
+ */
+struct __attribute__((packed)) TimeSyncPing
+{
+    uint16_t sequence; // Echoed back, matches the echo to the send time
+};
+
+/**
+ * @brief Notified for every ping
+ *
+ * Both times are esp_timer microseconds, the clock of the sample
+ * timestamps. The app takes its own time when writing the ping and when
+ * the echo arrives; the round trip minus the time the device held the ping
+ * bounds the offset error, and offsets over a longer span give the skew.
+ * All fields are little-endian.
+ */
+struct __attribute__((packed)) TimeSyncEcho
+{
+    uint8_t version;    // TIME_SYNC_PROTOCOL_VERSION
+    uint16_t sequence;
+    uint64_t receiveUs; // When the write reached the characteristic
+    uint64_t transmitUs; // Right before the notification was queued
+};
@@ -0,0 +1,78 @@
+#include <Preferences.h>
+#include "unitIdentity.h"
+
+constexpr char UnitIdentity::MODULE_NAME[];
+constexpr char UnitIdentity::NAMESPACE[];
+constexpr char UnitIdentity::KEY[];
+
+UnitIdentity::UnitIdentity() noexcept
+    : id(0),
+      currentRole(static_cast<uint8_t>(UnitRole::SOLO)),
+      roleChanged(false)
+{
+}
+
+void UnitIdentity::begin()
+{
+    // The first three bytes are the vendor prefix, shared by every unit
+    id = static_cast<uint32_t>((ESP.getEfuseMac() >> 24) & 0xFFFFFF);
+
+    Preferences prefs;
+    uint8_t stored = static_cast<uint8_t>(UnitRole::SOLO);
+    if (prefs.begin(NAMESPACE, true))
+    {
+        stored = prefs.getUChar(KEY, stored);
+        prefs.end();
+    }
+    if (!isValidRole(stored))
+    {
+        stored = static_cast<uint8_t>(UnitRole::SOLO);
+    }
+    currentRole.store(stored, std::memory_order_relaxed);
+
+    Logger::logf(Logger::Level::INFO, MODULE_NAME, "Unit %06lX, role %u", static_cast<unsigned long>(id),
+                 static_cast<unsigned>(stored));
+}
+
+bool UnitIdentity::isValidRole(uint8_t value)
+{
+    return value < static_cast<uint8_t>(UnitRole::COUNT);
+}
+
+void UnitIdentity::setRole(UnitRole role)
+{
+    currentRole.store(static_cast<uint8_t>(role), std::memory_order_relaxed);
+    roleChanged.store(true, std::memory_order_release);
+}
+
+bool UnitIdentity::applyPending()
+{
+    if (!roleChanged.exchange(false, std::memory_order_acquire))
+        return false;
+
+    Error error = save(role());
+    if (error.isError())
+    {
+        Logger::error(MODULE_NAME, error.message());
+    }
+    return true;
+}
+
+Error UnitIdentity::save(UnitRole role)
+{
+    Preferences prefs;
+    if (!prefs.begin(NAMESPACE, false))
+    {
+        return Error(Error::Code::IO_ERROR, "Failed to open unit storage");
+    }
+    size_t written = prefs.putUChar(KEY, static_cast<uint8_t>(role));
+    prefs.end();
+
+    if (written != sizeof(uint8_t))
+    {
+        return Error(Error::Code::IO_ERROR, "Failed to store unit role");
+    }
+
+    Logger::logf(Logger::Level::INFO, MODULE_NAME, "Role %u stored", static_cast<unsigned>(role));
+    return Error(Error::Code::NONE, "Success");
+}
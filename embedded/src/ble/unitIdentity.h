@@ -0,0 +1,74 @@
+#pragma once
+#include <Arduino.h>
+#include <atomic>
+#include "utils/error.h"
+#include "utils/logger.h"
+
+/**
+ * @brief Where a unit sits when several stream into one session
+ *
+ * Values are part of the BLE protocol (CalibrationCommand::SET_ROLE) and
+ * fill the top two bits of the stream frame unit byte.
+ */
+enum class UnitRole : uint8_t
+{
+    SOLO = 0,      // The only unit, normal connection intervals
+    BAR_LEFT = 1,  // Left bar end, looking along the bar from the lifter
+    BAR_RIGHT = 2,
+    ATHLETE = 3,   // Worn by the lifter
+    COUNT
+};
+
+/**
+ * @brief Unit ID and role, so the app can tell and merge several units
+ *
+ * The ID is the device-specific half of the factory MAC and never changes;
+ * the role is chosen by the app and kept in NVS. setRole may be called from
+ * BLE callbacks, the role is stored by applyPending() on the comms task.
+ */
+class UnitIdentity
+{
+public:
+    static constexpr char MODULE_NAME[] = "UNIT";
+
+    UnitIdentity() noexcept;
+
+    /**
+     * @brief Reads the unit ID and the stored role
+     */
+    void begin();
+
+    static bool isValidRole(uint8_t value);
+
+    void setRole(UnitRole role);
+
+    /**
+     * @brief Stores a role set since the last call
+     * @return true if the role changed
+     */
+    bool applyPending();
+
+    [[nodiscard]] UnitRole role() const noexcept
+    {
+        return static_cast<UnitRole>(currentRole.load(std::memory_order_relaxed));
+    }
+    [[nodiscard]] uint32_t unitId() const noexcept { return id; }
+
+    /**
+     * @brief Identifies the unit in every stream frame: role and the low six ID bits
+     */
+    [[nodiscard]] uint8_t frameTag() const noexcept
+    {
+        return static_cast<uint8_t>((static_cast<uint8_t>(role()) << 6) | (id & 0x3F));
+    }
+
+private:
+    static constexpr char NAMESPACE[] = "unit";
+    static constexpr char KEY[] = "role";
+
+    uint32_t id;
+    std::atomic<uint8_t> currentRole;
+    std::atomic<bool> roleChanged;
+
+    Error save(UnitRole role);
+};
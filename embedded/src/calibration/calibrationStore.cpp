@@ -0,0 +1,94 @@
+#include "calibrationStore.h"
+
+constexpr char CalibrationStore::MODULE_NAME[];
+constexpr char CalibrationStore::NAMESPACE[];
+constexpr char CalibrationStore::KEY[];
+
+Error CalibrationStore::load(CalibrationData &data)
+{
+    data.isValid = false;
+
+    Preferences prefs;
+    if (!prefs.begin(NAMESPACE, true))
+    {
+        return Error(Error::Code::CALIBRATION_FAILED, "No stored calibration");
+    }
+
+    Record record;
+    size_t length = prefs.getBytesLength(KEY);
+    bool readOk = length == sizeof(record) && prefs.getBytes(KEY, &record, sizeof(record)) == sizeof(record);
+    prefs.end();
+
+    if (!readOk)
+    {
+        return Error(Error::Code::CALIBRATION_FAILED, "No stored calibration");
+    }
+    if (record.version != FORMAT_VERSION)
+    {
+        return Error(Error::Code::CALIBRATION_FAILED, "Stored calibration has an old format");
+    }
+
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 3; c++)
+            data.accelMatrix.m[r][c] = record.matrix[r * 3 + c];
+    }
+    data.accelOffset = Vector3D(record.offset[0], record.offset[1], record.offset[2]);
+    data.gyroBias = Vector3D(record.gyroBias[0], record.gyroBias[1], record.gyroBias[2]);
+    data.temperature = record.temperature;
+    data.method = static_cast<CalibrationMethod>(record.method);
+    data.isValid = true;
+
+    Logger::logf(Logger::Level::INFO, MODULE_NAME, "Loaded calibration (method %d, %.1f °C)",
+                 static_cast<int>(data.method), data.temperature);
+    return Error(Error::Code::NONE, "Success");
+}
+
+Error CalibrationStore::save(const CalibrationData &data)
+{
+    Record record;
+    record.version = FORMAT_VERSION;
+    record.method = static_cast<uint8_t>(data.method);
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 3; c++)
+            record.matrix[r * 3 + c] = data.accelMatrix.m[r][c];
+    }
+    record.offset[0] = data.accelOffset.x;
+    record.offset[1] = data.accelOffset.y;
+    record.offset[2] = data.accelOffset.z;
+    record.gyroBias[0] = data.gyroBias.x;
+    record.gyroBias[1] = data.gyroBias.y;
+    record.gyroBias[2] = data.gyroBias.z;
+    record.temperature = data.temperature;
+
+    Preferences prefs;
+    if (!prefs.begin(NAMESPACE, false))
+    {
+        return Error(Error::Code::CALIBRATION_FAILED, "Failed to open calibration storage");
+    }
+    size_t written = prefs.putBytes(KEY, &record, sizeof(record));
+    prefs.end();
+
+    if (written != sizeof(record))
+    {
+        return Error(Error::Code::CALIBRATION_FAILED, "Failed to store calibration");
+    }
+
+    Logger::info(MODULE_NAME, "Calibration stored");
+    return Error(Error::Code::NONE, "Success");
+}
+
+Error CalibrationStore::clear()
+{
+    Preferences prefs;
+    if (!prefs.begin(NAMESPACE, false))
+    {
+        return Error(Error::Code::CALIBRATION_FAILED, "Failed to open calibration storage");
+    }
+    prefs.remove(KEY);
+    prefs.end();
+
+    Logger::info(MODULE_NAME, "Stored calibration cleared");
+    return Error(Error::Code::NONE, "Success");
+}
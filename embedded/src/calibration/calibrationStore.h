@@ -0,0 +1,46 @@
+#pragma once
+#include <Preferences.h>
+#include "calibration/sensorCorrection.h"
+#include "utils/error.h"
+#include "utils/logger.h"
+
+/**
+ * @brief Persists calibration coefficients in NVS
+ *
+ * A single blob in the "calib" namespace, prefixed with a format version.
+ * Blobs of another version or size are ignored, so a firmware update that
+ * changes CalibrationData only costs one recalibration.
+ */
+class CalibrationStore
+{
+public:
+    static constexpr char MODULE_NAME[] = "CALSTORE";
+    static constexpr uint8_t FORMAT_VERSION = 1;
+
+    /**
+     * @brief Reads the stored coefficients
+     * @param data Filled and marked valid on success, left invalid otherwise
+     */
+    Error load(CalibrationData &data);
+
+    Error save(const CalibrationData &data);
+
+    /**
+     * @brief Removes the stored coefficients
+     */
+    Error clear();
+
+private:
+    static constexpr char NAMESPACE[] = "calib";
+    static constexpr char KEY[] = "data";
+
+    struct __attribute__((packed)) Record
+    {
+        uint8_t version;
+        uint8_t method;    // CalibrationMethod
+        float matrix[9];   // Row-major
+        float offset[3];
+        float gyroBias[3];
+        float temperature; // °C during calibration
+    };
+};
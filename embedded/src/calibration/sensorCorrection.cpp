@@ -0,0 +1,182 @@
+#include <cmath>
+#include "sensorCorrection.h"
+
+SensorCorrection::SensorCorrection() noexcept
+    : calibMux(portMUX_INITIALIZER_UNLOCKED),
+      generationCount(0)
+{
+    calibData.accelMatrix = Matrix3::identity();
+    calibData.temperature = 0.0f;
+    calibData.method = CalibrationMethod::NONE;
+    calibData.isValid = false;
+}
+
+void SensorCorrection::publish(const CalibrationData &data)
+{
+    portENTER_CRITICAL(&calibMux);
+    calibData = data;
+    temperatureModel.reset(data.temperature);
+    portEXIT_CRITICAL(&calibMux);
+    generationCount++;
+}
+
+void SensorCorrection::invalidate()
+{
+    portENTER_CRITICAL(&calibMux);
+    calibData.isValid = false;
+    portEXIT_CRITICAL(&calibMux);
+    generationCount++;
+}
+
+CalibrationData SensorCorrection::data()
+{
+    portENTER_CRITICAL(&calibMux);
+    CalibrationData copy = calibData;
+    portEXIT_CRITICAL(&calibMux);
+    return copy;
+}
+
+CorrectionCoefficients SensorCorrection::coefficients(float temperature, float accelRes, float gyroRes)
+{
+    // Called from the sensor task; take a consistent copy of the coefficients
+    Vector3D gyroDrift;
+    portENTER_CRITICAL(&calibMux);
+    CalibrationData data = calibData;
+    if (Config::TemperatureCompensation::ENABLED && data.isValid)
+        gyroDrift = temperatureModel.evaluate(temperature);
+    portEXIT_CRITICAL(&calibMux);
+
+    CorrectionCoefficients coeffs;
+    coeffs.isValid = data.isValid;
+    if (!data.isValid)
+    {
+        data.accelMatrix = Matrix3::identity();
+        data.accelOffset = Vector3D();
+        data.gyroBias = Vector3D();
+    }
+
+    Vector3D accelOffset = data.accelOffset;
+    Vector3D gyroOffset = Vector3D() - data.gyroBias - gyroDrift;
+    const float accelOffsets[3] = {accelOffset.x, accelOffset.y, accelOffset.z};
+    const float gyroOffsets[3] = {gyroOffset.x, gyroOffset.y, gyroOffset.z};
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 3; c++)
+            coeffs.accelMatrix[r][c] = data.accelMatrix.m[r][c] * accelRes;
+        coeffs.accelOffset[r] = accelOffsets[r];
+        coeffs.gyroOffset[r] = gyroOffsets[r];
+    }
+    coeffs.gyroScale = gyroRes;
+    coeffs.gyroDeadband = data.isValid ? Config::Calibration::GYRO_DEADBAND : 0.0f;
+    return coeffs;
+}
+
+namespace
+{
+    /**
+     * @brief Applies the coefficients to count samples of per-axis arrays
+     *
+     * Input and output may alias: each sample is read completely before it
+     * is written. gyroResidual receives the gyro before the deadband. The
+     * deadband is a multiply by 0 or 1, so the loop has no data-dependent
+     * branches.
+     */
+    template <typename T>
+    void applyCoefficients(const CorrectionCoefficients &c,
+                           const T *const accelIn[3], const T *const gyroIn[3],
+                           float *const accelOut[3], float *const gyroOut[3],
+                           float *const gyroResidual[3], size_t count)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            float ax = accelIn[0][i];
+            float ay = accelIn[1][i];
+            float az = accelIn[2][i];
+            accelOut[0][i] = c.accelMatrix[0][0] * ax + c.accelMatrix[0][1] * ay + c.accelMatrix[0][2] * az + c.accelOffset[0];
+            accelOut[1][i] = c.accelMatrix[1][0] * ax + c.accelMatrix[1][1] * ay + c.accelMatrix[1][2] * az + c.accelOffset[1];
+            accelOut[2][i] = c.accelMatrix[2][0] * ax + c.accelMatrix[2][1] * ay + c.accelMatrix[2][2] * az + c.accelOffset[2];
+
+            for (int axis = 0; axis < 3; axis++)
+            {
+                float g = c.gyroScale * gyroIn[axis][i] + c.gyroOffset[axis];
+                gyroResidual[axis][i] = g;
+                gyroOut[axis][i] = g * static_cast<float>(std::fabs(g) >= c.gyroDeadband);
+            }
+        }
+    }
+}
+
+CorrectedData SensorCorrection::correctSensorData(const Vector3D &rawAccel, const Vector3D &rawGyro, float temperature)
+{
+    CorrectionCoefficients coeffs = coefficients(temperature, 1.0f, 1.0f);
+
+    float accel[3] = {rawAccel.x, rawAccel.y, rawAccel.z};
+    float gyro[3] = {rawGyro.x, rawGyro.y, rawGyro.z};
+    const float *const accelIn[3] = {&accel[0], &accel[1], &accel[2]};
+    const float *const gyroIn[3] = {&gyro[0], &gyro[1], &gyro[2]};
+    float *const accelOut[3] = {&accel[0], &accel[1], &accel[2]};
+    float *const gyroOut[3] = {&gyro[0], &gyro[1], &gyro[2]};
+    float residual[3];
+    float *const gyroResidual[3] = {&residual[0], &residual[1], &residual[2]};
+    applyCoefficients(coeffs, accelIn, gyroIn, accelOut, gyroOut, gyroResidual, 1);
+
+    CorrectedData result;
+    result.accel = Vector3D(accel[0], accel[1], accel[2]);
+    result.gyro = Vector3D(gyro[0], gyro[1], gyro[2]);
+    result.isValid = coeffs.isValid;
+    return result;
+}
+
+bool SensorCorrection::correctBatch(const RawImuBatch &raw, ImuBatch &out)
+{
+    int32_t temperatureSum = 0;
+    for (size_t i = 0; i < raw.count; i++)
+        temperatureSum += raw.temperature[i];
+    float temperature = raw.count > 0 ? RawImuBatch::toCelsius(static_cast<int16_t>(temperatureSum / static_cast<int32_t>(raw.count))) : 0.0f;
+
+    CorrectionCoefficients coeffs = coefficients(temperature, raw.accelRes, raw.gyroRes);
+
+    const int16_t *const accelIn[3] = {raw.accel[0], raw.accel[1], raw.accel[2]};
+    const int16_t *const gyroIn[3] = {raw.gyro[0], raw.gyro[1], raw.gyro[2]};
+    float *const accelOut[3] = {out.accel[0], out.accel[1], out.accel[2]};
+    float *const gyroOut[3] = {out.gyro[0], out.gyro[1], out.gyro[2]};
+    float *const gyroResidual[3] = {out.gyroResidual[0], out.gyroResidual[1], out.gyroResidual[2]};
+    applyCoefficients(coeffs, accelIn, gyroIn, accelOut, gyroOut, gyroResidual, raw.count);
+    out.count = raw.count;
+    return coeffs.isValid;
+}
+
+bool SensorCorrection::correctBatch(ImuBatch &batch, float temperature)
+{
+    CorrectionCoefficients coeffs = coefficients(temperature, 1.0f, 1.0f);
+
+    const float *const accelIn[3] = {batch.accel[0], batch.accel[1], batch.accel[2]};
+    const float *const gyroIn[3] = {batch.gyro[0], batch.gyro[1], batch.gyro[2]};
+    float *const accelOut[3] = {batch.accel[0], batch.accel[1], batch.accel[2]};
+    float *const gyroOut[3] = {batch.gyro[0], batch.gyro[1], batch.gyro[2]};
+    float *const gyroResidual[3] = {batch.gyroResidual[0], batch.gyroResidual[1], batch.gyroResidual[2]};
+    applyCoefficients(coeffs, accelIn, gyroIn, accelOut, gyroOut, gyroResidual, batch.count);
+    return coeffs.isValid;
+}
+
+void SensorCorrection::learnTemperatureBias(float temperature, const Vector3D &gyroResidual)
+{
+    if (!Config::TemperatureCompensation::ENABLED)
+        return;
+
+    portENTER_CRITICAL(&calibMux);
+    if (calibData.isValid)
+    {
+        // The samples were corrected with the current model; learn the total drift
+        temperatureModel.learn(temperature, gyroResidual + temperatureModel.evaluate(temperature));
+    }
+    portEXIT_CRITICAL(&calibMux);
+}
+
+size_t SensorCorrection::temperatureBins()
+{
+    portENTER_CRITICAL(&calibMux);
+    size_t count = temperatureModel.learnedBins();
+    portEXIT_CRITICAL(&calibMux);
+    return count;
+}
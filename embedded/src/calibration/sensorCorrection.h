@@ -0,0 +1,128 @@
+#pragma once
+#include <Arduino.h>
+#include <cstddef>
+#include <cstdint>
+#include <atomic>
+#include "calibration/temperatureBiasModel.h"
+#include "config/config.h"
+#include "sensor/imuBatch.h"
+#include "utils/matrix3.h"
+#include "utils/vector3d.h"
+
+/**
+ * @brief Contains corrected sensor data after calibration
+ */
+struct CorrectedData
+{
+    Vector3D accel;
+    Vector3D gyro;
+    bool isValid;
+};
+
+enum class CalibrationMethod : uint8_t
+{
+    NONE = 0,
+    QUICK = 1,
+    SIX_POSITION = 2
+};
+
+/**
+ * @brief Stores calibration parameters for sensor correction
+ *
+ * Accelerometer: corrected = accelMatrix * raw + accelOffset. The quick
+ * calibration fills a uniform scale, the six-position calibration the full
+ * scale and cross-axis matrix.
+ */
+struct CalibrationData
+{
+    Matrix3 accelMatrix;
+    Vector3D accelOffset;
+    Vector3D gyroBias;
+    float temperature; // °C, mean IMU temperature while calibrating
+    CalibrationMethod method;
+    bool isValid;
+};
+
+/**
+ * @brief Calibration folded into one multiply-add per axis
+ *
+ * accel = accelMatrix * raw + accelOffset and gyro = gyroScale * raw +
+ * gyroOffset, with the sensor resolution, the temperature drift and the
+ * sign of the bias already applied. Without a valid calibration the
+ * coefficients only convert units and the deadband is zero.
+ */
+struct CorrectionCoefficients
+{
+    float accelMatrix[3][3];
+    float accelOffset[3];
+    float gyroScale;
+    float gyroOffset[3];
+    float gyroDeadband; // °/s, readings below it are zeroed
+    bool isValid;
+};
+
+/**
+ * @brief Active calibration and the correction applied with it
+ *
+ * Owns the coefficients the sensor task corrects with and the
+ * TemperatureBiasModel learned on top of them. Free of BLE, display and
+ * IMU dependencies, so the replay harness corrects exactly like the device;
+ * SetupCalibration produces the coefficients and publishes them here.
+ *
+ * All methods may be called from any task.
+ */
+class SensorCorrection
+{
+public:
+    SensorCorrection() noexcept;
+
+    /**
+     * @brief Activates new coefficients and restarts the temperature model
+     */
+    void publish(const CalibrationData &data);
+
+    void invalidate();
+
+    CalibrationData data();
+
+    [[nodiscard]] uint32_t generation() const noexcept { return generationCount.load(); }
+
+    CorrectedData correctSensorData(const Vector3D &rawAccel, const Vector3D &rawGyro, float temperature);
+
+    /**
+     * @brief Converts and corrects a FIFO drain in one pass
+     *
+     * Takes the coefficients once for the whole batch, with the drift
+     * evaluated at its mean temperature.
+     * @return Whether a valid calibration was applied; raw values are only converted otherwise
+     */
+    bool correctBatch(const RawImuBatch &raw, ImuBatch &out);
+
+    /**
+     * @brief Corrects already converted samples in place
+     */
+    bool correctBatch(ImuBatch &batch, float temperature);
+
+    /**
+     * @brief Snapshot of the active calibration for the given resolutions
+     * @param accelRes g per input unit
+     * @param gyroRes °/s per input unit
+     */
+    CorrectionCoefficients coefficients(float temperature, float accelRes, float gyroRes);
+
+    /**
+     * @brief Learns the temperature drift from a corrected sample taken while still
+     *
+     * Called by the comms task for samples the ZUPT detector marks as still.
+     * @param gyroResidual Corrected gyro before the deadband, which would hide any drift below it
+     */
+    void learnTemperatureBias(float temperature, const Vector3D &gyroResidual);
+
+    [[nodiscard]] size_t temperatureBins();
+
+private:
+    CalibrationData calibData;             // Active coefficients, read by the sensor task
+    TemperatureBiasModel temperatureModel; // Drift since calibData, guarded by calibMux
+    portMUX_TYPE calibMux;
+    std::atomic<uint32_t> generationCount; // Incremented whenever calibData changes
+};
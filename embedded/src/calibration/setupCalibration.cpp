@@ -1,24 +1,39 @@
 #include "config/config.h"
 #include "SetupCalibration.h"
+#include "calibrationStore.h"
+#include <algorithm>
 #include <cmath>
 
 constexpr char SetupCalibration::MODULE_NAME[];
 
-SetupCalibration::SetupCalibration(BLECharacteristic *calibChar, DisplayController &disp) noexcept
+SetupCalibration::SetupCalibration(BLECharacteristic *calibChar, DisplayController &disp,
+                                   CalibrationStore &store, SensorCorrection &correction) noexcept
     : deviceDisplay(disp),
       pCalibCharacteristic(calibChar),
+      calibrationStore(store),
+      correction(correction),
+      calibrationStored(false),
       calibrationInProgress(false),
       currentState(CalibrationState::IDLE),
       currentProgress(0),
       stateStartTime(0),
-      sampleCount(0)
+      stableSince(0),
+#ifdef CALIBRATION_DEBUG_DUMP
+      dumpCount(0),
+#endif
+      facesDone(0),
+      currentFace(-1),
+      temperatureSum(0.0f),
+      temperatureCount(0)
 {
-    calibData.isValid = false;
-    calibData.accelScale = 1.0f;
+    pendingCalib.accelMatrix = Matrix3::identity();
+    pendingCalib.temperature = 0.0f;
+    pendingCalib.method = CalibrationMethod::NONE;
+    pendingCalib.isValid = false;
     Logger::info(MODULE_NAME, "SetupCalibration initialized");
 }
 
-void SetupCalibration::processCalibration()
+void SetupCalibration::processCalibration(const ImuSample &sample)
 {
     if (!calibrationInProgress)
     {
@@ -29,18 +44,25 @@ void SetupCalibration::processCalibration()
     switch (currentState)
     {
     case CalibrationState::QUICK_STATIC_FLAT:
-        handleQuickStaticFlat();
+        handleQuickStaticFlat(sample);
         break;
     case CalibrationState::QUICK_WAITING_ROTATION:
-        handleQuickWaitingRotation();
+        handleQuickWaitingRotation(sample);
         break;
     case CalibrationState::QUICK_STABILIZING:
-        handleQuickStabilizing();
+        handleQuickStabilizing(sample);
         break;
     case CalibrationState::QUICK_STATIC_SIDE:
-        handleQuickStaticSide();
+        handleQuickStaticSide(sample);
+        break;
+    case CalibrationState::SIX_WAITING_POSITION:
+        handleSixWaitingPosition(sample);
+        break;
+    case CalibrationState::SIX_STATIC:
+        handleSixStatic(sample);
         break;
     case CalibrationState::QUICK_COMPLETE:
+    case CalibrationState::SIX_COMPLETE:
         calibrationInProgress = false;
         Logger::info(MODULE_NAME, "Calibration completed successfully");
         break;
@@ -60,7 +82,7 @@ void SetupCalibration::transitionTo(CalibrationState newState)
                  static_cast<int>(currentState), static_cast<int>(newState));
     currentState = newState;
     stateStartTime = millis();
-    sampleCount = 0;
+    resetStatistics();
     sendStatusToApp();
     deviceDisplay.showCalibrationProgress(0);
 }
@@ -68,7 +90,20 @@ void SetupCalibration::transitionTo(CalibrationState newState)
 Error SetupCalibration::startQuickCalibration()
 {
     Logger::info(MODULE_NAME, "Starting quick calibration");
+    return beginCalibration(CalibrationState::QUICK_STATIC_FLAT);
+}
 
+Error SetupCalibration::startSixPositionCalibration()
+{
+    Logger::info(MODULE_NAME, "Starting six-position calibration");
+    facesDone = 0;
+    currentFace = -1;
+    sixGyroStats.reset();
+    return beginCalibration(CalibrationState::SIX_WAITING_POSITION);
+}
+
+Error SetupCalibration::beginCalibration(CalibrationState firstState)
+{
     if (calibrationInProgress)
     {
         Logger::warn(MODULE_NAME, "Calibration already in progress");
@@ -77,7 +112,8 @@ Error SetupCalibration::startQuickCalibration()
 
     try
     {
-        Logger::debug(MODULE_NAME, "Allocating memory for samples");
+#ifdef CALIBRATION_DEBUG_DUMP
+        Logger::debug(MODULE_NAME, "Allocating memory for the sample dump");
         accelSamples.reset(new Vector3D[Config::Calibration::QUICK_SAMPLES]);
         gyroSamples.reset(new Vector3D[Config::Calibration::QUICK_SAMPLES]);
 
@@ -86,10 +122,16 @@ Error SetupCalibration::startQuickCalibration()
             Logger::error(MODULE_NAME, "Memory allocation failed");
             return Error(Error::Code::MEMORY_ERROR, "Failed to allocate sample buffers");
         }
+#endif
 
         calibrationInProgress = true;
-        calibData.isValid = false;
-        transitionTo(CalibrationState::QUICK_STATIC_FLAT);
+        invalidateCalibration();
+        pendingCalib = CalibrationData();
+        pendingCalib.accelMatrix = Matrix3::identity();
+        currentProgress = 0;
+        temperatureSum = 0.0f;
+        temperatureCount = 0;
+        transitionTo(firstState);
         return Error(Error::Code::NONE, "Success");
     }
     catch (...)
@@ -99,48 +141,92 @@ Error SetupCalibration::startQuickCalibration()
     }
 }
 
-void SetupCalibration::handleQuickStaticFlat()
+void SetupCalibration::resetStatistics()
 {
-    if (sampleCount < Config::Calibration::QUICK_SAMPLES)
+    accelStats.reset();
+    gyroStats.reset();
+    windowAccel.reset();
+    windowGyro.reset();
+    stableSince = 0;
+#ifdef CALIBRATION_DEBUG_DUMP
+    dumpCount = 0;
+#endif
+}
+
+bool SetupCalibration::collectWindow(const ImuSample &sample, bool &still)
+{
+    windowAccel.add(sample.accel);
+    windowGyro.add(sample.gyro);
+    if (windowAccel.count() < Config::Calibration::STILLNESS_WINDOW)
+        return false;
+
+    // Variance ignores the constant gyro bias that a magnitude threshold trips over
+    still = windowAccel.totalVariance() <= Config::Calibration::ACCEL_STILL_VARIANCE &&
+            windowGyro.totalVariance() <= Config::Calibration::GYRO_STILL_VARIANCE;
+    if (!still)
     {
-        Vector3D accel, gyro;
-        M5.Imu.getAccelData(&accel.x, &accel.y, &accel.z);
-        M5.Imu.getGyroData(&gyro.x, &gyro.y, &gyro.z);
+        Logger::logf(Logger::Level::DEBUG, MODULE_NAME,
+                     "Movement detected (accel var %.5f, gyro var %.3f), window dropped",
+                     windowAccel.totalVariance(), windowGyro.totalVariance());
+    }
+    return true;
+}
+
+bool SetupCalibration::collectStaticPosition(const ImuSample &sample, uint8_t progressBase,
+                                             uint8_t progressSpan)
+{
+#ifdef CALIBRATION_DEBUG_DUMP
+    accelSamples[dumpCount % Config::Calibration::QUICK_SAMPLES] = sample.accel;
+    gyroSamples[dumpCount % Config::Calibration::QUICK_SAMPLES] = sample.gyro;
+    dumpCount++;
+#endif
 
-        float gyroMag = gyro.magnitude();
-        if (gyroMag > Config::Calibration::MOVEMENT_TOLERANCE)
+    temperatureSum += sample.temperature;
+    temperatureCount++;
+
+    bool still = false;
+    if (!collectWindow(sample, still))
+        return false;
+
+    if (still)
+    {
+        // A still window away from the mean so far: the device was put down differently
+        float shift = (windowAccel.mean() - accelStats.mean()).magnitude();
+        if (accelStats.count() > 0 && shift > Config::Calibration::REPOSITION_TOLERANCE)
         {
             Logger::logf(Logger::Level::DEBUG, MODULE_NAME,
-                         "Movement detected (%.3f > %.3f), restarting",
-                         gyroMag, Config::Calibration::MOVEMENT_TOLERANCE);
-            sampleCount = 0;
-            return;
+                         "Position changed by %.3f g, restarting", shift);
+            accelStats.reset();
+            gyroStats.reset();
         }
 
-        accelSamples[sampleCount] = accel;
-        gyroSamples[sampleCount] = gyro;
-        sampleCount++;
+        accelStats.merge(windowAccel);
+        gyroStats.merge(windowGyro);
 
-        if (sampleCount % 10 == 0)
-        {
-            uint8_t progress = static_cast<uint8_t>((sampleCount * 50) / Config::Calibration::QUICK_SAMPLES);
-            currentProgress = progress;
-            updateProgress(progress);
-        }
+        uint32_t collected = std::min(accelStats.count(), Config::Calibration::QUICK_SAMPLES);
+        currentProgress = static_cast<uint8_t>(progressBase + (collected * progressSpan) / Config::Calibration::QUICK_SAMPLES);
+        updateProgress(currentProgress);
     }
-    else
+
+    windowAccel.reset();
+    windowGyro.reset();
+    return accelStats.count() >= Config::Calibration::QUICK_SAMPLES;
+}
+
+void SetupCalibration::handleQuickStaticFlat(const ImuSample &sample)
+{
+    if (collectStaticPosition(sample, 0, 50))
     {
         calculateFlatPosition();
         transitionTo(CalibrationState::QUICK_WAITING_ROTATION);
     }
 }
 
-void SetupCalibration::handleQuickWaitingRotation()
+void SetupCalibration::handleQuickWaitingRotation(const ImuSample &sample)
 {
     deviceDisplay.showCalibrationInstruction("Rotate device 90°");
 
-    Vector3D accel;
-    M5.Imu.getAccelData(&accel.x, &accel.y, &accel.z);
+    const Vector3D &accel = sample.accel;
 
     float zComponent = accel.z / accel.magnitude();
     float angleFromVertical = acos(zComponent) * 180.0f / M_PI;
@@ -152,126 +238,239 @@ void SetupCalibration::handleQuickWaitingRotation()
     }
 }
 
-void SetupCalibration::handleQuickStabilizing()
+void SetupCalibration::handleQuickStabilizing(const ImuSample &sample)
 {
-    static uint32_t stableStartTime = 0;
-    Vector3D gyro;
-    M5.Imu.getGyroData(&gyro.x, &gyro.y, &gyro.z);
+    bool still = false;
+    if (!collectWindow(sample, still))
+        return;
+
+    windowAccel.reset();
+    windowGyro.reset();
 
-    if (gyro.magnitude() < Config::Calibration::STILLNESS_THRESHOLD)
+    if (!still)
     {
-        if (stableStartTime == 0)
-        {
-            stableStartTime = millis();
-        }
-        else if (millis() - stableStartTime > Config::Calibration::STABLE_DURATION)
-        {
-            stableStartTime = 0;
-            transitionTo(CalibrationState::QUICK_STATIC_SIDE);
-        }
+        stableSince = 0;
+        return;
     }
-    else
+
+    if (stableSince == 0)
     {
-        Logger::logf(Logger::Level::DEBUG, MODULE_NAME, "Movement detected: %.3f", gyro.magnitude());
-        stableStartTime = 0;
+        stableSince = millis();
+    }
+    else if (millis() - stableSince > Config::Calibration::STABLE_DURATION)
+    {
+        transitionTo(CalibrationState::QUICK_STATIC_SIDE);
     }
 }
 
-void SetupCalibration::handleQuickStaticSide()
+void SetupCalibration::handleQuickStaticSide(const ImuSample &sample)
 {
-    if (sampleCount < Config::Calibration::QUICK_SAMPLES)
+    if (collectStaticPosition(sample, 50, 50))
     {
-        Vector3D accel, gyro;
-        M5.Imu.getAccelData(&accel.x, &accel.y, &accel.z);
-        M5.Imu.getGyroData(&gyro.x, &gyro.y, &gyro.z);
+        calculateSidePosition();
+    }
+}
 
-        float gyroMag = gyro.magnitude();
-        if (gyroMag > Config::Calibration::MOVEMENT_TOLERANCE)
-        {
-            Logger::logf(Logger::Level::DEBUG, MODULE_NAME,
-                         "Movement detected (%.3f > %.3f), restarting",
-                         gyroMag, Config::Calibration::MOVEMENT_TOLERANCE);
-            sampleCount = 0;
-            return;
-        }
+uint8_t SetupCalibration::facesCollected() const
+{
+    uint8_t count = 0;
+    for (size_t face = 0; face < SixPositionFit::POSITIONS; face++)
+    {
+        if (facesDone & (1u << face))
+            count++;
+    }
+    return count;
+}
 
-        accelSamples[sampleCount] = accel;
-        gyroSamples[sampleCount] = gyro;
-        sampleCount++;
+void SetupCalibration::handleSixWaitingPosition(const ImuSample &sample)
+{
+    bool still = false;
+    if (!collectWindow(sample, still))
+        return;
 
-        if (sampleCount % 10 == 0)
-        {
-            uint8_t progress = static_cast<uint8_t>(50 + (sampleCount * 50) / Config::Calibration::QUICK_SAMPLES);
-            currentProgress = progress;
-            updateProgress(progress);
-        }
+    int face = SixPositionFit::faceIndex(windowAccel.mean());
+    windowAccel.reset();
+    windowGyro.reset();
+
+    // Wait until the device rests on a face that has not been measured yet
+    if (!still || face < 0 || (facesDone & (1u << face)))
+    {
+        stableSince = 0;
+        return;
     }
-    else
+
+    if (face != currentFace)
     {
-        calculateSidePosition();
-        transitionTo(CalibrationState::QUICK_COMPLETE);
+        currentFace = face;
+        stableSince = millis();
+        return;
+    }
+
+    if (millis() - stableSince > Config::Calibration::STABLE_DURATION)
+    {
+        Logger::logf(Logger::Level::INFO, MODULE_NAME, "Face %d detected, averaging", face);
+        transitionTo(CalibrationState::SIX_STATIC);
     }
 }
 
-Vector3D SetupCalibration::calculateMean(const Vector3D samples[], uint32_t count)
+void SetupCalibration::handleSixStatic(const ImuSample &sample)
 {
-    Vector3D sum;
-    for (uint32_t i = 0; i < count; i++)
+    uint8_t done = facesCollected();
+    uint8_t base = static_cast<uint8_t>(done * 100 / SixPositionFit::POSITIONS);
+    uint8_t span = static_cast<uint8_t>((done + 1) * 100 / SixPositionFit::POSITIONS - base);
+    if (!collectStaticPosition(sample, base, span))
+        return;
+
+    // The device may have been tipped onto another face while averaging
+    int face = SixPositionFit::faceIndex(accelStats.mean());
+    if (face != currentFace)
+    {
+        Logger::info(MODULE_NAME, "Face changed while averaging, waiting for a new position");
+        currentFace = -1;
+        transitionTo(CalibrationState::SIX_WAITING_POSITION);
+        return;
+    }
+
+    faceMeans[face] = accelStats.mean();
+    facesDone |= 1u << face;
+    sixGyroStats.merge(gyroStats);
+    Logger::logf(Logger::Level::INFO, MODULE_NAME,
+                 "Face %d mean: X=%.4f, Y=%.4f, Z=%.4f (%u/6)",
+                 face, faceMeans[face].x, faceMeans[face].y, faceMeans[face].z,
+                 static_cast<unsigned>(facesCollected()));
+#ifdef CALIBRATION_DEBUG_DUMP
+    dumpSamples("Face");
+#endif
+
+    if (facesCollected() < SixPositionFit::POSITIONS)
     {
-        sum = sum + samples[i];
+        currentFace = -1;
+        transitionTo(CalibrationState::SIX_WAITING_POSITION);
+        return;
     }
-    return sum / static_cast<float>(count);
+
+    calculateSixPosition();
 }
 
-void SetupCalibration::calculateFlatPosition()
+void SetupCalibration::calculateSixPosition()
+{
+    SixPositionResult fit;
+    Error error = SixPositionFit::solve(faceMeans, fit);
+
+    Logger::logf(Logger::Level::INFO, MODULE_NAME,
+                 "Six-position fit: residual %.4f g", fit.rmsResidual);
+    for (int r = 0; r < 3; r++)
+    {
+        Logger::logf(Logger::Level::INFO, MODULE_NAME, "  [%.4f %.4f %.4f] + %.4f",
+                     fit.matrix.m[r][0], fit.matrix.m[r][1], fit.matrix.m[r][2],
+                     r == 0 ? fit.offset.x : r == 1 ? fit.offset.y : fit.offset.z);
+    }
+
+    if (error.isError())
+    {
+        Logger::error(MODULE_NAME, error.message());
+        transitionTo(CalibrationState::FAILED);
+        return;
+    }
+
+    pendingCalib.accelMatrix = fit.matrix;
+    pendingCalib.accelOffset = fit.offset;
+    pendingCalib.gyroBias = sixGyroStats.mean();
+    completeCalibration(CalibrationMethod::SIX_POSITION, CalibrationState::SIX_COMPLETE);
+}
+
+void SetupCalibration::completeCalibration(CalibrationMethod method, CalibrationState doneState)
+{
+    pendingCalib.method = method;
+    pendingCalib.temperature = temperatureCount > 0 ? temperatureSum / temperatureCount : 0.0f;
+    pendingCalib.isValid = true;
+    publishCalibration(pendingCalib);
+
+    // A failed write only costs a recalibration after the next power cycle
+    Error error = calibrationStore.save(pendingCalib);
+    calibrationStored = !error.isError();
+    if (error.isError())
+    {
+        Logger::error(MODULE_NAME, error.message());
+    }
+
+    deviceDisplay.updateDisplayStatus(deviceConnected, false);
+    transitionTo(doneState);
+}
+
+#ifdef CALIBRATION_DEBUG_DUMP
+void SetupCalibration::dumpSamples(const char *position)
 {
-    flatAccelMean = calculateMean(accelSamples.get(), Config::Calibration::QUICK_SAMPLES);
-    Vector3D gyroMean = calculateMean(gyroSamples.get(), Config::Calibration::QUICK_SAMPLES);
+    uint32_t count = std::min(dumpCount, Config::Calibration::QUICK_SAMPLES);
+    uint32_t first = dumpCount - count;
+    Logger::logf(Logger::Level::DEBUG, MODULE_NAME, "%s samples (%lu): ax,ay,az,gx,gy,gz",
+                 position, static_cast<unsigned long>(count));
+    for (uint32_t i = first; i < dumpCount; i++)
+    {
+        const Vector3D &a = accelSamples[i % Config::Calibration::QUICK_SAMPLES];
+        const Vector3D &g = gyroSamples[i % Config::Calibration::QUICK_SAMPLES];
+        Logger::logf(Logger::Level::DEBUG, MODULE_NAME, "%.4f,%.4f,%.4f,%.3f,%.3f,%.3f",
+                     a.x, a.y, a.z, g.x, g.y, g.z);
+        // One position is more lines than the log ring holds
+        Logger::flush();
+    }
+}
+#endif
 
-    calibData.gyroBias = gyroMean;
+void SetupCalibration::calculateFlatPosition()
+{
+#ifdef CALIBRATION_DEBUG_DUMP
+    dumpSamples("Flat");
+#endif
+    flatAccelMean = accelStats.mean();
+    pendingCalib.gyroBias = gyroStats.mean();
 
+    Vector3D accelVar = accelStats.variance();
     Logger::logf(Logger::Level::INFO, MODULE_NAME,
-                 "Flat position mean: X=%.3f, Y=%.3f, Z=%.3f",
-                 flatAccelMean.x, flatAccelMean.y, flatAccelMean.z);
+                 "Flat position mean: X=%.3f, Y=%.3f, Z=%.3f (std %.4f, %.4f, %.4f)",
+                 flatAccelMean.x, flatAccelMean.y, flatAccelMean.z,
+                 std::sqrt(accelVar.x), std::sqrt(accelVar.y), std::sqrt(accelVar.z));
     Logger::logf(Logger::Level::INFO, MODULE_NAME,
                  "Gyro bias: X=%.3f, Y=%.3f, Z=%.3f",
-                 calibData.gyroBias.x, calibData.gyroBias.y, calibData.gyroBias.z);
+                 pendingCalib.gyroBias.x, pendingCalib.gyroBias.y, pendingCalib.gyroBias.z);
 }
 
 void SetupCalibration::calculateSidePosition()
 {
-    sideAccelMean = calculateMean(accelSamples.get(), Config::Calibration::QUICK_SAMPLES);
+#ifdef CALIBRATION_DEBUG_DUMP
+    dumpSamples("Side");
+#endif
+    sideAccelMean = accelStats.mean();
 
     float xMagnitude = std::abs(sideAccelMean.x);
     float zMagnitude = std::abs(flatAccelMean.z);
     float averageMagnitude = (zMagnitude + xMagnitude) / 2.0f;
-    calibData.accelScale = Config::Calibration::GRAVITY_MAGNITUDE / averageMagnitude;
+    float scale = Config::Calibration::GRAVITY_MAGNITUDE / averageMagnitude;
 
     Logger::logf(Logger::Level::DEBUG, MODULE_NAME,
                  "xMag: %.3f, zMag: %.3f, avgMag: %.3f",
                  xMagnitude, zMagnitude, averageMagnitude);
 
-    if (calibData.accelScale < Config::Calibration::MIN_SCALE_FACTOR || calibData.accelScale > Config::Calibration::MAX_SCALE_FACTOR)
+    if (scale < Config::Calibration::MIN_SCALE_FACTOR || scale > Config::Calibration::MAX_SCALE_FACTOR)
     {
         Logger::logf(Logger::Level::ERROR, MODULE_NAME,
-                     "Invalid scale factor: %.3f", calibData.accelScale);
+                     "Invalid scale factor: %.3f", scale);
         transitionTo(CalibrationState::FAILED);
         return;
     }
 
-    calibData.accelBias = Vector3D(
-        flatAccelMean.x * calibData.accelScale,
-        (flatAccelMean.y + sideAccelMean.y) * calibData.accelScale / 2.0f,
-        sideAccelMean.z * calibData.accelScale);
+    Vector3D bias(
+        flatAccelMean.x * scale,
+        (flatAccelMean.y + sideAccelMean.y) * scale / 2.0f,
+        sideAccelMean.z * scale);
+    pendingCalib.accelMatrix = Matrix3::diagonal(scale, scale, scale);
+    pendingCalib.accelOffset = Vector3D() - bias;
 
-    Logger::logf(Logger::Level::INFO, MODULE_NAME, "Scale: %.3f", calibData.accelScale);
+    Logger::logf(Logger::Level::INFO, MODULE_NAME, "Scale: %.3f", scale);
     Logger::logf(Logger::Level::INFO, MODULE_NAME,
-                 "Bias: X=%.3f, Y=%.3f, Z=%.3f",
-                 calibData.accelBias.x, calibData.accelBias.y, calibData.accelBias.z);
+                 "Bias: X=%.3f, Y=%.3f, Z=%.3f", bias.x, bias.y, bias.z);
 
-    calibData.isValid = true;
-    deviceDisplay.updateDisplayStatus(deviceConnected, false);
-    transitionTo(CalibrationState::QUICK_COMPLETE);
+    completeCalibration(CalibrationMethod::QUICK, CalibrationState::QUICK_COMPLETE);
 }
 
 void SetupCalibration::updateProgress(uint8_t progress)
@@ -321,36 +520,68 @@ void SetupCalibration::abortCalibration() noexcept
         return;
 
     Logger::info(MODULE_NAME, "Aborting calibration");
+#ifdef CALIBRATION_DEBUG_DUMP
     accelSamples.reset();
     gyroSamples.reset();
+#endif
     calibrationInProgress = false;
-    calibData.isValid = false;
+    invalidateCalibration();
     transitionTo(CalibrationState::FAILED);
 }
 
-CorrectedData SetupCalibration::correctSensorData(const Vector3D &rawAccel, const Vector3D &rawGyro)
+void SetupCalibration::publishCalibration(const CalibrationData &data)
 {
-    CorrectedData result;
+    correction.publish(data);
+}
+
+void SetupCalibration::restoreCalibration(const CalibrationData &data)
+{
+    publishCalibration(data);
+    calibrationStored = data.isValid;
+}
 
-    if (!calibData.isValid)
+Error SetupCalibration::forgetCalibration()
+{
+    if (calibrationInProgress)
     {
-        result.accel = rawAccel;
-        result.gyro = rawGyro;
-        result.isValid = false;
-        return result;
+        return Error(Error::Code::INVALID_STATE, "Calibration in progress");
     }
 
-    result.accel = Vector3D(
-        rawAccel.x * calibData.accelScale - calibData.accelBias.x,
-        rawAccel.y * calibData.accelScale - calibData.accelBias.y,
-        rawAccel.z * calibData.accelScale - calibData.accelBias.z);
+    invalidateCalibration();
+    calibrationStored = false;
+    currentState = CalibrationState::IDLE;
+    currentProgress = 0;
+    sendStatusToApp();
+    return calibrationStore.clear();
+}
 
-    Vector3D correctedGyro = rawGyro - calibData.gyroBias;
-    result.gyro = Vector3D(
-        std::abs(correctedGyro.x) < Config::Calibration::GYRO_DEADBAND ? 0.0f : correctedGyro.x,
-        std::abs(correctedGyro.y) < Config::Calibration::GYRO_DEADBAND ? 0.0f : correctedGyro.y,
-        std::abs(correctedGyro.z) < Config::Calibration::GYRO_DEADBAND ? 0.0f : correctedGyro.z);
+void SetupCalibration::publishInfo()
+{
+    if (!pCalibCharacteristic)
+        return;
 
-    result.isValid = true;
-    return result;
-}
\ No newline at end of file
+    CalibrationData data = correction.data();
+    CalibrationInfo info;
+    info.valid = data.isValid ? 1 : 0;
+    info.stored = data.isValid && calibrationStored ? 1 : 0;
+    info.method = data.isValid ? data.method : CalibrationMethod::NONE;
+    info.temperature = data.temperature;
+    for (int r = 0; r < 3; r++)
+    {
+        for (int c = 0; c < 3; c++)
+            info.accelMatrix[r * 3 + c] = data.accelMatrix.m[r][c];
+    }
+    info.accelOffset[0] = data.accelOffset.x;
+    info.accelOffset[1] = data.accelOffset.y;
+    info.accelOffset[2] = data.accelOffset.z;
+    info.gyroBias[0] = data.gyroBias.x;
+    info.gyroBias[1] = data.gyroBias.y;
+    info.gyroBias[2] = data.gyroBias.z;
+
+    pCalibCharacteristic->setValue(reinterpret_cast<uint8_t *>(&info), sizeof(info));
+}
+
+void SetupCalibration::invalidateCalibration()
+{
+    correction.invalidate();
+}
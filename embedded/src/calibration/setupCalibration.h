@@ -3,50 +3,19 @@
 #include <BLECharacteristic.h>
 #include "display/displayController.h"
 #include "utils/logger.h"
+#include "calibration/sensorCorrection.h"
+#include "calibration/sixPositionFit.h"
 #include "utils/error.h"
+#include "utils/matrix3.h"
+#include "utils/runningStats.h"
+#include "utils/vector3d.h"
+#include "sensor/imuSample.h"
 #include <memory>
+#include <atomic>
 
 extern bool deviceConnected;
 
-/**
- * @brief 3D vector structure for sensor data processing
- */
-struct Vector3D
-{
-    float x, y, z;
-
-    Vector3D(float _x = 0, float _y = 0, float _z = 0) : x(_x), y(_y), z(_z) {}
-
-    Vector3D operator+(const Vector3D &other) const
-    {
-        return Vector3D(x + other.x, y + other.y, z + other.z);
-    }
-
-    Vector3D operator/(float scalar) const
-    {
-        return Vector3D(x / scalar, y / scalar, z / scalar);
-    }
-
-    Vector3D operator-(const Vector3D &other) const
-    {
-        return Vector3D(x - other.x, y - other.y, z - other.z);
-    }
-
-    float magnitude() const
-    {
-        return sqrt(x * x + y * y + z * z);
-    }
-};
-
-/**
- * @brief Contains corrected sensor data after calibration
- */
-struct CorrectedData
-{
-    Vector3D accel;
-    Vector3D gyro;
-    bool isValid;
-};
+class CalibrationStore;
 
 enum class CalibrationState : uint8_t
 {
@@ -56,7 +25,10 @@ enum class CalibrationState : uint8_t
     QUICK_STABILIZING = 3,      // Waiting for stability after rotation
     QUICK_STATIC_SIDE = 4,      // Device on side (display towards user)
     QUICK_COMPLETE = 5,         // Calibration successful
-    FAILED = 6                  // Calibration failed
+    FAILED = 6,                 // Calibration failed
+    SIX_WAITING_POSITION = 7,   // Waiting for the device to rest on a face not yet measured
+    SIX_STATIC = 8,             // Averaging the current face
+    SIX_COMPLETE = 9            // Six-position calibration successful
 };
 
 struct __attribute__((packed)) CalibrationProgress
@@ -66,57 +38,120 @@ struct __attribute__((packed)) CalibrationProgress
 };
 
 /**
- * @brief Stores calibration parameters for sensor correction
+ * @brief Active coefficients, set as the characteristic value on request
+ *
+ * Told apart from CalibrationProgress by its length.
  */
-struct CalibrationData
+struct __attribute__((packed)) CalibrationInfo
 {
-    Vector3D accelBias;
-    Vector3D gyroBias;
-    float accelScale;
-    bool isValid;
+    uint8_t valid;
+    uint8_t stored;    // Persisted in NVS, survives a power cycle
+    CalibrationMethod method;
+    float temperature; // °C during calibration
+    float accelMatrix[9];
+    float accelOffset[3];
+    float gyroBias[3];
 };
 
 /**
- * @brief Manages IMU calibration and data correction
+ * @brief Manages IMU calibration
  *
  * Handles the calibration process for both accelerometer and gyroscope,
- * stores calibration data, and provides corrected sensor readings.
+ * stores calibration data and publishes it to the SensorCorrection the
+ * sensor task corrects with.
+ *
+ * Two modes: the quick calibration (flat, then on its side) estimates a
+ * single accelerometer scale; the six-position calibration rests the device
+ * on each face in any order and fits per-axis scale, misalignment and bias
+ * by least squares (SixPositionFit).
+ *
+ * Each static position is averaged with running accumulators, so no sample
+ * buffers are needed. Samples are checked in windows of
+ * Config::Calibration::STILLNESS_WINDOW: a window whose variance shows
+ * movement is dropped without discarding the still windows before it.
+ * Successful results are persisted through CalibrationStore.
+ * Build with CALIBRATION_DEBUG_DUMP to log the raw samples of each position.
  */
 class SetupCalibration
 {
 public:
     static constexpr char MODULE_NAME[] = "CALIB";
 
-    explicit SetupCalibration(BLECharacteristic *calibChar, DisplayController &disp) noexcept;
+    SetupCalibration(BLECharacteristic *calibChar, DisplayController &disp, CalibrationStore &store,
+                     SensorCorrection &correction) noexcept;
 
     Error startQuickCalibration();
+    Error startSixPositionCalibration();
     void abortCalibration() noexcept;
-    void processCalibration();
-    CorrectedData correctSensorData(const Vector3D &rawAccel, const Vector3D &rawGyro);
+    void processCalibration(const ImuSample &sample);
+    void publishCalibration(const CalibrationData &data);
+
+    /**
+     * @brief Activates coefficients loaded from storage at boot
+     */
+    void restoreCalibration(const CalibrationData &data);
+
+    /**
+     * @brief Invalidates the active coefficients and removes the stored ones
+     */
+    Error forgetCalibration();
+
+    /**
+     * @brief Sets the characteristic value to a CalibrationInfo for the app to read
+     */
+    void publishInfo();
     [[nodiscard]] bool isCalibrationInProgress() const noexcept { return calibrationInProgress; }
 
 private:
     DisplayController &deviceDisplay;
     BLECharacteristic *pCalibCharacteristic;
+    CalibrationStore &calibrationStore;
+    SensorCorrection &correction;
+    bool calibrationStored; // calibData matches NVS
     bool calibrationInProgress;
     CalibrationState currentState;
     uint8_t currentProgress;
     uint32_t stateStartTime;
-    uint32_t sampleCount;
-    std::unique_ptr<Vector3D[]> accelSamples;
+    uint32_t stableSince;         // ms, start of the still windows while stabilizing
+    RunningStats3D accelStats;    // Accepted windows of the current position
+    RunningStats3D gyroStats;
+    RunningStats3D windowAccel;   // Stillness window being collected
+    RunningStats3D windowGyro;
+#ifdef CALIBRATION_DEBUG_DUMP
+    std::unique_ptr<Vector3D[]> accelSamples; // Last QUICK_SAMPLES raw samples for the dump
     std::unique_ptr<Vector3D[]> gyroSamples;
-    CalibrationData calibData;
+    uint32_t dumpCount;
+#endif
+    CalibrationData pendingCalib; // Results of the calibration in progress
     Vector3D flatAccelMean;
     Vector3D sideAccelMean;
-
-    void handleQuickStaticFlat();
-    void handleQuickWaitingRotation();
-    void handleQuickStabilizing();
-    void handleQuickStaticSide();
+    Vector3D faceMeans[SixPositionFit::POSITIONS];
+    uint8_t facesDone;            // Bit per SixPositionFit::faceIndex()
+    int currentFace;
+    RunningStats3D sixGyroStats;  // Gyro over all six faces
+    float temperatureSum;         // Over all static samples of the calibration
+    uint32_t temperatureCount;
+
+    void handleQuickStaticFlat(const ImuSample &sample);
+    void handleQuickWaitingRotation(const ImuSample &sample);
+    void handleQuickStabilizing(const ImuSample &sample);
+    void handleQuickStaticSide(const ImuSample &sample);
+    void handleSixWaitingPosition(const ImuSample &sample);
+    void handleSixStatic(const ImuSample &sample);
+    Error beginCalibration(CalibrationState firstState);
+    bool collectWindow(const ImuSample &sample, bool &still);
+    bool collectStaticPosition(const ImuSample &sample, uint8_t progressBase, uint8_t progressSpan);
+    void resetStatistics();
     void calculateFlatPosition();
     void calculateSidePosition();
-    Vector3D calculateMean(const Vector3D samples[], uint32_t count);
+    void calculateSixPosition();
+    void completeCalibration(CalibrationMethod method, CalibrationState doneState);
+    uint8_t facesCollected() const;
+#ifdef CALIBRATION_DEBUG_DUMP
+    void dumpSamples(const char *position);
+#endif
     void updateProgress(uint8_t progress);
     void transitionTo(CalibrationState newState);
     void sendStatusToApp();
+    void invalidateCalibration();
 };
\ No newline at end of file
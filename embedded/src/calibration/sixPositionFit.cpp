@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <cmath>
+#include "config/config.h"
+#include "sixPositionFit.h"
+
+namespace
+{
+    float component(const Vector3D &v, int axis)
+    {
+        return axis == 0 ? v.x : axis == 1 ? v.y : v.z;
+    }
+}
+
+int SixPositionFit::faceIndex(const Vector3D &mean)
+{
+    float magnitude = mean.magnitude();
+    if (magnitude <= 0.0f)
+        return -1;
+
+    for (int axis = 0; axis < 3; axis++)
+    {
+        float c = component(mean, axis) / magnitude;
+        if (std::fabs(c) >= Config::Calibration::FACE_ALIGNMENT)
+            return axis * 2 + (c < 0.0f ? 1 : 0);
+    }
+    return -1;
+}
+
+Error SixPositionFit::solve(const Vector3D means[POSITIONS], SixPositionResult &result)
+{
+    // Normal equations (X^T X) w = X^T g with rows x = [raw, 1], one right-hand
+    // side per corrected axis, kept as an augmented 4x7 matrix
+    float a[4][7] = {};
+    for (size_t face = 0; face < POSITIONS; face++)
+    {
+        const float x[4] = {means[face].x, means[face].y, means[face].z, 1.0f};
+        float target[3] = {0.0f, 0.0f, 0.0f};
+        target[face / 2] = face % 2 == 0 ? 1.0f : -1.0f;
+
+        for (int r = 0; r < 4; r++)
+        {
+            for (int c = 0; c < 4; c++)
+                a[r][c] += x[r] * x[c];
+            for (int k = 0; k < 3; k++)
+                a[r][4 + k] += x[r] * target[k];
+        }
+    }
+
+    for (int col = 0; col < 4; col++)
+    {
+        int pivot = col;
+        for (int r = col + 1; r < 4; r++)
+        {
+            if (std::fabs(a[r][col]) > std::fabs(a[pivot][col]))
+                pivot = r;
+        }
+        if (std::fabs(a[pivot][col]) < 1e-6f)
+        {
+            return Error(Error::Code::CALIBRATION_FAILED, "Six-position system is singular");
+        }
+        if (pivot != col)
+        {
+            for (int c = 0; c < 7; c++)
+                std::swap(a[col][c], a[pivot][c]);
+        }
+
+        for (int r = 0; r < 4; r++)
+        {
+            if (r == col)
+                continue;
+            float factor = a[r][col] / a[col][col];
+            for (int c = col; c < 7; c++)
+                a[r][c] -= factor * a[col][c];
+        }
+    }
+
+    // Column k of the solution is row k of the correction
+    for (int k = 0; k < 3; k++)
+    {
+        for (int c = 0; c < 3; c++)
+            result.matrix.m[k][c] = a[c][4 + k] / a[c][c];
+    }
+    result.offset = Vector3D(a[3][4] / a[3][3], a[3][5] / a[3][3], a[3][6] / a[3][3]);
+
+    float squared = 0.0f;
+    for (size_t face = 0; face < POSITIONS; face++)
+    {
+        Vector3D corrected = result.matrix.transform(means[face], result.offset);
+        float target[3] = {0.0f, 0.0f, 0.0f};
+        target[face / 2] = face % 2 == 0 ? 1.0f : -1.0f;
+        Vector3D error = corrected - Vector3D(target[0], target[1], target[2]);
+        squared += error.x * error.x + error.y * error.y + error.z * error.z;
+    }
+    result.rmsResidual = std::sqrt(squared / (POSITIONS * 3));
+
+    for (int r = 0; r < 3; r++)
+    {
+        float scale = result.matrix.m[r][r];
+        if (scale < Config::Calibration::MIN_SCALE_FACTOR || scale > Config::Calibration::MAX_SCALE_FACTOR)
+        {
+            return Error(Error::Code::CALIBRATION_FAILED, "Scale factor out of range");
+        }
+        for (int c = 0; c < 3; c++)
+        {
+            if (c != r && std::fabs(result.matrix.m[r][c]) > Config::Calibration::MAX_CROSS_AXIS)
+            {
+                return Error(Error::Code::CALIBRATION_FAILED, "Cross-axis term out of range");
+            }
+        }
+    }
+    if (result.rmsResidual > Config::Calibration::MAX_FIT_RESIDUAL)
+    {
+        return Error(Error::Code::CALIBRATION_FAILED, "Six-position fit residual too large");
+    }
+
+    return Error(Error::Code::NONE, "Success");
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include "utils/error.h"
+#include "utils/matrix3.h"
+#include "utils/vector3d.h"
+
+/**
+ * @brief Accelerometer model fitted from six static orientations
+ *
+ * corrected = matrix * raw + offset. The diagonal holds the per-axis scale,
+ * the off-diagonal terms axis misalignment and cross-axis sensitivity.
+ */
+struct SixPositionResult
+{
+    Matrix3 matrix;
+    Vector3D offset;
+    float rmsResidual; // g, fit error over the six positions
+};
+
+namespace SixPositionFit
+{
+    constexpr size_t POSITIONS = 6;
+
+    /**
+     * @brief Index of the face a still reading belongs to: 2 * axis, +1 when
+     * the axis points down; -1 if no axis is close enough to vertical
+     */
+    int faceIndex(const Vector3D &mean);
+
+    /**
+     * @brief Solves matrix and offset by linear least squares
+     * @param means Mean raw reading per face, indexed by faceIndex()
+     *
+     * Each face expects +-1 g on one axis and 0 g on the others, giving 18
+     * equations for the 12 unknowns. The three matrix rows share one 4x4
+     * normal-equation system, solved by Gaussian elimination.
+     */
+    Error solve(const Vector3D means[POSITIONS], SixPositionResult &result);
+}
@@ -0,0 +1,98 @@
+#include <cmath>
+#include "temperatureBiasModel.h"
+
+namespace
+{
+    using TC = Config::TemperatureCompensation;
+}
+
+TemperatureBiasModel::TemperatureBiasModel() noexcept
+{
+    reset(TC::MIN_TEMPERATURE - TC::MAX_EXTRAPOLATION * 2);
+}
+
+int TemperatureBiasModel::binIndex(float temperature)
+{
+    int index = static_cast<int>(std::floor((temperature - TC::MIN_TEMPERATURE) / TC::BIN_WIDTH));
+    if (index < 0)
+        return 0;
+    if (index >= static_cast<int>(TC::BIN_COUNT))
+        return TC::BIN_COUNT - 1;
+    return index;
+}
+
+float TemperatureBiasModel::binCenter(int index)
+{
+    return TC::MIN_TEMPERATURE + (index + 0.5f) * TC::BIN_WIDTH;
+}
+
+bool TemperatureBiasModel::isLearned(int index) const
+{
+    return bins[index].weight >= TC::MIN_BIN_SAMPLES;
+}
+
+void TemperatureBiasModel::reset(float calibrationTemperature)
+{
+    for (auto &bin : bins)
+    {
+        bin = Bin{0, Vector3D()};
+    }
+
+    // The calibration itself measured zero residual at its temperature
+    if (calibrationTemperature >= TC::MIN_TEMPERATURE &&
+        calibrationTemperature < TC::MIN_TEMPERATURE + TC::BIN_COUNT * TC::BIN_WIDTH)
+    {
+        bins[binIndex(calibrationTemperature)].weight = TC::MIN_BIN_SAMPLES;
+    }
+}
+
+void TemperatureBiasModel::learn(float temperature, const Vector3D &gyro)
+{
+    Bin &bin = bins[binIndex(temperature)];
+    if (bin.weight < TC::MAX_BIN_WEIGHT)
+        bin.weight++;
+
+    float rate = 1.0f / bin.weight;
+    bin.gyro = bin.gyro + (gyro - bin.gyro) * rate;
+}
+
+Vector3D TemperatureBiasModel::evaluate(float temperature) const
+{
+    // Nearest learned bin centers at or below and above the temperature
+    int below = -1;
+    int above = -1;
+    for (int i = 0; i < static_cast<int>(TC::BIN_COUNT); i++)
+    {
+        if (!isLearned(i))
+            continue;
+        if (binCenter(i) <= temperature)
+            below = i;
+        else if (above < 0)
+            above = i;
+    }
+
+    bool useBelow = below >= 0 && temperature - binCenter(below) <= TC::MAX_EXTRAPOLATION;
+    bool useAbove = above >= 0 && binCenter(above) - temperature <= TC::MAX_EXTRAPOLATION;
+
+    if (useBelow && useAbove)
+    {
+        float t = (temperature - binCenter(below)) / (binCenter(above) - binCenter(below));
+        return bins[below].gyro + (bins[above].gyro - bins[below].gyro) * t;
+    }
+    if (useBelow)
+        return bins[below].gyro;
+    if (useAbove)
+        return bins[above].gyro;
+    return Vector3D();
+}
+
+size_t TemperatureBiasModel::learnedBins() const
+{
+    size_t count = 0;
+    for (int i = 0; i < static_cast<int>(TC::BIN_COUNT); i++)
+    {
+        if (isLearned(i))
+            count++;
+    }
+    return count;
+}
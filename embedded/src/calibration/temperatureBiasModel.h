@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include "config/config.h"
+#include "utils/vector3d.h"
+
+/**
+ * @brief Piecewise-linear model of the gyro bias change versus IMU temperature
+ *
+ * Values are residuals on top of the calibration: zero at the calibration
+ * temperature, learned from still periods elsewhere. Temperatures are
+ * grouped in bins of Config::TemperatureCompensation::BIN_WIDTH; the model
+ * interpolates between the centers of learned bins and holds the nearest
+ * one up to MAX_EXTRAPOLATION beyond them.
+ *
+ * Accel drift is not modelled: a still sample only shows the magnitude
+ * error along gravity, which mixes the drift with the static scale error of
+ * whatever face the device rests on.
+ */
+class TemperatureBiasModel
+{
+public:
+    TemperatureBiasModel() noexcept;
+
+    /**
+     * @brief Forgets all learned bins and anchors zero at the calibration temperature
+     */
+    void reset(float calibrationTemperature);
+
+    /**
+     * @brief Adds one still sample
+     * @param gyro Gyro bias left after calibration, °/s
+     */
+    void learn(float temperature, const Vector3D &gyro);
+
+    [[nodiscard]] Vector3D evaluate(float temperature) const;
+
+    [[nodiscard]] size_t learnedBins() const;
+
+private:
+    struct Bin
+    {
+        uint32_t weight; // Samples, capped so the bin keeps adapting
+        Vector3D gyro;
+    };
+
+    Bin bins[Config::TemperatureCompensation::BIN_COUNT];
+
+    static int binIndex(float temperature);
+    static float binCenter(int index);
+    bool isLearned(int index) const;
+};
@@ -5,4 +5,10 @@ constexpr char Config::BLE::DEVICE_NAME[];
 constexpr char Config::BLE::SERVICE_UUID[];
 constexpr char Config::BLE::CHAR_ACC_UUID[];
 constexpr char Config::BLE::CHAR_GYR_UUID[];
-constexpr char Config::BLE::CHAR_CALIB_UUID[];
\ No newline at end of file
+constexpr char Config::BLE::CHAR_CALIB_UUID[];
+constexpr char Config::BLE::CHAR_STREAM_UUID[];
+constexpr char Config::BLE::CHAR_RECORD_UUID[];
+constexpr char Config::BLE::CHAR_REP_UUID[];
+constexpr char Config::BLE::CHAR_LINK_UUID[];
+constexpr char Config::BLE::CHAR_PERF_UUID[];
+constexpr char Config::BLE::CHAR_TIME_UUID[];
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
-#include <M5StickCPlus2.h>
+#include <cstddef>
+#include <cstdint>
 
 /**
  * @brief Central configuration for the PowerFlux device
@@ -16,15 +17,59 @@ struct Config
         static constexpr char CHAR_ACC_UUID[] = "beb5483e-36e1-4688-b7f5-ea07361b26a8";
         static constexpr char CHAR_GYR_UUID[] = "beb5483e-36e1-4688-b7f5-ea07361b26a9";
         static constexpr char CHAR_CALIB_UUID[] = "beb5483e-36e1-4688-b7f5-ea07361b26aa";
+        static constexpr char CHAR_STREAM_UUID[] = "beb5483e-36e1-4688-b7f5-ea07361b26ab";
+        static constexpr char CHAR_RECORD_UUID[] = "beb5483e-36e1-4688-b7f5-ea07361b26ac";
+        static constexpr char CHAR_REP_UUID[] = "beb5483e-36e1-4688-b7f5-ea07361b26ad";
+        static constexpr char CHAR_LINK_UUID[] = "beb5483e-36e1-4688-b7f5-ea07361b26ae";
+        static constexpr char CHAR_PERF_UUID[] = "beb5483e-36e1-4688-b7f5-ea07361b26af";
+        static constexpr char CHAR_TIME_UUID[] = "beb5483e-36e1-4688-b7f5-ea07361b26b0";
+        static constexpr uint32_t SERVICE_HANDLES = 32;    // Attribute handles reserved for the service
+    };
+
+    struct Stream
+    {
+        static constexpr uint16_t DEFAULT_MTU = 23;         // ATT MTU before exchange
+        static constexpr uint16_t PREFERRED_MTU = 247;      // Fits one LL packet with DLE
+        static constexpr uint16_t DEFAULT_DATA_LENGTH = 27; // LL payload bytes without DLE
+        static constexpr uint16_t MAX_DATA_LENGTH = 251;    // LL payload bytes requested on connect
+        static constexpr uint8_t ATT_OVERHEAD = 3;          // Opcode + handle per notification
+        static constexpr size_t MAX_FRAME_SIZE = 512;       // Max attribute value length
+        static constexpr uint32_t MAX_FRAME_LATENCY = 100;  // ms a partial frame may be held
+        static constexpr uint16_t SHARED_INTERVAL_FACTOR = 2; // Longer intervals when the phone serves two units
+        static constexpr uint16_t SHARED_MIN_INTERVAL = 12;   // 1.25 ms units: 15 ms, the iOS minimum
+    };
+
+    struct Recording
+    {
+        static constexpr size_t ARENA_SIZE = 1536 * 1024;  // PSRAM bytes (~22 min at 100Hz int16)
+        static constexpr size_t MAX_SESSIONS = 16;         // Sessions kept until erased
+        static constexpr uint32_t MAX_GAP_FILL = 10;       // Dropped samples bridged by repetition
+        static constexpr size_t WINDOW_FRAMES = 8;         // Unacknowledged DATA frames in flight
+        static constexpr uint32_t ACK_TIMEOUT = 500;       // ms without progress before resend
+        static constexpr size_t COMMAND_QUEUE_SIZE = 8;    // Pending commands from the BLE task
     };
 
     struct Display
     {
         static constexpr uint32_t DISPLAY_TIMEOUT = 10000;         // ms before display sleep
         static constexpr uint32_t BATTERY_UPDATE_INTERVAL = 60000; // ms between battery updates
+        static constexpr uint32_t VELOCITY_UPDATE_INTERVAL = 200;  // ms between live velocity redraws
+        static constexpr uint32_t PROGRESS_UPDATE_INTERVAL = 250;  // ms between calibration progress redraws
         static constexpr uint16_t LCD_ROTATION = 3;                // Horizontal screen
     };
 
+    struct Logging
+    {
+        static constexpr size_t RING_CAPACITY = 64; // Queued messages before new ones are dropped
+        static constexpr size_t ARG_BYTES = 80;     // Binary arguments per message, copied strings included
+        static constexpr size_t LINE_SIZE = 256;    // Formatted message bytes
+    };
+
+    struct Perf
+    {
+        static constexpr bool ENABLED = true; // Hot path timers, cheap enough for production
+    };
+
     struct ButtonControl
     {
         static constexpr uint32_t TRIPLE_CLICK_WINDOW = 1000; // ms
@@ -34,9 +79,23 @@ struct Config
     struct Timing
     {
         static constexpr uint32_t CONNECTION_CHECK_INTERVAL = 1000; // ms
-        static constexpr uint32_t SENSOR_UPDATE_INTERVAL = 50;      // ms (20Hz)
-        static constexpr uint32_t POST_CONNECT_DELAY = 100;         // ms
-        static constexpr uint32_t POST_DISCONNECT_DELAY = 500;      // ms
+    };
+
+    struct Tasks
+    {
+        static constexpr uint32_t SENSOR_STACK_SIZE = 4096;   // bytes
+        static constexpr uint32_t SENSOR_PRIORITY = 10;       // Above loop/UI, below BLE controller
+        static constexpr int SENSOR_CORE = 1;                 // Application core
+        static constexpr uint32_t COMMS_STACK_SIZE = 8192;    // bytes
+        static constexpr uint32_t COMMS_PRIORITY = 2;
+        static constexpr int COMMS_CORE = 0;                  // Shares the core with the BLE stack
+        static constexpr uint32_t COMMS_INTERVAL = 10;        // ms between BLE/UI iterations
+        static constexpr size_t SAMPLE_RING_CAPACITY = 256;   // Corrected samples (2.5 s at 100Hz)
+        static constexpr uint32_t STATS_LOG_INTERVAL = 10000; // ms between pipeline stats logs
+        static constexpr uint32_t LOG_STACK_SIZE = 3072;      // bytes, formats one line at a time
+        static constexpr uint32_t LOG_PRIORITY = 1;           // Below comms, Serial waits never delay it
+        static constexpr int LOG_CORE = 1;                    // Keeps UART writes off the BLE core
+        static constexpr uint32_t LOG_INTERVAL = 20;          // ms between log ring drains
     };
 
     struct IMU
@@ -45,29 +104,140 @@ struct Config
         {
             static constexpr uint8_t GYRO_CONFIG = 0x1B;
             static constexpr uint8_t ACCEL_CONFIG = 0x1C;
+            static constexpr uint8_t ACCEL_CONFIG2 = 0x1D;
             static constexpr uint8_t DLPF_CONFIG = 0x1A;
             static constexpr uint8_t SAMPLE_RATE_DIV = 0x19;
+            static constexpr uint8_t ACCEL_WOM_X_THR = 0x20;
+            static constexpr uint8_t ACCEL_WOM_Y_THR = 0x21;
+            static constexpr uint8_t ACCEL_WOM_Z_THR = 0x22;
+            static constexpr uint8_t INT_PIN_CFG = 0x37;
+            static constexpr uint8_t INT_ENABLE = 0x38;
+            static constexpr uint8_t FIFO_EN = 0x23;
+            static constexpr uint8_t INT_STATUS = 0x3A;
+            static constexpr uint8_t USER_CTRL = 0x6A;
+            static constexpr uint8_t FIFO_COUNT_H = 0x72;
+            static constexpr uint8_t FIFO_R_W = 0x74;
+            static constexpr uint8_t ACCEL_INTEL_CTRL = 0x69;
         };
 
         struct Values
         {
             static constexpr uint8_t GYRO_FS_250DPS = 0x0;  // ±250°/s
+            static constexpr uint8_t GYRO_FS_1000DPS = 0x2; // ±1000°/s
+            static constexpr uint8_t GYRO_FS_2000DPS = 0x3; // ±2000°/s
             static constexpr uint8_t ACCEL_FS_8G = 0x2;     // ±8g
+            static constexpr uint8_t ACCEL_FS_16G = 0x3;    // ±16g
+            static constexpr uint8_t DLPF_176HZ = 0x1;      // 176Hz gyro / 218Hz accel bandwidth
+            static constexpr uint8_t DLPF_92HZ = 0x2;       // 92Hz gyro / 99Hz accel bandwidth
             static constexpr uint8_t DLPF_20HZ = 0x4;       // 20Hz bandwidth
+            static constexpr uint8_t DLPF_10HZ = 0x5;       // 10Hz bandwidth
+            static constexpr uint8_t SAMPLE_RATE_1KHZ = 0;  // 1000Hz/(0+1)
+            static constexpr uint8_t SAMPLE_RATE_500HZ = 1; // 1000Hz/(1+1)
             static constexpr uint8_t SAMPLE_RATE_100HZ = 9; // 1000Hz/(9+1)
+            static constexpr uint8_t SAMPLE_RATE_25HZ = 39; // 1000Hz/(39+1)
+            static constexpr float ACCEL_LSB_PER_G = 4096.0f;  // at ±8g
+            static constexpr float GYRO_LSB_PER_DPS = 131.0f;  // at ±250°/s
         };
+
+        struct Fifo
+        {
+            static constexpr uint8_t GYRO_ACCEL_ENABLE = 0x18;   // FIFO_EN: gyro + accel (temp implied)
+            static constexpr uint8_t STOP_WHEN_FULL = 0x40;      // CONFIG: FIFO_MODE bit
+            static constexpr uint8_t USER_CTRL_ENABLE = 0x40;    // USER_CTRL: FIFO_EN bit
+            static constexpr uint8_t USER_CTRL_RESET = 0x04;     // USER_CTRL: FIFO_RST bit
+            static constexpr uint8_t OVERFLOW_FLAG = 0x10;       // INT_STATUS: FIFO_OFLOW_INT bit
+            static constexpr uint16_t CAPACITY = 1024;           // bytes
+            static constexpr uint8_t PACKET_SIZE = 14;           // accel(6) + temp(2) + gyro(6)
+            static constexpr uint8_t READ_BURST_PACKETS = 8;     // packets per I2C transaction
+            static constexpr uint16_t MAX_DRAIN_PACKETS = 73;    // Full FIFO worth of packets
+            static constexpr uint32_t INTERNAL_RATE_HZ = 1000;   // Rate before SAMPLE_RATE_DIV with DLPF on
+            static constexpr float TEMP_LSB_PER_DEG = 326.8f;
+            static constexpr float TEMP_OFFSET = 25.0f;          // °C at raw 0
+        };
+
+        struct Clock
+        {
+            static constexpr uint32_t UPDATE_INTERVAL = 2000;    // ms between sample clock corrections
+            static constexpr uint32_t MAX_ERROR_PPM = 20000;     // Accepted IMU oscillator error
+        };
+
+        struct WakeOnMotion
+        {
+            static constexpr uint8_t INT_ENABLE_WOM = 0xE0;      // INT_ENABLE: WOM X/Y/Z bits
+            static constexpr uint8_t INTEL_ENABLE = 0xC0;        // ACCEL_INTEL_CTRL: enable, compare to previous sample
+            static constexpr uint8_t PIN_LATCHED = 0x30;         // INT_PIN_CFG: active high, latched, cleared by any read
+            static constexpr float MG_PER_LSB = 4.0f;            // Threshold resolution
+        };
+    };
+
+    struct Power
+    {
+        static constexpr uint32_t BETWEEN_SETS_AFTER = 5000;   // ms still before leaving full rate
+        static constexpr uint32_t IDLE_AFTER = 300000;         // ms still and disconnected before light sleep
+        static constexpr float WAKE_THRESHOLD = 0.08f;         // g change that raises the motion interrupt
+        static constexpr int IMU_INT_PIN = -1;                 // MPU6886 INT line, not wired on the StickC Plus2
+        static constexpr uint32_t IDLE_POLL_INTERVAL = 1000;   // ms between light-sleep wakeups that poll the IMU without INT
+        static constexpr int WAKE_BUTTON_PIN = 37;             // Button A, active low
+        static constexpr uint32_t ACTIVE_CPU_MHZ = 240;
+        static constexpr uint32_t RESTING_CPU_MHZ = 80;        // Lowest clock that keeps the radio running
+        static constexpr uint16_t RESTING_MIN_INTERVAL = 80;   // 1.25 ms units: 100 ms
+        static constexpr uint16_t RESTING_MAX_INTERVAL = 160;  // 200 ms
+        static constexpr uint16_t RESTING_LATENCY = 4;         // Connection events the device may skip
+        static constexpr uint16_t SUPERVISION_TIMEOUT = 600;   // 10 ms units: 6 s
+    };
+
+    struct Fusion
+    {
+        static constexpr float BETA = 0.1f;                 // Madgwick gradient step, higher trusts accel more
+        static constexpr float ACCEL_REJECTION = 0.3f;      // g away from 1 g where accel is ignored
+        static constexpr float QUATERNION_SCALE = 16384.0f; // Q14 fixed point for the stream
+    };
+
+    struct Integration
+    {
+        static constexpr float GRAVITY = 9.80665f;            // m/s² per g
+        static constexpr float STILL_ACCEL = 0.05f;           // g of linear acceleration considered still
+        static constexpr uint32_t STILL_DURATION = 150;       // ms of stillness for a zero-velocity update
+        static constexpr uint32_t HISTORY_PERIOD_US = 10000;  // Velocity history resolution (100 Hz)
+        static constexpr size_t HISTORY_SIZE = 1024;          // History entries per segment (~10 s)
+    };
+
+    struct RepDetection
+    {
+        static constexpr float MIN_VELOCITY = 0.05f;          // m/s peak for a phase to count as motion
+        static constexpr float MIN_RANGE = 0.10f;             // m of concentric travel to count a rep
+        static constexpr uint32_t MAX_PHASE_DURATION = 8000;  // ms before a phase is discarded as drift
+        static constexpr size_t MAX_REPS_PER_SEGMENT = 16;    // Reps reported per motion segment
+        static constexpr uint32_t SET_REST_TIMEOUT = 30000;   // ms without reps before a new set starts
+    };
+
+    struct TemperatureCompensation
+    {
+        static constexpr bool ENABLED = true;               // Apply the learned bias-vs-temperature model
+        static constexpr float MIN_TEMPERATURE = 0.0f;      // °C, lower edge of the first bin
+        static constexpr float BIN_WIDTH = 2.0f;            // °C per bin
+        static constexpr size_t BIN_COUNT = 32;             // Covers 0-64 °C
+        static constexpr uint32_t MIN_BIN_SAMPLES = 100;    // Still samples before a bin is used
+        static constexpr uint32_t MAX_BIN_WEIGHT = 5000;    // Caps the averaging so bins keep adapting
+        static constexpr float MAX_EXTRAPOLATION = 6.0f;    // °C a bin value is held beyond its center
     };
 
     struct Calibration
     {
-        static constexpr float GRAVITY_MAGNITUDE = 1.0f;   // Expected gravity magnitude in g
-        static constexpr uint32_t QUICK_SAMPLES = 200;     // Samples per calibration position
-        static constexpr float MOVEMENT_TOLERANCE = 20.0f; // TODO: Hotfix since gyr not cal yet- Maximum allowed movement during sampling
-        static constexpr float STILLNESS_THRESHOLD = 5.1f; // TODO: Hotfix for now Maximum gyro reading to consider device still
-        static constexpr float ROTATION_THRESHOLD = 70.0f; // Min degrees for rotation detection
-        static constexpr uint32_t STABLE_DURATION = 1000;  // ms of stability needed
-        static constexpr float GYRO_DEADBAND = 0.05f;      // Gyro readings below this are zero
-        static constexpr float MIN_SCALE_FACTOR = 0.5f;    // Min acceptable scale factor
-        static constexpr float MAX_SCALE_FACTOR = 2.0f;    // Max acceptable scale factor
+        static constexpr float GRAVITY_MAGNITUDE = 1.0f;       // Expected gravity magnitude in g
+        static constexpr uint32_t QUICK_SAMPLES = 400;         // Samples per calibration position, no RAM cost
+        static constexpr uint32_t STILLNESS_WINDOW = 25;       // Samples per variance stillness check
+        static constexpr float ACCEL_STILL_VARIANCE = 0.0004f; // g², summed over axes, max for a still window
+        static constexpr float GYRO_STILL_VARIANCE = 4.0f;     // (°/s)², summed over axes, max for a still window
+        static constexpr float REPOSITION_TOLERANCE = 0.05f;   // g mean shift that restarts a position
+        static constexpr float STILLNESS_THRESHOLD = 5.1f;     // TODO: Hotfix for now Maximum gyro reading to consider device still
+        static constexpr float ROTATION_THRESHOLD = 70.0f;     // Min degrees for rotation detection
+        static constexpr uint32_t STABLE_DURATION = 1000;      // ms of stability needed
+        static constexpr float GYRO_DEADBAND = 0.05f;          // Gyro readings below this are zero
+        static constexpr float MIN_SCALE_FACTOR = 0.5f;        // Min acceptable scale factor
+        static constexpr float MAX_SCALE_FACTOR = 2.0f;        // Max acceptable scale factor
+        static constexpr float MAX_CROSS_AXIS = 0.1f;          // Max off-diagonal six-position term
+        static constexpr float MAX_FIT_RESIDUAL = 0.02f;       // g RMS error for a six-position fit
+        static constexpr float FACE_ALIGNMENT = 0.9f;          // Min cosine to vertical to identify a face
     };
 };
\ No newline at end of file
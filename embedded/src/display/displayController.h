@@ -1,5 +1,6 @@
 #pragma once
 #include <M5StickCPlus2.h>
+#include <cstring>
 #include "utils/logger.h"
 #include "config/config.h"
 
@@ -8,6 +9,10 @@
  *
  * Handles display sleep/wake cycles, battery information updates, and various
  * UI states including calibration and connection status.
+ *
+ * Remembers what each screen line shows and only redraws lines whose
+ * content changed; a full clear happens only when switching screens.
+ * All drawing runs on the comms task, never on the sensor task.
  */
 class DisplayController
 {
@@ -15,7 +20,27 @@ public:
     // Constants
     static constexpr char MODULE_NAME[] = "DISPLAY";
 
-    DisplayController() : lastActivity(0), displayOn(true), lastBatteryUpdate(0) {}
+    DisplayController()
+        : lastActivity(0),
+          lastBatteryUpdate(0),
+          displayOn(true),
+          screen(Screen::NONE),
+          shownConnected(false),
+          shownRecording(false),
+          shownBattery(-1),
+          shownVelocity{},
+          shownBody{},
+          shownRepLines{},
+          standalone(false),
+          repShown(false),
+          lastRepNumber(0),
+          lastPeakVelocity(0.0f),
+          lastMeanVelocity(0.0f),
+          lastVelocityLoss(0.0f),
+          pendingProgress(-1),
+          lastProgressDraw(0)
+    {
+    }
 
     /**
      * @brief Initializes the display with default settings
@@ -23,7 +48,7 @@ public:
     void begin()
     {
         Logger::info(MODULE_NAME, "Initializing display");
-        M5.Lcd.setRotation(3);
+        M5.Lcd.setRotation(Config::Display::LCD_ROTATION);
         updateDisplayStatus(false, false);
     }
 
@@ -39,21 +64,87 @@ public:
                      "Updating status: BLE %s, Recording %s",
                      bleConnected ? "ON" : "OFF",
                      isRecording ? "ON" : "OFF");
-        drawMainScreen(bleConnected);
+        if (standalone)
+        {
+            shownConnected = bleConnected;
+            shownRecording = isRecording;
+            drawRepScreen();
+        }
+        else
+        {
+            drawMainScreen(bleConnected, isRecording);
+        }
+    }
+
+    /**
+     * @brief Switches between the status screen and the standalone rep readout
+     *
+     * In standalone mode the screen shows the last rep instead of the
+     * connection status, for training without the phone.
+     */
+    void setStandalone(bool enabled)
+    {
+        Logger::logf(Logger::Level::INFO, MODULE_NAME, "Standalone mode %s", enabled ? "ON" : "OFF");
+        standalone = enabled;
+        wakeDisplay();
+        if (standalone)
+            drawRepScreen();
+        else
+            drawMainScreen(shownConnected, shownRecording);
+    }
+
+    [[nodiscard]] bool isStandalone() const noexcept { return standalone; }
+
+    /**
+     * @brief Shows a finished rep in standalone mode
+     * @param repInSet Rep number within the current set
+     * @param peakVelocity m/s
+     * @param meanVelocity m/s
+     * @param velocityLoss % of the fastest rep of the set
+     */
+    void showRep(uint16_t repInSet, float peakVelocity, float meanVelocity, float velocityLoss)
+    {
+        repShown = true;
+        lastRepNumber = repInSet;
+        lastPeakVelocity = peakVelocity;
+        lastMeanVelocity = meanVelocity;
+        lastVelocityLoss = velocityLoss;
+
+        if (standalone && screen != Screen::CALIBRATION)
+        {
+            wakeDisplay();
+            drawRepScreen();
+        }
     }
 
+    /**
+     * @brief Handles the display timeout and periodic redraws
+     *
+     * Also draws a calibration progress update held back by the rate limit.
+     */
     void manageDisplayState()
     {
         if (displayOn && (millis() - lastActivity > Config::Display::DISPLAY_TIMEOUT))
         {
             Logger::debug(MODULE_NAME, "Display timeout - entering sleep");
-            M5.Lcd.sleep();
-            displayOn = false;
+            sleepDisplay();
         }
         if (displayOn && (millis() - lastBatteryUpdate > Config::Display::BATTERY_UPDATE_INTERVAL))
         {
             updateBatteryInfo();
         }
+        if (pendingProgress >= 0 && millis() - lastProgressDraw >= Config::Display::PROGRESS_UPDATE_INTERVAL)
+        {
+            drawProgress();
+        }
+    }
+
+    void sleepDisplay()
+    {
+        if (!displayOn)
+            return;
+        M5.Lcd.sleep();
+        displayOn = false;
     }
 
     void wakeDisplay()
@@ -61,87 +152,243 @@ public:
         if (!displayOn)
         {
             Logger::debug(MODULE_NAME, "Waking display");
+            M5.Lcd.wakeup();
         }
-        M5.Lcd.wakeup();
         displayOn = true;
         lastActivity = millis();
     }
 
+    /**
+     * @brief Redraws the live vertical velocity line when its text changes
+     *
+     * Only shown on the main screen. Does not wake the display, so a moving
+     * sensor alone keeps the normal display timeout.
+     */
+    void updateVelocity(float velocity)
+    {
+        if (!displayOn || screen != Screen::MAIN)
+            return;
+
+        char velocityStr[sizeof(shownVelocity)];
+        snprintf(velocityStr, sizeof(velocityStr), "VEL: %+.2f m/s", velocity);
+        if (strcmp(velocityStr, shownVelocity) == 0)
+            return;
+
+        M5.Lcd.startWrite();
+        drawLine(velocityStr, VELOCITY_Y, WHITE, BLACK);
+        M5.Lcd.endWrite();
+        strcpy(shownVelocity, velocityStr);
+    }
+
     /**
      * @brief Shows calibration progress on screen
+     *
+     * Redraws at most every Config::Display::PROGRESS_UPDATE_INTERVAL; the
+     * first and last values are always drawn immediately.
      * @param progress Current progress percentage (0-100)
      */
     void showCalibrationProgress(int progress)
     {
         wakeDisplay();
-        M5.Lcd.startWrite();
-        M5.Lcd.fillScreen(PURPLE);
-        M5.Lcd.setCursor(0, 0);
-        M5.Lcd.setTextSize(2);
-        M5.Lcd.setTextColor(WHITE);
-        M5.Lcd.println("Calibrating...");
-        M5.Lcd.setCursor(0, 30);
-        M5.Lcd.printf("Progress: %d%%", progress);
-        M5.Lcd.endWrite();
-        lastActivity = millis();
+        pendingProgress = progress;
+        if (screen != Screen::CALIBRATION || progress == 0 || progress >= 100 ||
+            millis() - lastProgressDraw >= Config::Display::PROGRESS_UPDATE_INTERVAL)
+        {
+            drawProgress();
+        }
     }
 
+    /**
+     * @brief Shows a calibration instruction; repeating the current one draws nothing
+     */
     void showCalibrationInstruction(const char *instruction)
     {
         wakeDisplay();
-        M5.Lcd.startWrite();
-        M5.Lcd.fillScreen(PURPLE);
-        M5.Lcd.setCursor(0, 0);
-        M5.Lcd.setTextSize(2);
-        M5.Lcd.setTextColor(WHITE);
-        M5.Lcd.println("Calibrating...");
-        M5.Lcd.setCursor(0, 30);
-        M5.Lcd.println(instruction);
-        M5.Lcd.endWrite();
-        lastActivity = millis();
+        pendingProgress = -1;
+        showCalibrationBody(instruction);
     }
 
 private:
+    enum class Screen : uint8_t
+    {
+        NONE,
+        MAIN,
+        CALIBRATION,
+        REPS
+    };
+
+    // Text line layout at text size 2
+    static constexpr int LINE_HEIGHT = 20;
+    static constexpr int STATUS_Y = 5;
+    static constexpr int RECORDING_Y = 30;
+    static constexpr int BATTERY_Y = 55;
+    static constexpr int VELOCITY_Y = 80;
+    static constexpr int CALIBRATION_BODY_Y = 30;
+    static constexpr int REP_LINES = 4;
+    static constexpr int REP_LINE_SPACING = 25;
+
     uint32_t lastActivity;
     uint32_t lastBatteryUpdate;
     bool displayOn;
 
-    void drawMainScreen(bool bleConnected)
+    // What is on the panel, so updates only redraw the lines that changed
+    Screen screen;
+    bool shownConnected;
+    bool shownRecording;
+    int shownBattery;     // %, -1 when not drawn
+    char shownVelocity[24];
+    char shownBody[32];   // Calibration instruction or progress line
+    char shownRepLines[REP_LINES][24];
+
+    // Standalone rep readout
+    bool standalone;
+    bool repShown;
+    uint16_t lastRepNumber;
+    float lastPeakVelocity;
+    float lastMeanVelocity;
+    float lastVelocityLoss;
+    int pendingProgress;  // Not drawn yet because of the rate limit, -1 if none
+    uint32_t lastProgressDraw;
+
+    /**
+     * @brief Clears one text line and draws str on it
+     */
+    void drawLine(const char *str, int y, uint16_t color, uint16_t background)
+    {
+        M5.Lcd.fillRect(5, y, M5.Lcd.width() - 10, LINE_HEIGHT, background);
+        M5.Lcd.setTextColor(color);
+        M5.Lcd.drawString(str, 5, y);
+    }
+
+    void drawRepScreen()
     {
         M5.Lcd.startWrite();
-        M5.Lcd.fillScreen(BLACK);
-        M5.Lcd.setCursor(5, 5);
-        M5.Lcd.setTextSize(2);
+        if (screen != Screen::REPS)
+        {
+            M5.Lcd.fillScreen(BLACK);
+            M5.Lcd.setTextSize(2);
+            screen = Screen::REPS;
+            for (auto &line : shownRepLines)
+                line[0] = '\0';
+        }
 
-        M5.Lcd.setTextColor(bleConnected ? GREEN : RED);
-        M5.Lcd.drawString(bleConnected ? "BLE: Connected" : "BLE: Waiting", 5, 5);
-        M5.Lcd.setTextColor(WHITE);
+        char lines[REP_LINES][sizeof(shownRepLines[0])];
+        if (repShown)
+        {
+            snprintf(lines[0], sizeof(lines[0]), "Rep %u", static_cast<unsigned>(lastRepNumber));
+            snprintf(lines[1], sizeof(lines[1]), "Peak %.2f m/s", lastPeakVelocity);
+            snprintf(lines[2], sizeof(lines[2]), "Mean %.2f m/s", lastMeanVelocity);
+            snprintf(lines[3], sizeof(lines[3]), "Loss %.0f%%", lastVelocityLoss);
+        }
+        else
+        {
+            snprintf(lines[0], sizeof(lines[0]), "Waiting for rep");
+            lines[1][0] = lines[2][0] = lines[3][0] = '\0';
+        }
+
+        // Loss in yellow, to stand out when the set should end
+        const uint16_t colors[REP_LINES] = {GREEN, WHITE, WHITE, YELLOW};
+        for (int i = 0; i < REP_LINES; i++)
+        {
+            if (strcmp(lines[i], shownRepLines[i]) != 0)
+            {
+                drawLine(lines[i], STATUS_Y + i * REP_LINE_SPACING, colors[i], BLACK);
+                strcpy(shownRepLines[i], lines[i]);
+            }
+        }
+        M5.Lcd.endWrite();
+    }
 
-        float batteryLevel = M5.Power.getBatteryLevel();
-        char batteryStr[16];
-        snprintf(batteryStr, sizeof(batteryStr), "BAT: %.0f%%", batteryLevel);
-        M5.Lcd.drawString(batteryStr, 5, 55);
+    void drawMainScreen(bool bleConnected, bool isRecording)
+    {
+        M5.Lcd.startWrite();
+        bool full = screen != Screen::MAIN;
+        if (full)
+        {
+            M5.Lcd.fillScreen(BLACK);
+            M5.Lcd.setTextSize(2);
+            screen = Screen::MAIN;
+            shownBattery = -1;
+            shownVelocity[0] = '\0';
+        }
 
+        if (full || bleConnected != shownConnected)
+        {
+            drawLine(bleConnected ? "BLE: Connected" : "BLE: Waiting", STATUS_Y,
+                     bleConnected ? GREEN : RED, BLACK);
+        }
+        if (full || isRecording != shownRecording)
+        {
+            drawLine(isRecording ? "REC" : "", RECORDING_Y, RED, BLACK);
+        }
+        shownConnected = bleConnected;
+        shownRecording = isRecording;
+
+        drawBattery();
         M5.Lcd.endWrite();
         lastActivity = millis();
+    }
+
+    void drawBattery()
+    {
+        int batteryLevel = static_cast<int>(M5.Power.getBatteryLevel());
+        if (batteryLevel != shownBattery)
+        {
+            char batteryStr[16];
+            snprintf(batteryStr, sizeof(batteryStr), "BAT: %d%%", batteryLevel);
+            drawLine(batteryStr, BATTERY_Y, WHITE, BLACK);
+            shownBattery = batteryLevel;
+        }
         lastBatteryUpdate = millis();
     }
 
+    void drawProgress()
+    {
+        char progressStr[sizeof(shownBody)];
+        snprintf(progressStr, sizeof(progressStr), "Progress: %d%%", pendingProgress);
+        pendingProgress = -1;
+        lastProgressDraw = millis();
+        showCalibrationBody(progressStr);
+    }
+
+    void showCalibrationBody(const char *body)
+    {
+        bool full = screen != Screen::CALIBRATION;
+        if (!full && strcmp(body, shownBody) == 0)
+            return;
+
+        M5.Lcd.startWrite();
+        if (full)
+        {
+            M5.Lcd.fillScreen(PURPLE);
+            M5.Lcd.setTextSize(2);
+            M5.Lcd.setTextColor(WHITE);
+            M5.Lcd.drawString("Calibrating...", 0, 0);
+            screen = Screen::CALIBRATION;
+        }
+        M5.Lcd.fillRect(0, CALIBRATION_BODY_Y, M5.Lcd.width(), LINE_HEIGHT, PURPLE);
+        M5.Lcd.setTextColor(WHITE);
+        M5.Lcd.drawString(body, 0, CALIBRATION_BODY_Y);
+        M5.Lcd.endWrite();
+
+        strncpy(shownBody, body, sizeof(shownBody) - 1);
+        shownBody[sizeof(shownBody) - 1] = '\0';
+        lastActivity = millis();
+    }
+
     void updateBatteryInfo()
     {
-        if (!displayOn)
+        if (!displayOn || screen != Screen::MAIN)
+        {
+            lastBatteryUpdate = millis();
             return;
+        }
 
-        float batteryLevel = M5.Power.getBatteryLevel();
-        Logger::logf(Logger::Level::DEBUG, MODULE_NAME, "Battery level: %.1f%%", batteryLevel);
+        Logger::logf(Logger::Level::DEBUG, MODULE_NAME, "Battery level: %.1f%%",
+                     static_cast<float>(M5.Power.getBatteryLevel()));
 
         M5.Lcd.startWrite();
-        M5.Lcd.fillRect(5, 55, M5.Lcd.width() - 10, 20, BLACK);
-        char batteryStr[16];
-        snprintf(batteryStr, sizeof(batteryStr), "BAT: %.0f%%", batteryLevel);
-        M5.Lcd.drawString(batteryStr, 5, 55);
+        drawBattery();
         M5.Lcd.endWrite();
-
-        lastBatteryUpdate = millis();
     }
 };
\ No newline at end of file
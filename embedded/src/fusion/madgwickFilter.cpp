@@ -0,0 +1,103 @@
+#include "madgwickFilter.h"
+
+namespace
+{
+    constexpr float DEG_TO_RAD_F = 0.01745329252f;
+
+    inline float invSqrt(float value)
+    {
+        return 1.0f / sqrtf(value);
+    }
+}
+
+MadgwickFilter::MadgwickFilter() noexcept
+    : q(),
+      initialized(false)
+{
+}
+
+void MadgwickFilter::reset()
+{
+    q = Quaternion();
+    initialized = false;
+}
+
+void MadgwickFilter::initializeFromGravity(const Vector3D &accel)
+{
+    // Start level with the measured gravity instead of converging from identity
+    float roll = atan2f(accel.y, accel.z);
+    float pitch = atan2f(-accel.x, sqrtf(accel.y * accel.y + accel.z * accel.z));
+
+    float cr = cosf(roll * 0.5f), sr = sinf(roll * 0.5f);
+    float cp = cosf(pitch * 0.5f), sp = sinf(pitch * 0.5f);
+    q = Quaternion(cr * cp, sr * cp, cr * sp, -sr * sp);
+    initialized = true;
+}
+
+void MadgwickFilter::update(const Vector3D &accel, const Vector3D &gyro, float dt)
+{
+    float accelNorm = accel.magnitude();
+    if (!initialized)
+    {
+        if (accelNorm > 0.0f)
+            initializeFromGravity(accel);
+        return;
+    }
+
+    float gx = gyro.x * DEG_TO_RAD_F;
+    float gy = gyro.y * DEG_TO_RAD_F;
+    float gz = gyro.z * DEG_TO_RAD_F;
+    float q0 = q.w, q1 = q.x, q2 = q.y, q3 = q.z;
+
+    // Rate of change of the quaternion from the gyroscope
+    float qDot0 = 0.5f * (-q1 * gx - q2 * gy - q3 * gz);
+    float qDot1 = 0.5f * (q0 * gx + q2 * gz - q3 * gy);
+    float qDot2 = 0.5f * (q0 * gy - q1 * gz + q3 * gx);
+    float qDot3 = 0.5f * (q0 * gz + q1 * gy - q2 * gx);
+
+    if (accelNorm > 0.0f && fabsf(accelNorm - 1.0f) < Config::Fusion::ACCEL_REJECTION)
+    {
+        float recipNorm = 1.0f / accelNorm;
+        float ax = accel.x * recipNorm;
+        float ay = accel.y * recipNorm;
+        float az = accel.z * recipNorm;
+
+        float _2q0 = 2.0f * q0, _2q1 = 2.0f * q1, _2q2 = 2.0f * q2, _2q3 = 2.0f * q3;
+        float _4q0 = 4.0f * q0, _4q1 = 4.0f * q1, _4q2 = 4.0f * q2;
+        float _8q1 = 8.0f * q1, _8q2 = 8.0f * q2;
+        float q0q0 = q0 * q0, q1q1 = q1 * q1, q2q2 = q2 * q2, q3q3 = q3 * q3;
+
+        // Gradient of the error between estimated and measured gravity
+        float s0 = _4q0 * q2q2 + _2q2 * ax + _4q0 * q1q1 - _2q1 * ay;
+        float s1 = _4q1 * q3q3 - _2q3 * ax + 4.0f * q0q0 * q1 - _2q0 * ay - _4q1 + _8q1 * q1q1 +
+                   _8q1 * q2q2 + _4q1 * az;
+        float s2 = 4.0f * q0q0 * q2 + _2q0 * ax + _4q2 * q3q3 - _2q3 * ay - _4q2 + _8q2 * q1q1 +
+                   _8q2 * q2q2 + _4q2 * az;
+        float s3 = 4.0f * q1q1 * q3 - _2q1 * ax + 4.0f * q2q2 * q3 - _2q2 * ay;
+
+        float sNorm = s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3;
+        if (sNorm > 0.0f)
+        {
+            float step = Config::Fusion::BETA * invSqrt(sNorm);
+            qDot0 -= step * s0;
+            qDot1 -= step * s1;
+            qDot2 -= step * s2;
+            qDot3 -= step * s3;
+        }
+    }
+
+    q0 += qDot0 * dt;
+    q1 += qDot1 * dt;
+    q2 += qDot2 * dt;
+    q3 += qDot3 * dt;
+
+    float recipNorm = invSqrt(q0 * q0 + q1 * q1 + q2 * q2 + q3 * q3);
+    q = Quaternion(q0 * recipNorm, q1 * recipNorm, q2 * recipNorm, q3 * recipNorm);
+}
+
+Vector3D MadgwickFilter::linearAcceleration(const Vector3D &accel) const
+{
+    Vector3D world = q.rotate(accel);
+    world.z -= Config::Calibration::GRAVITY_MAGNITUDE;
+    return world;
+}
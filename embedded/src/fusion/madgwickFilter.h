@@ -0,0 +1,42 @@
+#pragma once
+#include "config/config.h"
+#include "utils/quaternion.h"
+#include "utils/vector3d.h"
+
+/**
+ * @brief 6-axis Madgwick orientation filter
+ *
+ * Integrates the gyroscope and pulls the estimate towards the measured
+ * gravity direction with a gradient-descent step of size beta. The
+ * accelerometer step is skipped while the measured magnitude is far from
+ * 1 g, so hard pulls and drops do not tilt the estimate. Yaw is unobserved
+ * without a magnetometer and drifts slowly.
+ */
+class MadgwickFilter
+{
+public:
+    MadgwickFilter() noexcept;
+
+    void reset();
+
+    /**
+     * @brief Advances the estimate by one sample
+     * @param accel Acceleration in g
+     * @param gyro Angular rate in °/s
+     * @param dt Time since the previous sample in seconds
+     */
+    void update(const Vector3D &accel, const Vector3D &gyro, float dt);
+
+    const Quaternion &orientation() const { return q; }
+
+    /**
+     * @brief Acceleration in the world frame with gravity removed, in g
+     */
+    Vector3D linearAcceleration(const Vector3D &accel) const;
+
+private:
+    Quaternion q;
+    bool initialized;
+
+    void initializeFromGravity(const Vector3D &accel);
+};
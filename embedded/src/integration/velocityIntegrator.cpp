@@ -0,0 +1,123 @@
+#include <algorithm>
+#include "velocityIntegrator.h"
+
+VelocityIntegrator::VelocityIntegrator() noexcept
+    : samplePeriodUs(0)
+{
+    reset();
+}
+
+void VelocityIntegrator::reset()
+{
+    count = 0;
+    samples = 0;
+    strideCount = 0;
+    strideSum = 0.0f;
+    stride = samplePeriodUs > 0 ? std::max<uint32_t>(1, Config::Integration::HISTORY_PERIOD_US / samplePeriodUs) : 1;
+    segmentStartUs = 0;
+    inMotion = false;
+    quiet = false;
+    quietSinceUs = 0;
+    stationary = false;
+    liveVelocity = 0.0f;
+    closed = VelocitySegment{0, 0, 0, 0.0f, false, history};
+}
+
+bool VelocityIntegrator::detectStill(const CorrectedSample &sample)
+{
+    bool quietNow = sample.imu.gyro.magnitude() < Config::Calibration::STILLNESS_THRESHOLD &&
+                    sample.linearAccel.magnitude() < Config::Integration::STILL_ACCEL;
+    if (!quietNow)
+    {
+        quiet = false;
+        return false;
+    }
+
+    if (!quiet)
+    {
+        quiet = true;
+        quietSinceUs = sample.imu.timestampUs;
+    }
+    return sample.imu.timestampUs - quietSinceUs >= Config::Integration::STILL_DURATION * 1000ULL;
+}
+
+void VelocityIntegrator::beginSegment(uint64_t nowUs)
+{
+    inMotion = true;
+    segmentStartUs = nowUs;
+    count = 0;
+    samples = 0;
+    strideCount = 0;
+    strideSum = 0.0f;
+}
+
+void VelocityIntegrator::closeSegment()
+{
+    if (strideCount > 0 && count < Config::Integration::HISTORY_SIZE)
+    {
+        history[count++] = strideSum / strideCount;
+    }
+
+    // Entry i averages samples [i * stride, (i + 1) * stride); linear drift
+    // reaches liveVelocity after the last sample
+    float drift = liveVelocity;
+    float driftPerSample = samples > 0 ? drift / samples : 0.0f;
+    for (size_t i = 0; i < count; i++)
+    {
+        float center = i * stride + (stride + 1) * 0.5f;
+        history[i] -= driftPerSample * center;
+    }
+
+    closed.startUs = segmentStartUs;
+    closed.periodUs = samplePeriodUs * stride;
+    closed.count = count;
+    closed.drift = drift;
+    closed.truncated = samples > count * stride;
+    closed.velocity = history;
+    inMotion = false;
+}
+
+bool VelocityIntegrator::update(const CorrectedSample &sample, uint32_t periodUs)
+{
+    if (periodUs != samplePeriodUs)
+    {
+        // Entries of the open segment would have mixed spacing
+        samplePeriodUs = periodUs;
+        reset();
+    }
+
+    stationary = detectStill(sample);
+    if (stationary)
+    {
+        bool ended = inMotion;
+        if (ended)
+        {
+            closeSegment();
+        }
+        liveVelocity = 0.0f;
+        return ended;
+    }
+
+    if (!inMotion)
+    {
+        // Quiet samples right after a zero-velocity update do not open a segment
+        if (quiet)
+            return false;
+        beginSegment(sample.imu.timestampUs);
+    }
+
+    liveVelocity += sample.linearAccel.z * Config::Integration::GRAVITY * periodUs * 1e-6f;
+    samples++;
+
+    strideSum += liveVelocity;
+    if (++strideCount == stride)
+    {
+        if (count < Config::Integration::HISTORY_SIZE)
+        {
+            history[count++] = strideSum / stride;
+        }
+        strideCount = 0;
+        strideSum = 0.0f;
+    }
+    return false;
+}
@@ -0,0 +1,78 @@
+#pragma once
+#include "config/config.h"
+#include "sensor/correctedSample.h"
+
+/**
+ * @brief Drift-corrected vertical velocity of one motion segment
+ *
+ * A segment spans the samples between two zero-velocity updates. Entries
+ * are averaged down to Config::Integration::HISTORY_PERIOD_US.
+ */
+struct VelocitySegment
+{
+    uint64_t startUs;      // Device time of the first sample
+    uint32_t periodUs;     // Spacing of the history entries
+    size_t count;          // History entries
+    float drift;           // m/s integrated by the end of the segment and removed
+    bool truncated;        // Motion outlasted the history, the tail is missing
+    const float *velocity; // m/s, world-frame vertical
+};
+
+/**
+ * @brief Integrates gravity-free vertical acceleration into velocity with
+ * zero-velocity updates (ZUPT)
+ *
+ * The sensor counts as still once the gyro stays below
+ * Config::Calibration::STILLNESS_THRESHOLD and the linear acceleration below
+ * Config::Integration::STILL_ACCEL for STILL_DURATION. Velocity is clamped
+ * to zero there. Any velocity left at that point is drift; it is assumed to
+ * grow linearly (constant residual acceleration bias) and is removed
+ * retroactively from the history of the segment that just ended.
+ *
+ * Memory is bounded by Config::Integration::HISTORY_SIZE entries; longer
+ * segments keep integrating but only their start is kept.
+ */
+class VelocityIntegrator
+{
+public:
+    VelocityIntegrator() noexcept;
+
+    void reset();
+
+    /**
+     * @brief Processes one sample
+     * @param periodUs Sample period; a change discards the open segment
+     * @return true if a motion segment ended with this sample, segment() is
+     * then valid until the next call
+     */
+    bool update(const CorrectedSample &sample, uint32_t periodUs);
+
+    /**
+     * @brief Live vertical velocity in m/s, zero while still
+     *
+     * Not drift-corrected until the segment ends.
+     */
+    [[nodiscard]] float velocity() const noexcept { return liveVelocity; }
+    [[nodiscard]] bool isStill() const noexcept { return stationary; }
+    [[nodiscard]] const VelocitySegment &segment() const noexcept { return closed; }
+
+private:
+    float history[Config::Integration::HISTORY_SIZE];
+    size_t count;
+    uint32_t samples;      // Samples in the open segment, including ones past the history
+    uint32_t stride;       // Samples averaged per history entry
+    uint32_t strideCount;
+    float strideSum;
+    uint32_t samplePeriodUs;
+    uint64_t segmentStartUs;
+    bool inMotion;
+    bool quiet;
+    uint64_t quietSinceUs;
+    bool stationary;
+    float liveVelocity;
+    VelocitySegment closed;
+
+    bool detectStill(const CorrectedSample &sample);
+    void beginSegment(uint64_t nowUs);
+    void closeSegment();
+};
@@ -4,8 +4,22 @@
 #include <BLEUtils.h>
 #include <BLE2902.h>
 #include <memory>
+#include "analysis/repProtocol.h"
+#include "analysis/setTracker.h"
+#include "ble/linkManager.h"
+#include "ble/timeSyncProtocol.h"
+#include "ble/unitIdentity.h"
 #include "calibration/SetupCalibration.h"
+#include "calibration/calibrationStore.h"
 #include "display/DisplayController.h"
+#include "integration/velocityIntegrator.h"
+#include "perf/perfCounters.h"
+#include "power/powerManager.h"
+#include "sensor/imuSampler.h"
+#include "sensor/sensorTask.h"
+#include "storage/recordingTransfer.h"
+#include "storage/sessionRecorder.h"
+#include "stream/sampleBatcher.h"
 #include "utils/logger.h"
 #include "utils/error.h"
 #include "config/config.h"
@@ -16,6 +30,32 @@
  * Handles BLE communication, sensor data processing, and device management.
  * The device operates as a BLE server, providing real-time IMU data and
  * supporting device calibration.
+ *
+ * Work is split across the two ESP32 cores: the sensor task (core 1) drains
+ * the IMU and applies calibration, the comms task (core 0, next to the BLE
+ * stack) consumes the sample ring and handles BLE, display and buttons.
+ *
+ * Samples are also recorded to PSRAM when recording is enabled, whether or
+ * not a client is connected, and downloaded later over the record
+ * characteristic.
+ *
+ * Vertical velocity is integrated on the device with zero-velocity updates;
+ * the live value is shown on the display and every motion segment is
+ * drift-corrected and searched for reps. Each rep is notified as a compact
+ * summary on the rep characteristic, which needs no stream subscription.
+ *
+ * The link characteristic reports the negotiated MTU, connection interval
+ * and data length; the stream frames are sized from the MTU.
+ *
+ * The perf characteristic reports hot path timings, sample losses and free
+ * memory when read, to see how close the firmware runs to its limits.
+ *
+ * The time characteristic echoes app pings with device timestamps, so the
+ * app can map sample timestamps onto its own clock.
+ *
+ * Several units can stream into one session: each stream frame names the
+ * unit and its role, and units with a role other than SOLO ask for longer
+ * connection intervals so the phone can serve two at full rate.
  */
 
 static constexpr char MODULE_NAME[] = "MAIN";
@@ -25,10 +65,63 @@ std::unique_ptr<BLEServer> pServer;
 std::unique_ptr<BLECharacteristic> pAccCharacteristic;
 std::unique_ptr<BLECharacteristic> pGyrCharacteristic;
 std::unique_ptr<BLECharacteristic> pCalibCharacteristic;
+std::unique_ptr<BLECharacteristic> pStreamCharacteristic;
+std::unique_ptr<BLECharacteristic> pRecordCharacteristic;
+std::unique_ptr<BLECharacteristic> pRepCharacteristic;
+std::unique_ptr<BLECharacteristic> pLinkCharacteristic;
+std::unique_ptr<BLECharacteristic> pPerfCharacteristic;
+std::unique_ptr<BLECharacteristic> pTimeCharacteristic;
+BLE2902 *pAccNotifyDescriptor = nullptr;
+BLE2902 *pGyrNotifyDescriptor = nullptr;
+BLE2902 *pStreamNotifyDescriptor = nullptr;
+BLE2902 *pRepNotifyDescriptor = nullptr;
+BLE2902 *pLinkNotifyDescriptor = nullptr;
 std::unique_ptr<SetupCalibration> setupCalibration;
+CalibrationStore calibrationStore;
 bool deviceConnected = false;
 bool connectionChanged = false;
+volatile StreamFormat requestedStreamFormat = StreamFormat::FLOAT32;
+AcquisitionProfile streamProfile = DEFAULT_ACQUISITION_PROFILE; // Profile of the samples being consumed
 DisplayController deviceDisplay;
+ImuSampler imuSampler;
+SampleRing sampleRing;
+SensorCorrection sensorCorrection;
+SensorTask sensorTask(imuSampler, sensorCorrection, sampleRing);
+LinkManager linkManager;
+UnitIdentity unitIdentity;
+PowerManager powerManager(sensorTask, deviceDisplay, linkManager);
+VelocityIntegrator velocityIntegrator;
+RepDetector repDetector;
+SetTracker setTracker;
+
+class StreamCharacteristicSink : public FrameSink
+{
+public:
+  void sendFrame(const uint8_t *data, size_t length) override
+  {
+    ScopedPerfTimer timer(PerfTimerId::NOTIFY);
+    pStreamCharacteristic->setValue(const_cast<uint8_t *>(data), length);
+    pStreamCharacteristic->notify();
+  }
+};
+
+class RecordCharacteristicSink : public FrameSink
+{
+public:
+  void sendFrame(const uint8_t *data, size_t length) override
+  {
+    if (!deviceConnected)
+      return;
+    pRecordCharacteristic->setValue(const_cast<uint8_t *>(data), length);
+    pRecordCharacteristic->notify();
+  }
+};
+
+StreamCharacteristicSink streamSink;
+SampleBatcher sampleBatcher(streamSink);
+RecordCharacteristicSink recordSink;
+SessionRecorder sessionRecorder;
+RecordingTransfer recordingTransfer(sessionRecorder, recordSink);
 
 std::array<uint32_t, 3> lastClickTimes{};
 
@@ -43,7 +136,13 @@ struct __attribute__((packed)) SensorPacket
 enum class CalibrationCommand : uint8_t
 {
   START_QUICK = 1,
-  ABORT = 2
+  ABORT = 2,
+  SET_STREAM_FORMAT = 3, // Followed by one StreamFormat byte
+  SET_PROFILE = 4,       // Followed by one AcquisitionProfile byte
+  START_SIX_POSITION = 5,
+  READ_INFO = 6,         // Sets the value to CalibrationInfo for the following read
+  FORGET = 7,            // Invalidates and removes the stored calibration
+  SET_ROLE = 8           // Followed by one UnitRole byte, kept across reboots
 };
 
 class CalibrationCallback : public BLECharacteristicCallbacks
@@ -71,10 +170,72 @@ class CalibrationCallback : public BLECharacteristicCallbacks
       Logger::info(MODULE_NAME, "Starting quick calibration");
       setupCalibration->startQuickCalibration();
       break;
+    case CalibrationCommand::START_SIX_POSITION:
+      Logger::info(MODULE_NAME, "Starting six-position calibration");
+      setupCalibration->startSixPositionCalibration();
+      break;
+    case CalibrationCommand::READ_INFO:
+      setupCalibration->publishInfo();
+      break;
+    case CalibrationCommand::FORGET:
+    {
+      Error error = setupCalibration->forgetCalibration();
+      if (error.isError())
+      {
+        Logger::error(MODULE_NAME, error.message());
+      }
+      break;
+    }
     case CalibrationCommand::ABORT:
       Logger::info(MODULE_NAME, "Aborting calibration");
       setupCalibration->abortCalibration();
       break;
+    case CalibrationCommand::SET_STREAM_FORMAT:
+    {
+      auto format = pCharacteristic->getLength() > 1
+                        ? static_cast<StreamFormat>(pCharacteristic->getData()[1])
+                        : StreamFormat::FLOAT32;
+      if (format != StreamFormat::FLOAT32 && format != StreamFormat::INT16 &&
+          format != StreamFormat::INT16_DELTA && format != StreamFormat::FUSION)
+      {
+        Logger::logf(Logger::Level::ERROR, MODULE_NAME, "Unknown stream format: %d", static_cast<int>(format));
+        break;
+      }
+      Logger::logf(Logger::Level::INFO, MODULE_NAME, "Stream format: %d", static_cast<int>(format));
+      requestedStreamFormat = format;
+      break;
+    }
+    case CalibrationCommand::SET_PROFILE:
+    {
+      uint8_t profile = pCharacteristic->getLength() > 1 ? pCharacteristic->getData()[1] : 0xFF;
+      if (!isValidProfile(profile))
+      {
+        Logger::logf(Logger::Level::ERROR, MODULE_NAME, "Unknown acquisition profile: %d", profile);
+        break;
+      }
+      // Calibration thresholds assume one configuration throughout
+      if (setupCalibration->isCalibrationInProgress())
+      {
+        Logger::error(MODULE_NAME, "Cannot change acquisition profile during calibration");
+        break;
+      }
+      Logger::logf(Logger::Level::INFO, MODULE_NAME, "Acquisition profile: %s",
+                   profileSettings(static_cast<AcquisitionProfile>(profile)).name);
+      powerManager.setSelectedProfile(static_cast<AcquisitionProfile>(profile));
+      break;
+    }
+    case CalibrationCommand::SET_ROLE:
+    {
+      uint8_t role = pCharacteristic->getLength() > 1 ? pCharacteristic->getData()[1] : 0xFF;
+      if (!UnitIdentity::isValidRole(role))
+      {
+        Logger::logf(Logger::Level::ERROR, MODULE_NAME, "Unknown unit role: %d", role);
+        break;
+      }
+      Logger::logf(Logger::Level::INFO, MODULE_NAME, "Unit role: %d", role);
+      unitIdentity.setRole(static_cast<UnitRole>(role));
+      break;
+    }
     default:
       Logger::logf(Logger::Level::ERROR, MODULE_NAME, "Unknown command: %d", static_cast<int>(cmd));
       break;
@@ -82,20 +243,100 @@ class CalibrationCallback : public BLECharacteristicCallbacks
   }
 };
 
+class RecordCallback : public BLECharacteristicCallbacks
+{
+  void onWrite(BLECharacteristic *pCharacteristic) override
+  {
+    if (!pCharacteristic || !pCharacteristic->getData())
+    {
+      Logger::error(MODULE_NAME, "Invalid characteristic or data");
+      return;
+    }
+
+    // Handled by the comms task, which owns the recorder
+    if (!recordingTransfer.enqueue(pCharacteristic->getData(), pCharacteristic->getLength()))
+    {
+      Logger::error(MODULE_NAME, "Dropped record command");
+    }
+  }
+};
+
+/**
+ * @brief Builds the perf snapshot on every read; any write resets the timers
+ */
+class PerfCallback : public BLECharacteristicCallbacks
+{
+  void onRead(BLECharacteristic *pCharacteristic) override
+  {
+    PerfStatsPacket packet{};
+    packet.version = PERF_PROTOCOL_VERSION;
+    packet.uptimeMs = millis();
+    packet.fifoDropped = imuSampler.droppedSamples();
+    packet.fifoOverflows = imuSampler.overflowCount();
+    packet.ringOverflows = sampleRing.overflowCount();
+    packet.ringHighWater = static_cast<uint16_t>(sampleRing.highWaterMark());
+    packet.ringCapacity = static_cast<uint16_t>(SampleRing::capacity());
+    packet.freeHeap = ESP.getFreeHeap();
+    packet.minFreeHeap = ESP.getMinFreeHeap();
+    packet.freePsram = ESP.getFreePsram();
+    PerfCounters::encode(packet);
+    pCharacteristic->setValue(reinterpret_cast<uint8_t *>(&packet), sizeof(packet));
+  }
+
+  void onWrite(BLECharacteristic *pCharacteristic) override
+  {
+    PerfCounters::reset();
+    Logger::info(MODULE_NAME, "Perf timers reset");
+  }
+};
+
+class TimeSyncCallback : public BLECharacteristicCallbacks
+{
+  void onWrite(BLECharacteristic *pCharacteristic) override
+  {
+    // Answered right in the BLE task, queuing would add to the round trip
+    uint64_t receiveUs = esp_timer_get_time();
+    if (!pCharacteristic->getData() || pCharacteristic->getLength() < sizeof(TimeSyncPing))
+      return;
+
+    TimeSyncPing ping;
+    memcpy(&ping, pCharacteristic->getData(), sizeof(ping));
+
+    TimeSyncEcho echo;
+    echo.version = TIME_SYNC_PROTOCOL_VERSION;
+    echo.sequence = ping.sequence;
+    echo.receiveUs = receiveUs;
+    echo.transmitUs = esp_timer_get_time();
+    pCharacteristic->setValue(reinterpret_cast<uint8_t *>(&echo), sizeof(echo));
+    pCharacteristic->notify();
+  }
+};
+
 class ServerCallbacks : public BLEServerCallbacks
 {
   void onConnect(BLEServer *server) override
   {
     deviceConnected = true;
     connectionChanged = true;
+    requestedStreamFormat = StreamFormat::FLOAT32;
     Logger::info(MODULE_NAME, "Device connected");
-    delay(Config::Timing::POST_CONNECT_DELAY);
+  }
+
+  void onConnect(BLEServer *server, esp_ble_gatts_cb_param_t *param) override
+  {
+    linkManager.onConnect(param);
+  }
+
+  void onMtuChanged(BLEServer *server, esp_ble_gatts_cb_param_t *param) override
+  {
+    linkManager.onMtuChanged(param->mtu.mtu);
   }
 
   void onDisconnect(BLEServer *server) override
   {
     deviceConnected = false;
     connectionChanged = true;
+    linkManager.onDisconnect();
     Logger::info(MODULE_NAME, "Device disconnected");
 
     if (pAccCharacteristic)
@@ -105,45 +346,14 @@ class ServerCallbacks : public BLEServerCallbacks
     if (pCalibCharacteristic)
       pCalibCharacteristic->notify();
 
-    delay(Config::Timing::POST_DISCONNECT_DELAY);
+    // The display follows from the comms task through connectionChanged
     server->getAdvertising()->start();
-    deviceDisplay.updateDisplayStatus(false, false);
   }
 };
 
-Error configureIMU()
+void gapEventHandler(esp_gap_ble_cb_event_t event, esp_ble_gap_cb_param_t *param)
 {
-  auto imu = M5.Imu.getImuInstancePtr(0);
-  if (!imu)
-  {
-    return Error(Error::Code::IMU_INIT_FAILED, "Failed to get IMU instance");
-  }
-
-  // Configure gyroscope
-  uint8_t gyroConfig = imu->readRegister8(Config::IMU::Registers::GYRO_CONFIG);
-  gyroConfig &= ~(0x3 << 3); // Clear FS_SEL bits
-  gyroConfig |= (Config::IMU::Values::GYRO_FS_250DPS << 3);
-  gyroConfig &= ~(0x3); // Enable DLPF
-  imu->writeRegister8(Config::IMU::Registers::GYRO_CONFIG, gyroConfig);
-
-  // Configure accelerometer
-  uint8_t accConfig = imu->readRegister8(Config::IMU::Registers::ACCEL_CONFIG);
-  accConfig &= ~(0x3 << 3);
-  accConfig |= (Config::IMU::Values::ACCEL_FS_8G << 3);
-  imu->writeRegister8(Config::IMU::Registers::ACCEL_CONFIG, accConfig);
-
-  // Configure DLPF
-  uint8_t config = imu->readRegister8(Config::IMU::Registers::DLPF_CONFIG);
-  config &= ~(0x7);
-  config |= Config::IMU::Values::DLPF_20HZ;
-  imu->writeRegister8(Config::IMU::Registers::DLPF_CONFIG, config);
-
-  // Set sample rate
-  imu->writeRegister8(Config::IMU::Registers::SAMPLE_RATE_DIV,
-                      Config::IMU::Values::SAMPLE_RATE_100HZ);
-
-  Logger::info(MODULE_NAME, "IMU configuration completed");
-  return Error(Error::Code::NONE, "Success");
+  linkManager.onGapEvent(event, param);
 }
 
 Error initBLE()
@@ -151,6 +361,7 @@ Error initBLE()
   try
   {
     BLEDevice::init(Config::BLE::DEVICE_NAME);
+    BLEDevice::setCustomGapHandler(gapEventHandler);
     Logger::logf(Logger::Level::INFO, MODULE_NAME, "Device initialized as %s",
                  Config::BLE::DEVICE_NAME);
 
@@ -161,7 +372,7 @@ Error initBLE()
     }
     pServer->setCallbacks(new ServerCallbacks());
 
-    auto *pService = pServer->createService(Config::BLE::SERVICE_UUID);
+    auto *pService = pServer->createService(BLEUUID(Config::BLE::SERVICE_UUID), Config::BLE::SERVICE_HANDLES, 0);
     if (!pService)
     {
       return Error(Error::Code::BLE_INIT_FAILED, "Failed to create service");
@@ -171,13 +382,59 @@ Error initBLE()
     pAccCharacteristic.reset(pService->createCharacteristic(
         Config::BLE::CHAR_ACC_UUID,
         BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_NOTIFY));
-    pAccCharacteristic->addDescriptor(new BLE2902());
+    pAccNotifyDescriptor = new BLE2902();
+    pAccCharacteristic->addDescriptor(pAccNotifyDescriptor);
 
     // Create gyroscope characteristic
     pGyrCharacteristic.reset(pService->createCharacteristic(
         Config::BLE::CHAR_GYR_UUID,
         BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_NOTIFY));
-    pGyrCharacteristic->addDescriptor(new BLE2902());
+    pGyrNotifyDescriptor = new BLE2902();
+    pGyrCharacteristic->addDescriptor(pGyrNotifyDescriptor);
+
+    // Create batched stream characteristic
+    pStreamCharacteristic.reset(pService->createCharacteristic(
+        Config::BLE::CHAR_STREAM_UUID,
+        BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_NOTIFY));
+    pStreamNotifyDescriptor = new BLE2902();
+    pStreamCharacteristic->addDescriptor(pStreamNotifyDescriptor);
+
+    // Create recording characteristic, acknowledgements use write without response
+    pRecordCharacteristic.reset(pService->createCharacteristic(
+        Config::BLE::CHAR_RECORD_UUID,
+        BLECharacteristic::PROPERTY_WRITE |
+            BLECharacteristic::PROPERTY_WRITE_NR |
+            BLECharacteristic::PROPERTY_NOTIFY));
+    pRecordCharacteristic->addDescriptor(new BLE2902());
+    pRecordCharacteristic->setCallbacks(new RecordCallback());
+
+    // Create rep summary characteristic
+    pRepCharacteristic.reset(pService->createCharacteristic(
+        Config::BLE::CHAR_REP_UUID,
+        BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_NOTIFY));
+    pRepNotifyDescriptor = new BLE2902();
+    pRepCharacteristic->addDescriptor(pRepNotifyDescriptor);
+
+    // Create link parameters characteristic
+    pLinkCharacteristic.reset(pService->createCharacteristic(
+        Config::BLE::CHAR_LINK_UUID,
+        BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_NOTIFY));
+    pLinkNotifyDescriptor = new BLE2902();
+    pLinkCharacteristic->addDescriptor(pLinkNotifyDescriptor);
+    linkManager.begin(pServer.get(), pLinkCharacteristic.get(), pLinkNotifyDescriptor);
+
+    // Create perf characteristic, filled in on read
+    pPerfCharacteristic.reset(pService->createCharacteristic(
+        Config::BLE::CHAR_PERF_UUID,
+        BLECharacteristic::PROPERTY_READ | BLECharacteristic::PROPERTY_WRITE));
+    pPerfCharacteristic->setCallbacks(new PerfCallback());
+
+    // Create time sync characteristic, pings use write without response
+    pTimeCharacteristic.reset(pService->createCharacteristic(
+        Config::BLE::CHAR_TIME_UUID,
+        BLECharacteristic::PROPERTY_WRITE_NR | BLECharacteristic::PROPERTY_NOTIFY));
+    pTimeCharacteristic->addDescriptor(new BLE2902());
+    pTimeCharacteristic->setCallbacks(new TimeSyncCallback());
 
     // Create calibration characteristic
     pCalibCharacteristic.reset(pService->createCharacteristic(
@@ -193,7 +450,8 @@ Error initBLE()
     pCalibCharacteristic->addDescriptor(descriptor);
     pCalibCharacteristic->setCallbacks(new CalibrationCallback());
 
-    setupCalibration.reset(new SetupCalibration(pCalibCharacteristic.get(), deviceDisplay));
+    setupCalibration.reset(new SetupCalibration(pCalibCharacteristic.get(), deviceDisplay, calibrationStore,
+                                                sensorCorrection));
 
     pService->start();
     pServer->getAdvertising()->start();
@@ -207,6 +465,19 @@ Error initBLE()
   }
 }
 
+void sendSensorData(const ImuSample &sample)
+{
+  uint32_t timestamp = static_cast<uint32_t>(sample.timestampUs / 1000);
+
+  SensorPacket accPacket{sample.accel.x, sample.accel.y, sample.accel.z, timestamp};
+  pAccCharacteristic->setValue(reinterpret_cast<uint8_t *>(&accPacket), sizeof(SensorPacket));
+  pAccCharacteristic->notify();
+
+  SensorPacket gyrPacket{sample.gyro.x, sample.gyro.y, sample.gyro.z, timestamp};
+  pGyrCharacteristic->setValue(reinterpret_cast<uint8_t *>(&gyrPacket), sizeof(SensorPacket));
+  pGyrCharacteristic->notify();
+}
+
 void handleButton()
 {
   deviceDisplay.wakeDisplay();
@@ -230,47 +501,296 @@ void handleButton()
   }
 }
 
-void setup()
+void toggleRecording()
 {
-  Serial.begin(115200);
-  delay(1000);
+  if (sessionRecorder.isRecording())
+  {
+    sessionRecorder.stop();
+  }
+  else
+  {
+    Error error = sessionRecorder.start();
+    if (error.isError())
+    {
+      Logger::error(MODULE_NAME, error.message());
+    }
+  }
+}
 
-  M5.begin();
-  Logger::info(MODULE_NAME, "M5 initialization completed");
+/**
+ * @brief Whether a client subscribed to the stream and the MTU can carry it
+ */
+bool streamUsable()
+{
+  return deviceConnected && pStreamNotifyDescriptor->getNotifications() && sampleBatcher.canStream();
+}
 
-  deviceDisplay.begin();
+void sendStreamSessionHeader()
+{
+  CalibrationData calib = sensorCorrection.data();
+
+  StreamSessionHeader header;
+  header.type = StreamFormat::SESSION_HEADER;
+  header.version = STREAM_PROTOCOL_VERSION;
+  header.sampleFormat = sampleBatcher.format();
+  header.calibrationValid = calib.isValid ? 1 : 0;
+  header.accelLsbPerG = profileSettings(streamProfile).accelLsbPerG;
+  header.gyroLsbPerDps = profileSettings(streamProfile).gyroLsbPerDps;
+  // Summary of the accel model; exact for the quick calibration
+  header.accelScale = calib.accelMatrix.trace() / 3.0f;
+  header.accelBias[0] = -calib.accelOffset.x;
+  header.accelBias[1] = -calib.accelOffset.y;
+  header.accelBias[2] = -calib.accelOffset.z;
+  header.gyroBias[0] = calib.gyroBias.x;
+  header.gyroBias[1] = calib.gyroBias.y;
+  header.gyroBias[2] = calib.gyroBias.z;
+  header.profile = static_cast<uint8_t>(streamProfile);
+  header.role = static_cast<uint8_t>(unitIdentity.role());
+  header.unitId = unitIdentity.unitId();
+
+  // Frames already batched belong to the previous session
+  sampleBatcher.flush();
+  streamSink.sendFrame(reinterpret_cast<uint8_t *>(&header), sizeof(header));
+}
 
-  if (!M5.Imu.begin())
+/**
+ * @brief Tags stream frames with the unit and tunes the link for sharing the phone
+ */
+void applyUnitRole()
+{
+  sampleBatcher.setUnitTag(unitIdentity.frameTag());
+  powerManager.setSharedLink(unitIdentity.role() != UnitRole::SOLO);
+}
+
+/**
+ * @brief Applies format requests and sends a session header when needed
+ *
+ * A header goes out when a client subscribes to the stream, when the MTU
+ * becomes large enough to stream, when the sample format changes, when the
+ * calibration changes and when the unit role changes.
+ */
+void updateStreamSession()
+{
+  static bool streamActive = false;
+  static uint32_t headerGeneration = 0;
+
+  bool headerNeeded = false;
+  StreamFormat format = requestedStreamFormat;
+  if (format != sampleBatcher.format())
   {
-    Logger::error(MODULE_NAME, "IMU initialization failed");
-    while (true)
-      delay(1000);
+    sampleBatcher.setFormat(format);
+    headerNeeded = true;
   }
 
-  Error imuError = configureIMU();
-  if (imuError.isError())
+  // Checked after the format, which sets the frame size needed; the header
+  // also goes out once a larger MTU makes a subscribed stream usable
+  bool subscribed = streamUsable();
+  headerNeeded = headerNeeded || (subscribed && !streamActive);
+  streamActive = subscribed;
+
+  if (unitIdentity.applyPending())
   {
-    Logger::error(MODULE_NAME, imuError.message());
-    while (true)
-      delay(1000);
+    applyUnitRole();
+    headerNeeded = true;
   }
 
-  Error bleError = initBLE();
-  if (bleError.isError())
+  uint32_t generation = sensorCorrection.generation();
+  if (generation != headerGeneration)
   {
-    Logger::error(MODULE_NAME, bleError.message());
-    while (true)
-      delay(1000);
+    headerGeneration = generation;
+    headerNeeded = true;
   }
 
-  deviceDisplay.updateDisplayStatus(false, false);
+  if (subscribed && headerNeeded)
+  {
+    sendStreamSessionHeader();
+  }
 }
 
-void loop()
+void logPipelineStats()
+{
+  Logger::logf(Logger::Level::INFO, MODULE_NAME,
+               "Ring: depth %u/%u, high-water %u, overflows %lu, FIFO overflows %lu, FIFO dropped %lu",
+               static_cast<unsigned>(sampleRing.size()),
+               static_cast<unsigned>(SampleRing::capacity()),
+               static_cast<unsigned>(sampleRing.highWaterMark()),
+               static_cast<unsigned long>(sampleRing.overflowCount()),
+               static_cast<unsigned long>(imuSampler.overflowCount()),
+               static_cast<unsigned long>(imuSampler.droppedSamples()));
+
+  if (sessionRecorder.hasStorage())
+  {
+    Logger::logf(Logger::Level::INFO, MODULE_NAME,
+                 "Recording: %s, %u sessions, %lu/%lu bytes, %lu frames resent",
+                 sessionRecorder.isRecording() ? "on" : "off",
+                 static_cast<unsigned>(sessionRecorder.sessionCount()),
+                 static_cast<unsigned long>(sessionRecorder.usedBytes()),
+                 static_cast<unsigned long>(sessionRecorder.capacityBytes()),
+                 static_cast<unsigned long>(recordingTransfer.resentFrames()));
+  }
+
+  Logger::logf(Logger::Level::INFO, MODULE_NAME, "Temperature model: %u bins learned",
+               static_cast<unsigned>(sensorCorrection.temperatureBins()));
+
+  PerfTimerStats read = PerfCounters::stats(PerfTimerId::IMU_READ);
+  PerfTimerStats notify = PerfCounters::stats(PerfTimerId::NOTIFY);
+  PerfTimerStats loop = PerfCounters::stats(PerfTimerId::COMMS_PERIOD);
+  Logger::logf(Logger::Level::INFO, MODULE_NAME,
+               "Perf: IMU read max %lu us, notify max %lu us, comms period max %lu us, heap %lu",
+               static_cast<unsigned long>(read.maxUs), static_cast<unsigned long>(notify.maxUs),
+               static_cast<unsigned long>(loop.maxUs), static_cast<unsigned long>(ESP.getFreeHeap()));
+
+  const StreamStats &stream = sampleBatcher.stats();
+  if (stream.refused > 0)
+  {
+    Logger::logf(Logger::Level::INFO, MODULE_NAME, "Stream: %lu samples refused, MTU too small",
+                 static_cast<unsigned long>(stream.refused));
+  }
+  if (stream.samples > 0)
+  {
+    Logger::logf(Logger::Level::INFO, MODULE_NAME,
+                 "Stream: format %d, %lu frames, %lu samples, %.2f bytes/sample, ratio %.2fx vs float32",
+                 static_cast<int>(sampleBatcher.format()),
+                 static_cast<unsigned long>(stream.frames),
+                 static_cast<unsigned long>(stream.samples),
+                 static_cast<float>(stream.bytes) / stream.samples,
+                 stream.compressionRatio());
+  }
+}
+
+/**
+ * @brief Follows a profile switch in order with the samples
+ *
+ * Frames batched so far keep the old scale; subscribers get a new session
+ * header before the first sample of the new profile.
+ */
+void applyStreamProfile(AcquisitionProfile profile)
+{
+  const ProfileSettings &settings = profileSettings(profile);
+  streamProfile = profile;
+
+  sampleBatcher.setScale(settings.accelLsbPerG, settings.gyroLsbPerDps);
+  sessionRecorder.setScale(settings.accelLsbPerG, settings.gyroLsbPerDps);
+
+  if (streamUsable())
+  {
+    sendStreamSessionHeader();
+  }
+}
+
+/**
+ * @brief Logs a completed rep and notifies it to a subscribed client
+ *
+ * The value is also kept for reads, so a client can fetch the last rep
+ * after subscribing.
+ */
+void publishRep(const RepMetrics &rep)
+{
+  Logger::logf(Logger::Level::INFO, MODULE_NAME,
+               "Rep %u: mean %.2f m/s, peak %.2f m/s, ROM %.2f m, concentric %lu ms",
+               static_cast<unsigned>(rep.repNumber), rep.meanConcentricVelocity,
+               rep.peakConcentricVelocity, rep.rangeOfMotion,
+               static_cast<unsigned long>(rep.concentricMs));
+
+  setTracker.addRep(rep);
+  deviceDisplay.showRep(setTracker.repsInSet(), rep.peakConcentricVelocity,
+                        rep.meanConcentricVelocity, setTracker.velocityLoss());
+
+  RepSummaryPacket packet = encodeRepSummary(rep);
+  pRepCharacteristic->setValue(reinterpret_cast<uint8_t *>(&packet), sizeof(packet));
+  if (deviceConnected && pRepNotifyDescriptor->getNotifications())
+  {
+    ScopedPerfTimer timer(PerfTimerId::NOTIFY);
+    pRepCharacteristic->notify();
+  }
+}
+
+void processSamples()
+{
+  // Always consume so the ring only fills up when this task falls behind
+  CorrectedSample sample;
+  while (sampleRing.pop(sample))
+  {
+    if (sample.profile != streamProfile)
+    {
+      applyStreamProfile(sample.profile);
+    }
+    uint32_t periodUs = profileSettings(sample.profile).samplePeriodUs();
+
+    if (setupCalibration->isCalibrationInProgress())
+    {
+      // Calibration needs raw readings; skip samples corrected before it started
+      if (!sample.isCorrected)
+      {
+        setupCalibration->processCalibration(sample.imu);
+      }
+      // Reps are counted from scratch once the new calibration applies
+      velocityIntegrator.reset();
+      repDetector.reset();
+      setTracker.reset();
+      continue;
+    }
+
+    sessionRecorder.record(sample, periodUs);
+
+    bool segmentEnded;
+    {
+      ScopedPerfTimer timer(PerfTimerId::INTEGRATION);
+      segmentEnded = velocityIntegrator.update(sample, periodUs);
+    }
+    if (velocityIntegrator.isStill() && sample.isCorrected)
+    {
+      sensorCorrection.learnTemperatureBias(sample.imu.temperature, sample.gyroResidual);
+    }
+
+    if (segmentEnded)
+    {
+      const VelocitySegment &segment = velocityIntegrator.segment();
+      if (segment.truncated)
+      {
+        Logger::info(MODULE_NAME, "Motion outlasted the velocity history, later reps are missed");
+      }
+
+      RepMetrics reps[Config::RepDetection::MAX_REPS_PER_SEGMENT];
+      size_t count;
+      {
+        ScopedPerfTimer timer(PerfTimerId::REP_DETECTION);
+        count = repDetector.analyze(segment, reps, Config::RepDetection::MAX_REPS_PER_SEGMENT);
+      }
+      for (size_t i = 0; i < count; i++)
+      {
+        publishRep(reps[i]);
+      }
+    }
+
+    if (deviceConnected)
+    {
+      if (pStreamNotifyDescriptor->getNotifications())
+      {
+        sampleBatcher.add(sample, periodUs);
+      }
+
+      // Per-axis characteristics are kept for app builds without stream support
+      if (pAccNotifyDescriptor->getNotifications() || pGyrNotifyDescriptor->getNotifications())
+      {
+        sendSensorData(sample.imu);
+      }
+    }
+  }
+
+  sampleBatcher.flushIfStale(millis());
+}
+
+void commsLoop()
 {
   static uint32_t lastConnectionCheck = 0;
-  static uint32_t lastUpdate = 0;
+  static uint32_t lastStatsLog = 0;
+  static bool wasConnected = false;
+  static uint16_t appliedMtu = Config::Stream::DEFAULT_MTU;
+  static bool wasRecording = false;
+  static uint32_t lastVelocityUpdate = 0;
   uint32_t currentTime = millis();
+  PerfCounters::mark(PerfTimerId::COMMS_PERIOD);
 
   M5.update();
 
@@ -279,43 +799,173 @@ void loop()
     handleButton();
   }
 
+  // Long press: standalone rep readout for training without the phone
+  if (M5.BtnA.wasHold())
+  {
+    deviceDisplay.setStandalone(!deviceDisplay.isStandalone());
+  }
+
+  if (M5.BtnB.wasPressed())
+  {
+    deviceDisplay.wakeDisplay();
+    toggleRecording();
+  }
+
   deviceDisplay.manageDisplayState();
 
+  powerManager.update(velocityIntegrator.isStill(),
+                      setupCalibration->isCalibrationInProgress() || sessionRecorder.isRecording(),
+                      deviceConnected);
+
+  if (currentTime - lastVelocityUpdate >= Config::Display::VELOCITY_UPDATE_INTERVAL &&
+      !setupCalibration->isCalibrationInProgress())
+  {
+    deviceDisplay.updateVelocity(velocityIntegrator.velocity());
+    lastVelocityUpdate = currentTime;
+  }
+
+  // Recording may also be toggled over BLE or stop when storage runs out
+  if (sessionRecorder.isRecording() != wasRecording)
+  {
+    wasRecording = sessionRecorder.isRecording();
+    deviceDisplay.updateDisplayStatus(deviceConnected, wasRecording);
+  }
+
   // Verify connection state and update display on change
   if (currentTime - lastConnectionCheck >= Config::Timing::CONNECTION_CHECK_INTERVAL && connectionChanged)
   {
     Logger::logf(Logger::Level::INFO, MODULE_NAME, "Connection state: %s",
                  deviceConnected ? "connected" : "disconnected");
-    deviceDisplay.updateDisplayStatus(deviceConnected, false);
+    deviceDisplay.updateDisplayStatus(deviceConnected, sessionRecorder.isRecording());
     lastConnectionCheck = currentTime;
     connectionChanged = false;
   }
 
-  if (setupCalibration && setupCalibration->isCalibrationInProgress())
+  // Start every connection with a fresh frame sequence
+  if (deviceConnected != wasConnected)
   {
-    setupCalibration->processCalibration();
-    delay(10);
-    return;
+    wasConnected = deviceConnected;
+    appliedMtu = Config::Stream::DEFAULT_MTU;
+    sampleBatcher.setMtu(appliedMtu);
+    sampleBatcher.reset();
+    recordingTransfer.setMtu(appliedMtu);
+    recordingTransfer.reset();
+    repDetector.reset();
   }
 
-  // Process and send sensor data when connected to app
-  if (deviceConnected && currentTime - lastUpdate >= Config::Timing::SENSOR_UPDATE_INTERVAL)
+  linkManager.update();
+  uint16_t linkMtu = linkManager.mtu();
+  if (deviceConnected && linkMtu != appliedMtu)
   {
-    Vector3D rawAccel, rawGyro;
-    M5.Imu.getAccelData(&rawAccel.x, &rawAccel.y, &rawAccel.z);
-    M5.Imu.getGyroData(&rawGyro.x, &rawGyro.y, &rawGyro.z);
+    appliedMtu = linkMtu;
+    sampleBatcher.setMtu(appliedMtu);
+    recordingTransfer.setMtu(appliedMtu);
+  }
+
+  updateStreamSession();
+  processSamples();
+  recordingTransfer.process(currentTime);
+
+  if (currentTime - lastStatsLog >= Config::Tasks::STATS_LOG_INTERVAL)
+  {
+    logPipelineStats();
+    lastStatsLog = currentTime;
+  }
+}
+
+void commsTask(void *param)
+{
+  while (true)
+  {
+    commsLoop();
+    vTaskDelay(pdMS_TO_TICKS(Config::Tasks::COMMS_INTERVAL));
+  }
+}
+
+void setup()
+{
+  Serial.begin(115200);
+  delay(1000);
+
+  Error loggerError = Logger::begin();
+  if (loggerError.isError())
+  {
+    Serial.println(loggerError.message());
+  }
+
+  M5.begin();
+  Logger::info(MODULE_NAME, "M5 initialization completed");
+
+  deviceDisplay.begin();
+
+  if (!M5.Imu.begin())
+  {
+    Logger::error(MODULE_NAME, "IMU initialization failed");
+    while (true)
+      delay(1000);
+  }
+
+  Error samplerError = imuSampler.begin(DEFAULT_ACQUISITION_PROFILE);
+  if (samplerError.isError())
+  {
+    Logger::error(MODULE_NAME, samplerError.message());
+    while (true)
+      delay(1000);
+  }
 
-    CorrectedData data = setupCalibration->correctSensorData(rawAccel, rawGyro);
+  // Recording is optional, the device still streams without PSRAM
+  Error recorderError = sessionRecorder.begin();
+  if (recorderError.isError())
+  {
+    Logger::error(MODULE_NAME, recorderError.message());
+  }
 
-    // Send sensor data packets
-    SensorPacket accPacket{data.accel.x, data.accel.y, data.accel.z, currentTime};
-    pAccCharacteristic->setValue(reinterpret_cast<uint8_t *>(&accPacket), sizeof(SensorPacket));
-    pAccCharacteristic->notify();
+  // Stored coefficients make the device ready without recalibrating
+  CalibrationData storedCalibration;
+  Error storeError = calibrationStore.load(storedCalibration);
+  if (storeError.isError())
+  {
+    Logger::info(MODULE_NAME, storeError.message());
+  }
 
-    SensorPacket gyrPacket{data.gyro.x, data.gyro.y, data.gyro.z, currentTime};
-    pGyrCharacteristic->setValue(reinterpret_cast<uint8_t *>(&gyrPacket), sizeof(SensorPacket));
-    pGyrCharacteristic->notify();
+  unitIdentity.begin();
+  applyUnitRole();
 
-    lastUpdate = currentTime;
+  Error bleError = initBLE();
+  if (bleError.isError())
+  {
+    Logger::error(MODULE_NAME, bleError.message());
+    while (true)
+      delay(1000);
   }
-}
\ No newline at end of file
+
+  if (storedCalibration.isValid)
+  {
+    setupCalibration->restoreCalibration(storedCalibration);
+  }
+
+  Error taskError = sensorTask.start();
+  if (taskError.isError())
+  {
+    Logger::error(MODULE_NAME, taskError.message());
+    while (true)
+      delay(1000);
+  }
+  powerManager.begin();
+
+  if (xTaskCreatePinnedToCore(commsTask, "comms", Config::Tasks::COMMS_STACK_SIZE, nullptr,
+                              Config::Tasks::COMMS_PRIORITY, nullptr, Config::Tasks::COMMS_CORE) != pdPASS)
+  {
+    Logger::error(MODULE_NAME, "Failed to create comms task");
+    while (true)
+      delay(1000);
+  }
+
+  deviceDisplay.updateDisplayStatus(false, false);
+}
+
+void loop()
+{
+  // All work runs in the sensor and comms tasks
+  vTaskDelete(nullptr);
+}
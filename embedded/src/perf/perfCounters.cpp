@@ -0,0 +1,88 @@
+#include "perfCounters.h"
+
+constexpr char PerfCounters::MODULE_NAME[];
+
+PerfTimerStats PerfCounters::timers[static_cast<size_t>(PerfTimerId::COUNT)] = {};
+uint64_t PerfCounters::lastMarkUs[static_cast<size_t>(PerfTimerId::COUNT)] = {};
+portMUX_TYPE PerfCounters::perfMux = portMUX_INITIALIZER_UNLOCKED;
+
+namespace
+{
+    // Bucket i holds durations below 16 * 4^i µs
+    inline size_t histogramBucket(uint32_t durationUs)
+    {
+        int bits = 32 - __builtin_clz(durationUs | 1);
+        size_t bucket = bits > 4 ? static_cast<size_t>(bits - 3) / 2 : 0;
+        return bucket < PERF_HISTOGRAM_BUCKETS ? bucket : PERF_HISTOGRAM_BUCKETS - 1;
+    }
+}
+
+void PerfCounters::record(PerfTimerId id, uint32_t durationUs)
+{
+    if (!Config::Perf::ENABLED)
+        return;
+
+    size_t bucket = histogramBucket(durationUs);
+    PerfTimerStats &timer = timers[static_cast<size_t>(id)];
+
+    portENTER_CRITICAL(&perfMux);
+    if (timer.count == 0 || durationUs < timer.minUs)
+        timer.minUs = durationUs;
+    if (durationUs > timer.maxUs)
+        timer.maxUs = durationUs;
+    timer.count++;
+    timer.totalUs += durationUs;
+    timer.histogram[bucket]++;
+    portEXIT_CRITICAL(&perfMux);
+}
+
+void PerfCounters::mark(PerfTimerId id)
+{
+    if (!Config::Perf::ENABLED)
+        return;
+
+    uint64_t now = esp_timer_get_time();
+    uint64_t &last = lastMarkUs[static_cast<size_t>(id)];
+    if (last != 0)
+    {
+        record(id, static_cast<uint32_t>(now - last));
+    }
+    last = now;
+}
+
+PerfTimerStats PerfCounters::stats(PerfTimerId id)
+{
+    portENTER_CRITICAL(&perfMux);
+    PerfTimerStats copy = timers[static_cast<size_t>(id)];
+    portEXIT_CRITICAL(&perfMux);
+    return copy;
+}
+
+void PerfCounters::reset()
+{
+    portENTER_CRITICAL(&perfMux);
+    for (auto &timer : timers)
+    {
+        timer = PerfTimerStats{};
+    }
+    portEXIT_CRITICAL(&perfMux);
+}
+
+void PerfCounters::encode(PerfStatsPacket &packet)
+{
+    packet.timerCount = static_cast<uint8_t>(PerfTimerId::COUNT);
+    for (size_t i = 0; i < static_cast<size_t>(PerfTimerId::COUNT); i++)
+    {
+        PerfTimerStats timer = stats(static_cast<PerfTimerId>(i));
+        PerfTimerPacket &out = packet.timers[i];
+        out.count = timer.count;
+        out.meanUs = timer.count > 0 ? static_cast<uint32_t>(timer.totalUs / timer.count) : 0;
+        out.minUs = timer.minUs;
+        out.maxUs = timer.maxUs;
+        for (size_t b = 0; b < PERF_HISTOGRAM_BUCKETS; b++)
+        {
+            out.histogram[b] = static_cast<uint16_t>(timer.histogram[b] < UINT16_MAX ? timer.histogram[b]
+                                                                                     : UINT16_MAX);
+        }
+    }
+}
@@ -0,0 +1,73 @@
+#pragma once
+#include <Arduino.h>
+#include <esp_timer.h>
+#include "config/config.h"
+#include "perf/perfProtocol.h"
+
+/**
+ * @brief Duration statistics of one instrumented code path
+ */
+struct PerfTimerStats
+{
+    uint32_t count;
+    uint64_t totalUs;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint32_t histogram[PERF_HISTOGRAM_BUCKETS];
+};
+
+/**
+ * @brief Always-on min/max/histogram timers for the hot paths
+ *
+ * Timing uses esp_timer_get_time() for microsecond resolution. A record is
+ * a handful of adds inside a short critical section, so the timers stay
+ * enabled in production builds; Config::Perf::ENABLED compiles them out.
+ *
+ * Each timer is meant to be recorded from a single task; snapshots may be
+ * taken from any task.
+ */
+class PerfCounters
+{
+public:
+    static constexpr char MODULE_NAME[] = "PERF";
+
+    static void record(PerfTimerId id, uint32_t durationUs);
+
+    /**
+     * @brief Records the time since the previous mark of the same timer
+     *
+     * Used for loop periods; the first mark only sets the reference.
+     */
+    static void mark(PerfTimerId id);
+
+    static PerfTimerStats stats(PerfTimerId id);
+
+    static void reset();
+
+    /**
+     * @brief Fills the timer part of the perf characteristic
+     */
+    static void encode(PerfStatsPacket &packet);
+
+private:
+    static PerfTimerStats timers[static_cast<size_t>(PerfTimerId::COUNT)];
+    static uint64_t lastMarkUs[static_cast<size_t>(PerfTimerId::COUNT)];
+    static portMUX_TYPE perfMux;
+};
+
+/**
+ * @brief Records the lifetime of the scope into a timer
+ */
+class ScopedPerfTimer
+{
+public:
+    explicit ScopedPerfTimer(PerfTimerId id) : id(id), startUs(esp_timer_get_time()) {}
+    ~ScopedPerfTimer() { PerfCounters::record(id, static_cast<uint32_t>(esp_timer_get_time() - startUs)); }
+
+    ScopedPerfTimer(const ScopedPerfTimer &) = delete;
+    ScopedPerfTimer &operator=(const ScopedPerfTimer &) = delete;
+
+private:
+    PerfTimerId id;
+    int64_t startUs;
+};
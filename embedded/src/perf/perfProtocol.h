@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+
+static constexpr uint8_t PERF_PROTOCOL_VERSION = 1;
+static constexpr uint8_t PERF_HISTOGRAM_BUCKETS = 8;
+
+/**
+ * @brief Wire format of one timer in the perf characteristic
+ *
+ * Bucket i counts durations below 16 * 4^i µs (16 µs, 64 µs, ... 65 ms);
+ * the last bucket also takes everything longer. Buckets saturate at 65535.
+ */
+struct __attribute__((packed)) PerfTimerPacket
+{
+    uint32_t count;
+    uint32_t meanUs;
+    uint32_t minUs;
+    uint32_t maxUs;
+    uint16_t histogram[PERF_HISTOGRAM_BUCKETS];
+};
+
+/**
+ * @brief Timer order in PerfStatsPacket::timers
+ */
+enum class PerfTimerId : uint8_t
+{
+    IMU_READ = 0,      // FIFO drain over I2C
+    CORRECTION = 1,    // Batch calibration
+    FUSION = 2,        // Orientation filter over the batch
+    NOTIFY = 3,        // Stream and rep notifications
+    SENSOR_PERIOD = 4, // Between sensor task drains
+    COMMS_PERIOD = 5,  // Between comms loop iterations
+    INTEGRATION = 6,   // Velocity integration of one sample
+    REP_DETECTION = 7, // Rep search over a finished motion segment
+    COUNT
+};
+
+/**
+ * @brief Wire format of the perf characteristic
+ *
+ * Built when the characteristic is read; writing any value resets the
+ * timers. Longer than one ATT MTU, so clients fetch it with a long read.
+ * Timers are appended at the end, timerCount tells how many there are. All
+ * fields are little-endian.
+ */
+struct __attribute__((packed)) PerfStatsPacket
+{
+    uint8_t version;
+    uint8_t timerCount;
+    uint32_t uptimeMs;
+    uint32_t fifoDropped;    // Samples lost to IMU FIFO overflows
+    uint32_t fifoOverflows;
+    uint32_t ringOverflows;  // Samples the comms task did not consume in time
+    uint16_t ringHighWater;
+    uint16_t ringCapacity;
+    uint32_t freeHeap;       // bytes
+    uint32_t minFreeHeap;    // Low-water mark since boot
+    uint32_t freePsram;      // bytes, 0 without PSRAM
+    PerfTimerPacket timers[static_cast<size_t>(PerfTimerId::COUNT)];
+};
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <driver/gpio.h>
+#include <esp_sleep.h>
+#include "powerManager.h"
+
+constexpr char PowerManager::MODULE_NAME[];
+
+PowerManager::PowerManager(SensorTask &sensorTask, DisplayController &display, LinkManager &link) noexcept
+    : sensorTask(sensorTask),
+      display(display),
+      link(link),
+      powerState(PowerState::ACTIVE_SET),
+      selectedProfile(static_cast<uint8_t>(DEFAULT_ACQUISITION_PROFILE)),
+      profileChanged(false),
+      sharedLink(false),
+      linkChanged(false),
+      lastMotion(0),
+      seenWakeups(0)
+{
+}
+
+void PowerManager::begin()
+{
+    lastMotion = millis();
+    sensorTask.attachMotionInterrupt(Config::Power::IMU_INT_PIN);
+    setCpuFrequencyMhz(Config::Power::ACTIVE_CPU_MHZ);
+    applyConnectionParams();
+}
+
+void PowerManager::setSelectedProfile(AcquisitionProfile profile)
+{
+    selectedProfile.store(static_cast<uint8_t>(profile), std::memory_order_relaxed);
+    profileChanged.store(true, std::memory_order_release);
+}
+
+void PowerManager::setSharedLink(bool shared)
+{
+    sharedLink.store(shared, std::memory_order_relaxed);
+    linkChanged.store(true, std::memory_order_release);
+}
+
+void PowerManager::update(bool still, bool busy, bool connected)
+{
+    uint32_t now = millis();
+
+    uint32_t wakeups = sensorTask.motionWakeups();
+    if (!still || busy || wakeups != seenWakeups)
+    {
+        seenWakeups = wakeups;
+        lastMotion = now;
+        if (powerState != PowerState::ACTIVE_SET)
+        {
+            enterActive();
+        }
+    }
+
+    if (profileChanged.exchange(false, std::memory_order_acquire))
+    {
+        auto profile = static_cast<AcquisitionProfile>(selectedProfile.load(std::memory_order_relaxed));
+        if (powerState == PowerState::ACTIVE_SET)
+        {
+            sensorTask.requestProfile(profile);
+            applyConnectionParams();
+        }
+        else
+        {
+            sensorTask.armWakeOnMotion(profile);
+        }
+    }
+
+    if (linkChanged.exchange(false, std::memory_order_acquire) && powerState == PowerState::ACTIVE_SET)
+    {
+        applyConnectionParams();
+    }
+
+    uint32_t stillFor = now - lastMotion;
+    if (powerState == PowerState::ACTIVE_SET && stillFor >= Config::Power::BETWEEN_SETS_AFTER)
+    {
+        enterBetweenSets();
+    }
+    else if (powerState == PowerState::BETWEEN_SETS && !connected && stillFor >= Config::Power::IDLE_AFTER)
+    {
+        enterIdle();
+    }
+}
+
+void PowerManager::enterActive()
+{
+    Logger::info(MODULE_NAME, "Active set");
+    powerState = PowerState::ACTIVE_SET;
+    setCpuFrequencyMhz(Config::Power::ACTIVE_CPU_MHZ);
+    sensorTask.disarmWakeOnMotion();
+    sensorTask.requestProfile(static_cast<AcquisitionProfile>(selectedProfile.load(std::memory_order_relaxed)));
+    applyConnectionParams();
+}
+
+void PowerManager::enterBetweenSets()
+{
+    Logger::info(MODULE_NAME, "Between sets");
+    powerState = PowerState::BETWEEN_SETS;
+    sensorTask.armWakeOnMotion(static_cast<AcquisitionProfile>(selectedProfile.load(std::memory_order_relaxed)));
+    sensorTask.requestProfile(AcquisitionProfile::IDLE);
+    setCpuFrequencyMhz(Config::Power::RESTING_CPU_MHZ);
+    applyConnectionParams();
+}
+
+void PowerManager::enterIdle()
+{
+    Logger::info(MODULE_NAME, "Idle, entering light sleep");
+    powerState = PowerState::IDLE;
+    display.sleepDisplay();
+
+    // The radio does not run in light sleep, so nobody could connect anyway
+    BLEDevice::getAdvertising()->stop();
+
+    const auto imuPin = static_cast<gpio_num_t>(Config::Power::IMU_INT_PIN);
+    const auto buttonPin = static_cast<gpio_num_t>(Config::Power::WAKE_BUTTON_PIN);
+    if (Config::Power::IMU_INT_PIN >= 0)
+    {
+        // Level wakeup replaces the edge interrupt type; keep the ISR quiet meanwhile
+        gpio_intr_disable(imuPin);
+        gpio_wakeup_enable(imuPin, GPIO_INTR_HIGH_LEVEL);
+    }
+    else
+    {
+        esp_sleep_enable_timer_wakeup(static_cast<uint64_t>(Config::Power::IDLE_POLL_INTERVAL) * 1000);
+    }
+    gpio_wakeup_enable(buttonPin, GPIO_INTR_LOW_LEVEL);
+    esp_sleep_enable_gpio_wakeup();
+
+    uint32_t wakeups = sensorTask.motionWakeups();
+    esp_err_t result;
+    while (true)
+    {
+        // Queued lines would otherwise be cut off by the UART clock stopping
+        Logger::flush();
+        result = esp_light_sleep_start();
+        if (result != ESP_OK || esp_sleep_get_wakeup_cause() != ESP_SLEEP_WAKEUP_TIMER)
+            break;
+
+        // Polling wakeup: give the sensor task a drain to find the latched motion flags
+        vTaskDelay(pdMS_TO_TICKS(2 * profileSettings(AcquisitionProfile::IDLE).drainIntervalMs));
+        if (sensorTask.motionWakeups() != wakeups)
+            break;
+    }
+
+    esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_GPIO);
+    gpio_wakeup_disable(buttonPin);
+    if (Config::Power::IMU_INT_PIN >= 0)
+    {
+        gpio_wakeup_disable(imuPin);
+        gpio_set_intr_type(imuPin, GPIO_INTR_POSEDGE);
+        gpio_intr_enable(imuPin);
+    }
+    else
+    {
+        esp_sleep_disable_wakeup_source(ESP_SLEEP_WAKEUP_TIMER);
+    }
+
+    if (result != ESP_OK)
+    {
+        Logger::logf(Logger::Level::ERROR, MODULE_NAME, "Light sleep failed: %s", esp_err_to_name(result));
+    }
+
+    BLEDevice::getAdvertising()->start();
+    display.wakeDisplay();
+
+    // The ISR was off during sleep; hand the wakeup to the sensor task directly
+    sensorTask.notifyMotion();
+    lastMotion = millis();
+    enterActive();
+}
+
+void PowerManager::applyConnectionParams()
+{
+    if (powerState == PowerState::ACTIVE_SET)
+    {
+        const ProfileSettings &settings =
+            profileSettings(static_cast<AcquisitionProfile>(selectedProfile.load(std::memory_order_relaxed)));
+        uint16_t minInterval = settings.minConnInterval;
+        uint16_t maxInterval = settings.maxConnInterval;
+        if (sharedLink.load(std::memory_order_relaxed))
+        {
+            minInterval = std::max<uint16_t>(minInterval * Config::Stream::SHARED_INTERVAL_FACTOR,
+                                             Config::Stream::SHARED_MIN_INTERVAL);
+            maxInterval = std::max<uint16_t>(maxInterval * Config::Stream::SHARED_INTERVAL_FACTOR, minInterval);
+        }
+        link.requestConnectionParams(minInterval, maxInterval, 0, Config::Power::SUPERVISION_TIMEOUT);
+    }
+    else
+    {
+        link.requestConnectionParams(Config::Power::RESTING_MIN_INTERVAL, Config::Power::RESTING_MAX_INTERVAL,
+                                     Config::Power::RESTING_LATENCY, Config::Power::SUPERVISION_TIMEOUT);
+    }
+}
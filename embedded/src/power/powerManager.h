@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include "ble/linkManager.h"
+#include "config/config.h"
+#include "display/displayController.h"
+#include "sensor/acquisitionProfile.h"
+#include "sensor/sensorTask.h"
+#include "utils/logger.h"
+
+enum class PowerState : uint8_t
+{
+    ACTIVE_SET,   // Full rate, full clock, connection interval of the profile
+    BETWEEN_SETS, // Low rate, wake-on-motion armed, reduced clock, long connection interval
+    IDLE          // Light sleep until motion or button A; only while disconnected
+};
+
+/**
+ * @brief Lowers IMU rate, CPU clock and radio duty cycle while the bar rests
+ *
+ * After Config::Power::BETWEEN_SETS_AFTER without motion the sensor task
+ * drops to AcquisitionProfile::IDLE and arms the IMU wake-on-motion
+ * interrupt; the interrupt makes the sensor task restore the selected
+ * profile itself, within one drain. While disconnected, a longer rest
+ * stops advertising and enters light sleep until the IMU or button A pulls
+ * the device out of it. Without the IMU INT line the device wakes every
+ * Config::Power::IDLE_POLL_INTERVAL to let the sensor task read the motion
+ * flags, and sleeps again if there were none.
+ *
+ * Runs on the comms task, except setSelectedProfile which the BLE callbacks
+ * may call.
+ */
+class PowerManager
+{
+public:
+    static constexpr char MODULE_NAME[] = "POWER";
+
+    PowerManager(SensorTask &sensorTask, DisplayController &display, LinkManager &link) noexcept;
+
+    void begin();
+
+    /**
+     * @brief Sets the profile used while active; applied by the next update()
+     */
+    void setSelectedProfile(AcquisitionProfile profile);
+
+    /**
+     * @brief Shares the phone's radio with another unit; applied by the next update()
+     *
+     * Active sets then ask for Config::Stream::SHARED_INTERVAL_FACTOR longer
+     * connection intervals, so both units fit the central's schedule with
+     * fuller connection events.
+     */
+    void setSharedLink(bool shared);
+
+    /**
+     * @brief Advances the power state machine
+     * @param still Whether the ZUPT detector sees the device at rest
+     * @param busy Calibration or recording in progress, which keeps full rate
+     */
+    void update(bool still, bool busy, bool connected);
+
+    [[nodiscard]] PowerState state() const noexcept { return powerState; }
+
+private:
+    SensorTask &sensorTask;
+    DisplayController &display;
+    LinkManager &link;
+    PowerState powerState;
+    std::atomic<uint8_t> selectedProfile;
+    std::atomic<bool> profileChanged;
+    std::atomic<bool> sharedLink;
+    std::atomic<bool> linkChanged;
+    uint32_t lastMotion;
+    uint32_t seenWakeups;
+
+    void enterActive();
+    void enterBetweenSets();
+    void enterIdle();
+    void applyConnectionParams();
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+
+/**
+ * @brief Host stand-ins for the Arduino and FreeRTOS calls used by the
+ * platform-independent modules, for the native replay build only
+ *
+ * Tasks run as detached threads, critical sections are spinlocks and
+ * Serial writes to stderr so reports on stdout stay clean.
+ */
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+
+struct HostSerial
+{
+    explicit operator bool() const { return true; }
+
+    template <typename... Args>
+    int printf(const char *format, Args... args)
+    {
+        return std::fprintf(stderr, format, args...);
+    }
+
+    void println(const char *line) { std::fprintf(stderr, "%s\n", line); }
+};
+
+extern HostSerial Serial;
+
+typedef int BaseType_t;
+typedef unsigned int UBaseType_t;
+typedef uint32_t TickType_t;
+typedef void *TaskHandle_t;
+typedef void (*TaskFunction_t)(void *);
+
+#define pdPASS 1
+#define pdFAIL 0
+#define pdMS_TO_TICKS(ms) (static_cast<TickType_t>(ms))
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *name, uint32_t stackSize,
+                                   void *param, UBaseType_t priority, TaskHandle_t *handle,
+                                   BaseType_t core);
+void vTaskDelay(TickType_t ticks);
+
+struct portMUX_TYPE
+{
+    bool locked;
+};
+
+#define portMUX_INITIALIZER_UNLOCKED {false}
+
+inline void portENTER_CRITICAL(portMUX_TYPE *mux)
+{
+    while (__atomic_test_and_set(&mux->locked, __ATOMIC_ACQUIRE))
+    {
+    }
+}
+
+inline void portEXIT_CRITICAL(portMUX_TYPE *mux)
+{
+    __atomic_clear(&mux->locked, __ATOMIC_RELEASE);
+}
+
+#define IRAM_ATTR
@@ -0,0 +1,7 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief Microseconds since the replay started, steady clock
+ */
+int64_t esp_timer_get_time();
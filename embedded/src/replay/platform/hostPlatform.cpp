@@ -0,0 +1,49 @@
+#include <chrono>
+#include <thread>
+#include "Arduino.h"
+#include "esp_timer.h"
+
+HostSerial Serial;
+
+namespace
+{
+    const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+}
+
+int64_t esp_timer_get_time()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now() - startTime)
+        .count();
+}
+
+uint32_t millis()
+{
+    return static_cast<uint32_t>(esp_timer_get_time() / 1000);
+}
+
+uint32_t micros()
+{
+    return static_cast<uint32_t>(esp_timer_get_time());
+}
+
+void delay(uint32_t ms)
+{
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    delay(ticks);
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t task, const char *, uint32_t, void *param,
+                                   UBaseType_t, TaskHandle_t *handle, BaseType_t)
+{
+    // Only compared against nullptr by the callers
+    static uintptr_t taskCount = 0;
+    std::thread(task, param).detach();
+    if (handle)
+        *handle = reinterpret_cast<TaskHandle_t>(++taskCount);
+    return pdPASS;
+}
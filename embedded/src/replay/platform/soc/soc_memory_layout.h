@@ -0,0 +1,9 @@
+#pragma once
+
+/**
+ * @brief There is no flash mapping on the host; Logger copies every string
+ */
+inline bool esp_ptr_in_drom(const void *)
+{
+    return false;
+}
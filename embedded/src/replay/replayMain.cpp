@@ -0,0 +1,311 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "analysis/repDetector.h"
+#include "calibration/sensorCorrection.h"
+#include "config/config.h"
+#include "integration/velocityIntegrator.h"
+#include "perf/perfCounters.h"
+#include "replay/replaySource.h"
+#include "sensor/samplePipeline.h"
+#include "utils/logger.h"
+
+/**
+ * @brief Host replay of recorded sessions through the firmware DSP pipeline
+ *
+ * Built by the PlatformIO native env:
+ *
+ *   pio run -e native
+ *   .pio/build/native/program session.csv --reference reps.csv
+ *
+ * Runs the same SamplePipeline (correction, fusion), VelocityIntegrator and
+ * RepDetector code as the device. Reports throughput, per-stage latency
+ * from PerfCounters and, given reference velocities (rep,mean,peak in m/s
+ * per line, e.g. from a linear position transducer), the velocity error.
+ *
+ * Exit status: 0 pass, 1 accuracy regression, 2 usage or input error.
+ */
+
+namespace
+{
+    constexpr char MODULE_NAME[] = "REPLAY";
+
+    struct Options
+    {
+        const char *sessionPath = nullptr;
+        const char *referencePath = nullptr;
+        AcquisitionProfile profile = DEFAULT_ACQUISITION_PROFILE;
+        int repeat = 1;
+        float tolerance = 0.05f; // m/s mean absolute error
+        bool hasGyroBias = false;
+        Vector3D gyroBias;
+    };
+
+    struct ReferenceRep
+    {
+        float meanVelocity; // m/s
+        float peakVelocity; // m/s
+    };
+
+    void printUsage()
+    {
+        fprintf(stderr,
+                "usage: program <session.csv|session.bin> [options]\n"
+                "  --profile N          Acquisition profile of a CSV session (default %d)\n"
+                "  --reference FILE     rep,mean,peak velocities in m/s to compare against\n"
+                "  --tolerance V        Max mean absolute velocity error in m/s (default 0.05)\n"
+                "  --repeat N           Replay the session N times for steadier timings\n"
+                "  --gyro-bias X,Y,Z    Apply a calibration with this gyro bias in deg/s\n",
+                static_cast<int>(DEFAULT_ACQUISITION_PROFILE));
+    }
+
+    bool parseOptions(int argc, char **argv, Options &options)
+    {
+        for (int i = 1; i < argc; i++)
+        {
+            const char *arg = argv[i];
+            bool hasValue = i + 1 < argc;
+            if (strcmp(arg, "--profile") == 0 && hasValue)
+            {
+                int value = atoi(argv[++i]);
+                if (value < 0 || !isValidProfile(static_cast<uint8_t>(value)))
+                    return false;
+                options.profile = static_cast<AcquisitionProfile>(value);
+            }
+            else if (strcmp(arg, "--reference") == 0 && hasValue)
+            {
+                options.referencePath = argv[++i];
+            }
+            else if (strcmp(arg, "--tolerance") == 0 && hasValue)
+            {
+                options.tolerance = static_cast<float>(atof(argv[++i]));
+            }
+            else if (strcmp(arg, "--repeat") == 0 && hasValue)
+            {
+                options.repeat = atoi(argv[++i]);
+                if (options.repeat < 1)
+                    return false;
+            }
+            else if (strcmp(arg, "--gyro-bias") == 0 && hasValue)
+            {
+                Vector3D &bias = options.gyroBias;
+                if (sscanf(argv[++i], "%f,%f,%f", &bias.x, &bias.y, &bias.z) != 3)
+                    return false;
+                options.hasGyroBias = true;
+            }
+            else if (arg[0] != '-' && !options.sessionPath)
+            {
+                options.sessionPath = arg;
+            }
+            else
+            {
+                return false;
+            }
+        }
+        return options.sessionPath != nullptr;
+    }
+
+    Error loadReference(const char *path, std::vector<ReferenceRep> &reps)
+    {
+        FILE *file = fopen(path, "r");
+        if (!file)
+        {
+            return Error(Error::Code::IO_ERROR, "Cannot open reference file");
+        }
+
+        char line[128];
+        while (fgets(line, sizeof(line), file))
+        {
+            int rep;
+            ReferenceRep reference;
+            if (sscanf(line, "%d,%f,%f", &rep, &reference.meanVelocity, &reference.peakVelocity) == 3)
+            {
+                reps.push_back(reference);
+            }
+        }
+        fclose(file);
+        return Error(Error::Code::NONE, "Success");
+    }
+
+    void printStage(const char *name, PerfTimerId id)
+    {
+        PerfTimerStats stats = PerfCounters::stats(id);
+        double mean = stats.count > 0 ? static_cast<double>(stats.totalUs) / stats.count : 0.0;
+        printf("  %-14s %9lu %9.2f %8lu %8lu ", name, static_cast<unsigned long>(stats.count), mean,
+               static_cast<unsigned long>(stats.minUs), static_cast<unsigned long>(stats.maxUs));
+        for (size_t b = 0; b < PERF_HISTOGRAM_BUCKETS; b++)
+        {
+            printf(" %7lu", static_cast<unsigned long>(stats.histogram[b]));
+        }
+        printf("\n");
+    }
+
+    /**
+     * @brief Compares detected reps with the reference in order
+     * @return Whether the rep count matches and both errors are within tolerance
+     */
+    bool reportAccuracy(const std::vector<RepMetrics> &detected, const std::vector<ReferenceRep> &reference,
+                        float tolerance)
+    {
+        printf("\nAccuracy: %zu reps detected, %zu in the reference\n", detected.size(), reference.size());
+        printf("  %4s %8s %8s %8s %8s %8s %8s\n", "rep", "mean", "ref", "error", "peak", "ref", "error");
+
+        size_t compared = std::min(detected.size(), reference.size());
+        float meanError = 0.0f;
+        float peakError = 0.0f;
+        for (size_t i = 0; i < compared; i++)
+        {
+            const RepMetrics &rep = detected[i];
+            float mean = rep.meanConcentricVelocity - reference[i].meanVelocity;
+            float peak = rep.peakConcentricVelocity - reference[i].peakVelocity;
+            meanError += std::fabs(mean);
+            peakError += std::fabs(peak);
+            printf("  %4zu %8.3f %8.3f %+8.3f %8.3f %8.3f %+8.3f\n", i + 1, rep.meanConcentricVelocity,
+                   reference[i].meanVelocity, mean, rep.peakConcentricVelocity, reference[i].peakVelocity,
+                   peak);
+        }
+
+        if (compared > 0)
+        {
+            meanError /= compared;
+            peakError /= compared;
+        }
+        printf("  Mean absolute error: mean velocity %.3f m/s, peak velocity %.3f m/s (tolerance %.3f)\n",
+               meanError, peakError, tolerance);
+
+        bool countMatches = detected.size() == reference.size();
+        bool pass = countMatches && meanError <= tolerance && peakError <= tolerance;
+        if (!countMatches)
+            printf("  Rep count differs from the reference\n");
+        printf("Result: %s\n", pass ? "PASS" : "REGRESSION");
+        return pass;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    Options options;
+    if (!parseOptions(argc, argv, options))
+    {
+        printUsage();
+        return 2;
+    }
+
+    Logger::begin();
+
+    ReplaySource source;
+    Error error = source.load(options.sessionPath, options.profile);
+    if (error.isError())
+    {
+        fprintf(stderr, "%s: %s\n", options.sessionPath, error.message());
+        return 2;
+    }
+
+    std::vector<ReferenceRep> reference;
+    if (options.referencePath)
+    {
+        error = loadReference(options.referencePath, reference);
+        if (error.isError())
+        {
+            fprintf(stderr, "%s: %s\n", options.referencePath, error.message());
+            return 2;
+        }
+    }
+
+    SensorCorrection correction;
+    if (options.hasGyroBias)
+    {
+        CalibrationData data;
+        data.accelMatrix = Matrix3::identity();
+        data.gyroBias = options.gyroBias;
+        data.temperature = source.initialTemperature();
+        data.method = CalibrationMethod::QUICK;
+        data.isValid = true;
+        correction.publish(data);
+    }
+
+    SamplePipeline pipeline(correction);
+    VelocityIntegrator velocityIntegrator;
+    RepDetector repDetector;
+    std::vector<RepMetrics> detected;
+    std::vector<CorrectedSample> drained;
+    drained.reserve(RawImuBatch::CAPACITY);
+    uint32_t periodUs = source.samplePeriodUs();
+
+    Logger::logf(Logger::Level::INFO, MODULE_NAME, "Replaying %zu samples at %s, %d pass(es)",
+                 source.sampleCount(), profileSettings(source.profile()).name, options.repeat);
+
+    int64_t startUs = esp_timer_get_time();
+    for (int pass = 0; pass < options.repeat; pass++)
+    {
+        // Timeline keeps going, so only the rep state starts over
+        source.rewind();
+        velocityIntegrator.reset();
+        repDetector.reset();
+
+        while (!source.finished())
+        {
+            drained.clear();
+            pipeline.pump(source, [&drained](const CorrectedSample &sample) { drained.push_back(sample); });
+
+            // What the comms task does with each sample popped from the ring
+            for (const CorrectedSample &sample : drained)
+            {
+                bool segmentEnded;
+                {
+                    ScopedPerfTimer timer(PerfTimerId::INTEGRATION);
+                    segmentEnded = velocityIntegrator.update(sample, periodUs);
+                }
+                if (velocityIntegrator.isStill() && sample.isCorrected)
+                {
+                    correction.learnTemperatureBias(sample.imu.temperature, sample.gyroResidual);
+                }
+                if (!segmentEnded)
+                    continue;
+
+                RepMetrics reps[Config::RepDetection::MAX_REPS_PER_SEGMENT];
+                size_t count;
+                {
+                    ScopedPerfTimer timer(PerfTimerId::REP_DETECTION);
+                    count = repDetector.analyze(velocityIntegrator.segment(), reps,
+                                                Config::RepDetection::MAX_REPS_PER_SEGMENT);
+                }
+                if (pass == 0)
+                    detected.insert(detected.end(), reps, reps + count);
+            }
+        }
+    }
+    int64_t elapsedUs = esp_timer_get_time() - startUs;
+    Logger::flush();
+
+    double samples = static_cast<double>(source.sampleCount()) * options.repeat;
+    double sessionSeconds = samples * periodUs * 1e-6;
+    double elapsedSeconds = elapsedUs * 1e-6;
+    printf("Session: %s, %zu samples, %.1f s at %s\n", options.sessionPath, source.sampleCount(),
+           source.sampleCount() * periodUs * 1e-6, profileSettings(source.profile()).name);
+    printf("Throughput: %.0f samples/s, %.0fx real time (%.3f s for %.1f s of data)\n",
+           elapsedSeconds > 0 ? samples / elapsedSeconds : 0.0,
+           elapsedSeconds > 0 ? sessionSeconds / elapsedSeconds : 0.0, elapsedSeconds, sessionSeconds);
+
+    printf("\nStage latency (us)      calls      mean      min      max    <16us    <64us   <256us"
+           "     <1ms     <4ms    <16ms    <65ms   longer\n");
+    printStage("IMU read", PerfTimerId::IMU_READ);
+    printStage("Correction", PerfTimerId::CORRECTION);
+    printStage("Fusion", PerfTimerId::FUSION);
+    printStage("Integration", PerfTimerId::INTEGRATION);
+    printStage("Rep detection", PerfTimerId::REP_DETECTION);
+
+    if (!options.referencePath)
+    {
+        printf("\nReps: %zu detected\n", detected.size());
+        for (size_t i = 0; i < detected.size(); i++)
+        {
+            printf("  %4zu mean %.3f m/s, peak %.3f m/s, ROM %.3f m\n", i + 1, detected[i].meanConcentricVelocity,
+                   detected[i].peakConcentricVelocity, detected[i].rangeOfMotion);
+        }
+        return 0;
+    }
+    return reportAccuracy(detected, reference, options.tolerance) ? 0 : 1;
+}
@@ -0,0 +1,154 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "config/config.h"
+#include "replaySource.h"
+
+namespace
+{
+    int16_t quantize(float value, float lsbPerUnit)
+    {
+        float scaled = std::round(value * lsbPerUnit);
+        if (scaled > INT16_MAX)
+            return INT16_MAX;
+        if (scaled < INT16_MIN)
+            return INT16_MIN;
+        return static_cast<int16_t>(scaled);
+    }
+
+    constexpr float DEFAULT_TEMPERATURE = 25.0f; // °C when the CSV has no temperature column
+}
+
+ReplaySource::ReplaySource() noexcept
+    : activeProfile(DEFAULT_ACQUISITION_PROFILE),
+      position(0),
+      nextIndex(0)
+{
+}
+
+Error ReplaySource::load(const char *path, AcquisitionProfile profile)
+{
+    FILE *file = fopen(path, "rb");
+    if (!file)
+    {
+        return Error(Error::Code::IO_ERROR, "Cannot open session file");
+    }
+
+    samples.clear();
+    position = 0;
+    activeProfile = profile;
+
+    char magic[4] = {};
+    bool binary = fread(magic, 1, sizeof(magic), file) == sizeof(magic) &&
+                  memcmp(magic, "PFRP", sizeof(magic)) == 0;
+    fseek(file, 0, SEEK_SET);
+    Error error = binary ? loadBinary(file) : loadCsv(file);
+    fclose(file);
+
+    if (!error.isError() && samples.empty())
+    {
+        return Error(Error::Code::IO_ERROR, "Session has no samples");
+    }
+    return error;
+}
+
+Error ReplaySource::loadBinary(FILE *file)
+{
+    ReplayFileHeader header;
+    if (fread(&header, sizeof(header), 1, file) != 1)
+    {
+        return Error(Error::Code::IO_ERROR, "Truncated session header");
+    }
+    if (header.version != REPLAY_FILE_VERSION || !isValidProfile(header.profile))
+    {
+        return Error(Error::Code::IO_ERROR, "Unsupported session version or profile");
+    }
+
+    activeProfile = static_cast<AcquisitionProfile>(header.profile);
+    samples.resize(header.sampleCount);
+    size_t read = fread(samples.data(), sizeof(ReplayFileSample), samples.size(), file);
+    samples.resize(read);
+    if (read != header.sampleCount)
+    {
+        return Error(Error::Code::IO_ERROR, "Session shorter than its header");
+    }
+    return Error(Error::Code::NONE, "Success");
+}
+
+Error ReplaySource::loadCsv(FILE *file)
+{
+    const ProfileSettings &settings = profileSettings(activeProfile);
+    char line[256];
+    while (fgets(line, sizeof(line), file))
+    {
+        // Header and comment lines do not start with a number
+        if (!(line[0] == '-' || (line[0] >= '0' && line[0] <= '9')))
+            continue;
+
+        double timestamp;
+        float a[3], g[3];
+        float temperature = DEFAULT_TEMPERATURE;
+        int fields = sscanf(line, "%lf,%f,%f,%f,%f,%f,%f,%f", &timestamp, &a[0], &a[1], &a[2],
+                            &g[0], &g[1], &g[2], &temperature);
+        if (fields < 7)
+        {
+            return Error(Error::Code::IO_ERROR, "Malformed CSV line");
+        }
+
+        ReplayFileSample sample;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            sample.accel[axis] = quantize(a[axis], settings.accelLsbPerG);
+            sample.gyro[axis] = quantize(g[axis], settings.gyroLsbPerDps);
+        }
+        sample.temperature = quantize(temperature - Config::IMU::Fifo::TEMP_OFFSET,
+                                      Config::IMU::Fifo::TEMP_LSB_PER_DEG);
+        samples.push_back(sample);
+    }
+    return Error(Error::Code::NONE, "Success");
+}
+
+uint32_t ReplaySource::samplePeriodUs() const
+{
+    return profileSettings(activeProfile).samplePeriodUs();
+}
+
+float ReplaySource::initialTemperature() const
+{
+    return samples.empty() ? DEFAULT_TEMPERATURE : RawImuBatch::toCelsius(samples[0].temperature);
+}
+
+size_t ReplaySource::drain(RawImuBatch &out)
+{
+    const ProfileSettings &settings = profileSettings(activeProfile);
+    uint32_t periodUs = settings.samplePeriodUs();
+    size_t perDrain = settings.drainIntervalMs * 1000 / periodUs;
+    if (perDrain < 1)
+        perDrain = 1;
+    if (perDrain > RawImuBatch::CAPACITY)
+        perDrain = RawImuBatch::CAPACITY;
+
+    size_t count = 0;
+    while (count < perDrain && position < samples.size())
+    {
+        const ReplayFileSample &sample = samples[position++];
+        for (int axis = 0; axis < 3; axis++)
+        {
+            out.accel[axis][count] = sample.accel[axis];
+            out.gyro[axis][count] = sample.gyro[axis];
+        }
+        out.temperature[count] = sample.temperature;
+        count++;
+    }
+
+    out.count = count;
+    out.firstIndex = nextIndex;
+    out.firstTimestampUs = static_cast<uint64_t>(nextIndex) * periodUs;
+    out.periodUs = periodUs;
+    out.clockPeriodQ16 = periodUs << 16;
+    out.accelRes = 1.0f / settings.accelLsbPerG;
+    out.gyroRes = 1.0f / settings.gyroLsbPerDps;
+    nextIndex += count;
+    return count;
+}
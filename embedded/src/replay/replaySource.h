@@ -0,0 +1,77 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "sensor/imuSampleSource.h"
+#include "utils/error.h"
+
+/**
+ * @brief Header of a binary replay session
+ *
+ * Followed by sampleCount ReplayFileSample records. Values are raw IMU LSB
+ * at the full scale of the profile, exactly as drained from the FIFO, so
+ * the replay goes through the same int16 correction path as the device.
+ * All fields are little-endian.
+ */
+struct __attribute__((packed)) ReplayFileHeader
+{
+    char magic[4];        // "PFRP"
+    uint8_t version;      // REPLAY_FILE_VERSION
+    uint8_t profile;      // AcquisitionProfile
+    uint16_t reserved;
+    uint32_t sampleCount;
+};
+
+struct __attribute__((packed)) ReplayFileSample
+{
+    int16_t accel[3];
+    int16_t gyro[3];
+    int16_t temperature; // FIFO temperature LSB
+};
+
+static constexpr uint8_t REPLAY_FILE_VERSION = 1;
+
+/**
+ * @brief Replays a recorded session as FIFO drains
+ *
+ * Reads either the binary format above or CSV lines of
+ * timestamp_us,ax,ay,az,gx,gy,gz[,temperature] in g, °/s and °C. CSV values
+ * are quantized to the LSB of the profile. Each drain returns as many
+ * samples as the device drains per Config drain interval of the profile;
+ * indices and timestamps keep counting across rewind().
+ */
+class ReplaySource : public ImuSampleSource
+{
+public:
+    ReplaySource() noexcept;
+
+    /**
+     * @param profile Profile of CSV sessions; binary sessions carry their own
+     */
+    Error load(const char *path, AcquisitionProfile profile);
+
+    size_t drain(RawImuBatch &out) override;
+    AcquisitionProfile profile() const override { return activeProfile; }
+
+    /**
+     * @brief Starts the session over, keeping the sample timeline going
+     */
+    void rewind() { position = 0; }
+
+    [[nodiscard]] bool finished() const { return position >= samples.size(); }
+    [[nodiscard]] size_t sampleCount() const { return samples.size(); }
+    [[nodiscard]] uint32_t samplePeriodUs() const;
+
+    /**
+     * @brief °C of the first sample, where a calibration given on the command line is anchored
+     */
+    [[nodiscard]] float initialTemperature() const;
+
+private:
+    std::vector<ReplayFileSample> samples;
+    AcquisitionProfile activeProfile;
+    size_t position;
+    uint32_t nextIndex;
+
+    Error loadBinary(FILE *file);
+    Error loadCsv(FILE *file);
+};
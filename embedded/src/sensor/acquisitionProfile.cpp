@@ -0,0 +1,43 @@
+#include "config/config.h"
+#include "acquisitionProfile.h"
+
+namespace
+{
+    using Values = Config::IMU::Values;
+
+    // LSB per unit halves with every full-scale step
+    constexpr float accelLsbPerG(uint8_t fs) { return 16384.0f / (1 << fs); }
+    constexpr float gyroLsbPerDps(uint8_t fs) { return 131.0f / (1 << fs); }
+
+    // FIFO holds 73 packets: 2.9 s at 25Hz, 146 ms at 500Hz, 73 ms at 1kHz.
+    // Connection intervals keep each event to a few full frames at the
+    // stream's data rate: 50-100 ms, 15-30 ms, 7.5-15 ms, 7.5 ms.
+    const ProfileSettings PROFILES[] = {
+        {"Idle", Values::SAMPLE_RATE_25HZ, Values::DLPF_10HZ, Values::ACCEL_FS_8G, Values::GYRO_FS_250DPS,
+         accelLsbPerG(Values::ACCEL_FS_8G), gyroLsbPerDps(Values::GYRO_FS_250DPS), 100, 40, 80},
+        {"Strength", Values::SAMPLE_RATE_100HZ, Values::DLPF_20HZ, Values::ACCEL_FS_8G, Values::GYRO_FS_250DPS,
+         accelLsbPerG(Values::ACCEL_FS_8G), gyroLsbPerDps(Values::GYRO_FS_250DPS), 20, 12, 24},
+        {"Olympic", Values::SAMPLE_RATE_500HZ, Values::DLPF_92HZ, Values::ACCEL_FS_16G, Values::GYRO_FS_1000DPS,
+         accelLsbPerG(Values::ACCEL_FS_16G), gyroLsbPerDps(Values::GYRO_FS_1000DPS), 20, 6, 12},
+        {"Olympic Max", Values::SAMPLE_RATE_1KHZ, Values::DLPF_176HZ, Values::ACCEL_FS_16G, Values::GYRO_FS_2000DPS,
+         accelLsbPerG(Values::ACCEL_FS_16G), gyroLsbPerDps(Values::GYRO_FS_2000DPS), 20, 6, 6},
+    };
+
+    static_assert(sizeof(PROFILES) / sizeof(PROFILES[0]) == static_cast<size_t>(AcquisitionProfile::COUNT),
+                  "Every profile needs settings");
+}
+
+uint32_t ProfileSettings::samplePeriodUs() const
+{
+    return 1000000UL * (sampleRateDiv + 1) / Config::IMU::Fifo::INTERNAL_RATE_HZ;
+}
+
+bool isValidProfile(uint8_t value)
+{
+    return value < static_cast<uint8_t>(AcquisitionProfile::COUNT);
+}
+
+const ProfileSettings &profileSettings(AcquisitionProfile profile)
+{
+    return PROFILES[static_cast<uint8_t>(profile)];
+}
@@ -0,0 +1,40 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief Named IMU configurations selectable at runtime
+ *
+ * Values are part of the BLE protocol (CalibrationCommand::SET_PROFILE).
+ */
+enum class AcquisitionProfile : uint8_t
+{
+    IDLE = 0,        // 25Hz, 10Hz DLPF: presence and low-power monitoring
+    STRENGTH = 1,    // 100Hz, 20Hz DLPF: slow barbell and machine lifts
+    OLYMPIC = 2,     // 500Hz, 92Hz DLPF, ±16g: cleans, snatches, jerks
+    OLYMPIC_MAX = 3, // 1kHz, 176Hz DLPF, ±16g / ±2000°/s: peak capture
+    COUNT
+};
+
+/**
+ * @brief Register values and derived timing of one profile
+ */
+struct ProfileSettings
+{
+    const char *name;
+    uint8_t sampleRateDiv;    // SAMPLE_RATE_DIV (ODR = 1kHz / (div + 1))
+    uint8_t dlpf;             // DLPF_CFG and A_DLPF_CFG
+    uint8_t accelFs;          // ACCEL_FS_SEL
+    uint8_t gyroFs;           // FS_SEL
+    float accelLsbPerG;
+    float gyroLsbPerDps;
+    uint32_t drainIntervalMs; // FIFO read period, well below the time to fill it
+    uint16_t minConnInterval; // BLE connection interval for streaming it, 1.25 ms units
+    uint16_t maxConnInterval;
+
+    uint32_t samplePeriodUs() const;
+};
+
+constexpr AcquisitionProfile DEFAULT_ACQUISITION_PROFILE = AcquisitionProfile::STRENGTH;
+
+bool isValidProfile(uint8_t value);
+const ProfileSettings &profileSettings(AcquisitionProfile profile);
@@ -0,0 +1,23 @@
+#pragma once
+#include "sensor/acquisitionProfile.h"
+#include "sensor/imuSample.h"
+#include "utils/quaternion.h"
+#include "utils/vector3d.h"
+
+/**
+ * @brief Sample handed from the sensor task to the BLE/UI task
+ *
+ * accel and gyro hold the calibrated values when isCorrected is set and the
+ * raw readings otherwise (no valid calibration, or calibration in progress).
+ * profile is the acquisition profile the sample was taken with, so consumers
+ * pick up rate and scale changes in order with the data.
+ */
+struct CorrectedSample
+{
+    ImuSample imu;
+    Vector3D gyroResidual; // °/s, imu.gyro before the deadband, what temperature drift is learned from
+    bool isCorrected;
+    AcquisitionProfile profile;
+    Quaternion orientation; // Sensor to world frame
+    Vector3D linearAccel;   // g, world frame, gravity removed
+};
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "config/config.h"
+
+/**
+ * @brief FIFO packets of one drain, unconverted and split per axis
+ *
+ * Samples are consecutive: sample i has index firstIndex + i. periodUs is
+ * the nominal spacing of the profile; timestamps use clockPeriodQ16, the
+ * spacing measured on the device clock. Multiply by accelRes / gyroRes for
+ * g and °/s.
+ */
+struct RawImuBatch
+{
+    static constexpr size_t CAPACITY = Config::IMU::Fifo::MAX_DRAIN_PACKETS;
+
+    int16_t accel[3][CAPACITY];
+    int16_t gyro[3][CAPACITY];
+    int16_t temperature[CAPACITY];
+    size_t count;
+    uint32_t firstIndex;
+    uint64_t firstTimestampUs;
+    uint32_t periodUs;
+    uint32_t clockPeriodQ16; // µs * 65536 between samples on the device clock
+    float accelRes; // g per LSB
+    float gyroRes;  // °/s per LSB
+
+    uint64_t timestampUs(size_t i) const
+    {
+        return firstTimestampUs + ((static_cast<uint64_t>(i) * clockPeriodQ16) >> 16);
+    }
+
+    static float toCelsius(int16_t raw)
+    {
+        return raw / Config::IMU::Fifo::TEMP_LSB_PER_DEG + Config::IMU::Fifo::TEMP_OFFSET;
+    }
+};
+
+/**
+ * @brief Converted samples of one drain, split per axis
+ */
+struct ImuBatch
+{
+    float accel[3][RawImuBatch::CAPACITY];        // g
+    float gyro[3][RawImuBatch::CAPACITY];         // °/s
+    float gyroResidual[3][RawImuBatch::CAPACITY]; // °/s, corrected gyro before the deadband
+    size_t count;
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+#include "utils/vector3d.h"
+
+/**
+ * @brief Single IMU sample drained from the hardware FIFO
+ *
+ * Timestamps are derived from the sample index and the configured output
+ * data rate, so consecutive samples are always exactly one period apart.
+ */
+struct ImuSample
+{
+    Vector3D accel;       // g
+    Vector3D gyro;        // °/s
+    float temperature;    // °C
+    uint32_t index;       // Monotonic sample counter since begin()
+    uint64_t timestampUs; // Device time of the sample
+};
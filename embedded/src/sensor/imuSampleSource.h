@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include "sensor/acquisitionProfile.h"
+#include "sensor/imuBatch.h"
+
+/**
+ * @brief Producer of raw IMU drains for the SamplePipeline
+ *
+ * ImuSampler reads the MPU6886 FIFO on the device; the replay harness
+ * (src/replay) reads recorded sessions on the host, so both feed the same
+ * pipeline code.
+ */
+class ImuSampleSource
+{
+public:
+    virtual ~ImuSampleSource() = default;
+
+    /**
+     * @brief Reads the samples available now, up to the batch capacity
+     * @return Number of samples written to out
+     */
+    virtual size_t drain(RawImuBatch &out) = 0;
+
+    /**
+     * @brief Profile the drained samples were taken with
+     */
+    virtual AcquisitionProfile profile() const = 0;
+};
@@ -0,0 +1,270 @@
+#include "config/config.h"
+#include "imuSampler.h"
+
+constexpr char ImuSampler::MODULE_NAME[];
+
+namespace
+{
+    inline int16_t toInt16(const uint8_t *bytes)
+    {
+        return static_cast<int16_t>((bytes[0] << 8) | bytes[1]);
+    }
+}
+
+ImuSampler::ImuSampler() noexcept
+    : imu(nullptr),
+      activeProfile(DEFAULT_ACQUISITION_PROFILE),
+      periodUs(0),
+      accelRes(1.0f / Config::IMU::Values::ACCEL_LSB_PER_G),
+      gyroRes(1.0f / Config::IMU::Values::GYRO_LSB_PER_DPS),
+      timelineStartUs(0),
+      timelineStartIndex(0),
+      clockAnchorUs(0),
+      clockAnchorIndex(0),
+      clockPeriodQ16(0),
+      lastClockUpdateUs(0),
+      nextIndex(0),
+      dropped(0),
+      overflows(0),
+      motionSeen(false)
+{
+}
+
+Error ImuSampler::begin(AcquisitionProfile profile)
+{
+    imu = M5.Imu.getImuInstancePtr(0);
+    if (!imu)
+    {
+        return Error(Error::Code::IMU_INIT_FAILED, "Failed to get IMU instance");
+    }
+
+    nextIndex = 0;
+
+    // Only wake-on-motion may drive the INT pin, not the library's defaults
+    setWakeOnMotion(false, 0.0f);
+    return applyProfile(profile);
+}
+
+void ImuSampler::setWakeOnMotion(bool enabled, float threshold)
+{
+    if (!imu)
+        return;
+
+    if (!enabled)
+    {
+        imu->writeRegister8(Config::IMU::Registers::INT_ENABLE, 0);
+        imu->writeRegister8(Config::IMU::Registers::ACCEL_INTEL_CTRL, 0);
+        return;
+    }
+
+    float lsb = threshold * 1000.0f / Config::IMU::WakeOnMotion::MG_PER_LSB;
+    uint8_t value = lsb >= 255.0f ? 255 : static_cast<uint8_t>(lsb);
+    imu->writeRegister8(Config::IMU::Registers::ACCEL_WOM_X_THR, value);
+    imu->writeRegister8(Config::IMU::Registers::ACCEL_WOM_Y_THR, value);
+    imu->writeRegister8(Config::IMU::Registers::ACCEL_WOM_Z_THR, value);
+    imu->writeRegister8(Config::IMU::Registers::INT_PIN_CFG, Config::IMU::WakeOnMotion::PIN_LATCHED);
+    imu->writeRegister8(Config::IMU::Registers::ACCEL_INTEL_CTRL, Config::IMU::WakeOnMotion::INTEL_ENABLE);
+    imu->writeRegister8(Config::IMU::Registers::INT_ENABLE, Config::IMU::WakeOnMotion::INT_ENABLE_WOM);
+}
+
+bool ImuSampler::takeMotion() noexcept
+{
+    bool seen = motionSeen;
+    motionSeen = false;
+    return seen;
+}
+
+Error ImuSampler::applyProfile(AcquisitionProfile profile)
+{
+    if (!imu)
+    {
+        return Error(Error::Code::INVALID_STATE, "IMU sampler not started");
+    }
+
+    const ProfileSettings &settings = profileSettings(profile);
+    configureRegisters(settings);
+
+    activeProfile = profile;
+    periodUs = settings.samplePeriodUs();
+    clockPeriodQ16 = periodUs << 16;
+    accelRes = 1.0f / settings.accelLsbPerG;
+    gyroRes = 1.0f / settings.gyroLsbPerDps;
+
+    // Packets already queued were taken with the old settings
+    resetFifo();
+
+    Logger::logf(Logger::Level::INFO, MODULE_NAME, "FIFO acquisition started, profile %s, period %lu us",
+                 settings.name, static_cast<unsigned long>(periodUs));
+    return Error(Error::Code::NONE, "Success");
+}
+
+void ImuSampler::configureRegisters(const ProfileSettings &settings)
+{
+    imu->writeRegister8(Config::IMU::Registers::FIFO_EN, 0);
+
+    // Gyroscope full scale, FCHOICE_B cleared to keep the DLPF enabled
+    uint8_t gyroConfig = imu->readRegister8(Config::IMU::Registers::GYRO_CONFIG);
+    gyroConfig &= ~((0x3 << 3) | 0x3);
+    gyroConfig |= (settings.gyroFs << 3);
+    imu->writeRegister8(Config::IMU::Registers::GYRO_CONFIG, gyroConfig);
+
+    uint8_t accConfig = imu->readRegister8(Config::IMU::Registers::ACCEL_CONFIG);
+    accConfig &= ~(0x3 << 3);
+    accConfig |= (settings.accelFs << 3);
+    imu->writeRegister8(Config::IMU::Registers::ACCEL_CONFIG, accConfig);
+
+    // Accelerometer DLPF, no averaging and ACCEL_FCHOICE_B cleared
+    uint8_t accConfig2 = imu->readRegister8(Config::IMU::Registers::ACCEL_CONFIG2);
+    accConfig2 &= ~0x3F;
+    accConfig2 |= settings.dlpf;
+    imu->writeRegister8(Config::IMU::Registers::ACCEL_CONFIG2, accConfig2);
+
+    // Gyro DLPF; stop writing once full instead of overwriting, so packets never tear
+    uint8_t config = imu->readRegister8(Config::IMU::Registers::DLPF_CONFIG);
+    config &= ~0x7;
+    config |= settings.dlpf | Config::IMU::Fifo::STOP_WHEN_FULL;
+    imu->writeRegister8(Config::IMU::Registers::DLPF_CONFIG, config);
+
+    imu->writeRegister8(Config::IMU::Registers::SAMPLE_RATE_DIV, settings.sampleRateDiv);
+    imu->writeRegister8(Config::IMU::Registers::FIFO_EN, Config::IMU::Fifo::GYRO_ACCEL_ENABLE);
+}
+
+void ImuSampler::resetFifo()
+{
+    imu->writeRegister8(Config::IMU::Registers::USER_CTRL, Config::IMU::Fifo::USER_CTRL_RESET);
+    imu->writeRegister8(Config::IMU::Registers::USER_CTRL, Config::IMU::Fifo::USER_CTRL_ENABLE);
+    timelineStartUs = esp_timer_get_time();
+    timelineStartIndex = nextIndex;
+    clockAnchorUs = timelineStartUs;
+    clockAnchorIndex = nextIndex;
+    lastClockUpdateUs = timelineStartUs;
+}
+
+void ImuSampler::recoverFromOverflow()
+{
+    // Keep the timeline continuous: skip the indices of the samples the chip discarded
+    uint64_t now = esp_timer_get_time();
+    uint64_t expectedUs = timestampOf(nextIndex);
+    uint32_t lost = now > expectedUs ? static_cast<uint32_t>((now - expectedUs) / periodUs) : 0;
+
+    overflows++;
+    dropped += lost;
+    nextIndex += lost;
+    resetFifo();
+
+    Logger::logf(Logger::Level::WARN, MODULE_NAME, "FIFO overflow, %lu samples lost",
+                 static_cast<unsigned long>(lost));
+}
+
+uint64_t ImuSampler::timestampOf(uint32_t index) const
+{
+    return clockAnchorUs + ((static_cast<uint64_t>(index - clockAnchorIndex) * clockPeriodQ16) >> 16);
+}
+
+void ImuSampler::trackClock(size_t available, uint64_t now)
+{
+    if (available == 0 || now - lastClockUpdateUs < Config::IMU::Clock::UPDATE_INTERVAL * 1000ULL)
+        return;
+    lastClockUpdateUs = now;
+
+    // The newest packet in the FIFO was sampled within the last period
+    uint32_t newest = nextIndex + available - 1;
+    uint64_t observedUs = now - periodUs / 2;
+    uint32_t elapsedSamples = newest - timelineStartIndex + 1;
+    if (observedUs <= timelineStartUs)
+        return;
+    int64_t measuredQ16 = static_cast<int64_t>(((observedUs - timelineStartUs) << 16) / elapsedSamples);
+
+    // Steer away the offset accumulated so far within the next interval
+    int64_t offsetUs = static_cast<int64_t>(observedUs) - static_cast<int64_t>(timestampOf(newest));
+    int64_t horizon = Config::IMU::Clock::UPDATE_INTERVAL * 1000LL / periodUs;
+    int64_t periodQ16 = measuredQ16 + offsetUs * 65536 / horizon;
+
+    int64_t nominalQ16 = static_cast<int64_t>(periodUs) << 16;
+    int64_t limit = nominalQ16 * Config::IMU::Clock::MAX_ERROR_PPM / 1000000;
+    if (periodQ16 < nominalQ16 - limit)
+        periodQ16 = nominalQ16 - limit;
+    if (periodQ16 > nominalQ16 + limit)
+        periodQ16 = nominalQ16 + limit;
+
+    // Re-anchor at the next sample so timestamps stay continuous
+    clockAnchorUs = timestampOf(nextIndex);
+    clockAnchorIndex = nextIndex;
+    clockPeriodQ16 = static_cast<uint32_t>(periodQ16);
+}
+
+uint16_t ImuSampler::readFifoCount()
+{
+    uint8_t count[2];
+    if (!imu->readRegister(Config::IMU::Registers::FIFO_COUNT_H, count, sizeof(count)))
+    {
+        return 0;
+    }
+    return static_cast<uint16_t>(((count[0] & 0x1F) << 8) | count[1]);
+}
+
+void ImuSampler::decodePacket(const uint8_t *packet, RawImuBatch &out, size_t i)
+{
+    out.accel[0][i] = toInt16(packet);
+    out.accel[1][i] = toInt16(packet + 2);
+    out.accel[2][i] = toInt16(packet + 4);
+    out.temperature[i] = toInt16(packet + 6);
+    out.gyro[0][i] = toInt16(packet + 8);
+    out.gyro[1][i] = toInt16(packet + 10);
+    out.gyro[2][i] = toInt16(packet + 12);
+}
+
+size_t ImuSampler::drain(RawImuBatch &out)
+{
+    out.count = 0;
+    out.firstIndex = nextIndex;
+    out.firstTimestampUs = timestampOf(nextIndex);
+    out.periodUs = periodUs;
+    out.clockPeriodQ16 = clockPeriodQ16;
+    out.accelRes = accelRes;
+    out.gyroRes = gyroRes;
+
+    if (!imu)
+        return 0;
+
+    // Reading clears every flag, so keep the motion bits before anything else
+    uint8_t status = imu->readRegister8(Config::IMU::Registers::INT_STATUS);
+    if (status & Config::IMU::WakeOnMotion::INT_ENABLE_WOM)
+        motionSeen = true;
+
+    if (status & Config::IMU::Fifo::OVERFLOW_FLAG)
+    {
+        recoverFromOverflow();
+        return 0;
+    }
+
+    size_t available = readFifoCount() / Config::IMU::Fifo::PACKET_SIZE;
+    trackClock(available, esp_timer_get_time());
+    out.clockPeriodQ16 = clockPeriodQ16; // Re-anchored at nextIndex, firstTimestampUs still holds
+    size_t toRead = available < RawImuBatch::CAPACITY ? available : RawImuBatch::CAPACITY;
+
+    uint8_t buffer[Config::IMU::Fifo::PACKET_SIZE * Config::IMU::Fifo::READ_BURST_PACKETS];
+    size_t produced = 0;
+    while (produced < toRead)
+    {
+        size_t burst = toRead - produced;
+        if (burst > Config::IMU::Fifo::READ_BURST_PACKETS)
+            burst = Config::IMU::Fifo::READ_BURST_PACKETS;
+
+        if (!imu->readRegister(Config::IMU::Registers::FIFO_R_W, buffer, burst * Config::IMU::Fifo::PACKET_SIZE))
+        {
+            Logger::warn(MODULE_NAME, "FIFO read failed");
+            break;
+        }
+
+        for (size_t i = 0; i < burst; i++)
+        {
+            decodePacket(buffer + i * Config::IMU::Fifo::PACKET_SIZE, out, produced + i);
+        }
+        produced += burst;
+    }
+
+    nextIndex += produced;
+    out.count = produced;
+    return produced;
+}
@@ -0,0 +1,103 @@
+#pragma once
+#include <M5StickCPlus2.h>
+#include "sensor/acquisitionProfile.h"
+#include "sensor/imuBatch.h"
+#include "sensor/imuSample.h"
+#include "sensor/imuSampleSource.h"
+#include "utils/logger.h"
+#include "utils/error.h"
+
+/**
+ * @brief Acquires IMU data through the MPU6886 hardware FIFO
+ *
+ * The chip fills its FIFO at the configured output data rate and the caller
+ * drains it in bursts. No sample is lost as long as drain() is called before
+ * the 1 KB FIFO fills up; if it does overflow, the FIFO is reset and the
+ * sample index is advanced by the estimated number of lost samples so that
+ * timestamps remain aligned with device time.
+ *
+ * Timestamps count samples rather than reading a timer per packet, but the
+ * IMU oscillator is off by up to a few percent. The sample clock is
+ * therefore measured against esp_timer (the clock time sync reports) and
+ * its spacing steered so timestamps follow device time without jumps.
+ */
+class ImuSampler : public ImuSampleSource
+{
+public:
+    static constexpr char MODULE_NAME[] = "IMU";
+
+    ImuSampler() noexcept;
+
+    /**
+     * @brief Configures the IMU for a profile, enables the FIFO for accel +
+     * gyro and starts a new sample timeline
+     */
+    Error begin(AcquisitionProfile profile);
+
+    /**
+     * @brief Switches rate, filter and full scale without a reboot
+     *
+     * Packets still in the FIFO are discarded, so drain() first. The sample
+     * index keeps counting; the timeline restarts at the new period.
+     */
+    Error applyProfile(AcquisitionProfile profile);
+
+    /**
+     * @brief Reads all complete packets currently in the FIFO, up to the batch capacity
+     *
+     * Values stay in LSB; the batch carries the resolutions of the active
+     * profile so calibration can fold them into its coefficients.
+     * @return Number of samples written to out
+     */
+    size_t drain(RawImuBatch &out) override;
+
+    /**
+     * @brief Raises the INT pin when the acceleration changes by more than threshold
+     *
+     * The pin and the flags stay set until INT_STATUS is read, which every
+     * drain() does; takeMotion() reports what the last reads saw, for boards
+     * without the INT line.
+     * @param threshold g between two consecutive samples
+     */
+    void setWakeOnMotion(bool enabled, float threshold);
+
+    /**
+     * @brief Whether a drain saw wake-on-motion flags since the last call
+     */
+    [[nodiscard]] bool takeMotion() noexcept;
+
+    [[nodiscard]] AcquisitionProfile profile() const noexcept override { return activeProfile; }
+    [[nodiscard]] uint32_t samplePeriodUs() const noexcept { return periodUs; }
+    [[nodiscard]] uint32_t droppedSamples() const noexcept { return dropped; }
+    [[nodiscard]] uint32_t overflowCount() const noexcept { return overflows; }
+
+private:
+    m5::IMU_Base *imu;
+    AcquisitionProfile activeProfile;
+    uint32_t periodUs;
+    float accelRes;
+    float gyroRes;
+    uint64_t timelineStartUs;   // FIFO reset, the reference the clock is measured from
+    uint32_t timelineStartIndex;
+    uint64_t clockAnchorUs;     // Timestamp of clockAnchorIndex
+    uint32_t clockAnchorIndex;
+    uint32_t clockPeriodQ16;    // µs * 65536 between samples
+    uint64_t lastClockUpdateUs;
+    uint32_t nextIndex;
+    uint32_t dropped;
+    uint32_t overflows;
+    bool motionSeen;            // WOM flags in an INT_STATUS read since takeMotion()
+
+    void configureRegisters(const ProfileSettings &settings);
+    void resetFifo();
+    void recoverFromOverflow();
+    uint64_t timestampOf(uint32_t index) const;
+
+    /**
+     * @brief Re-measures the sample spacing from the FIFO fill level
+     * @param available Packets in the FIFO when its count was read at now
+     */
+    void trackClock(size_t available, uint64_t now);
+    uint16_t readFifoCount();
+    void decodePacket(const uint8_t *packet, RawImuBatch &out, size_t i);
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include "calibration/sensorCorrection.h"
+#include "fusion/madgwickFilter.h"
+#include "perf/perfCounters.h"
+#include "sensor/correctedSample.h"
+#include "sensor/imuBatch.h"
+#include "sensor/imuSampleSource.h"
+
+/**
+ * @brief Turns raw IMU drains into corrected, fused samples
+ *
+ * The platform-independent part of the sensor task: one drain from an
+ * ImuSampleSource, batch correction, orientation fusion at the full sample
+ * rate and CorrectedSample assembly. The replay harness runs the same code
+ * on the host. Stages are timed into PerfCounters.
+ */
+class SamplePipeline
+{
+public:
+    explicit SamplePipeline(SensorCorrection &correction) noexcept : correction(correction) {}
+
+    /**
+     * @brief Drains the source once and hands every sample to sink in order
+     * @param sink Callable taking a const CorrectedSample &
+     * @return Number of samples drained
+     */
+    template <typename Sink>
+    size_t pump(ImuSampleSource &source, Sink &&sink)
+    {
+        size_t count;
+        {
+            ScopedPerfTimer timer(PerfTimerId::IMU_READ);
+            count = source.drain(rawBatch);
+        }
+
+        bool corrected;
+        {
+            ScopedPerfTimer timer(PerfTimerId::CORRECTION);
+            corrected = correction.correctBatch(rawBatch, batch);
+        }
+
+        ScopedPerfTimer timer(PerfTimerId::FUSION);
+        AcquisitionProfile profile = source.profile();
+        float dt = rawBatch.periodUs * 1e-6f;
+        for (size_t i = 0; i < count; i++)
+        {
+            CorrectedSample out;
+            out.imu.accel = Vector3D(batch.accel[0][i], batch.accel[1][i], batch.accel[2][i]);
+            out.imu.gyro = Vector3D(batch.gyro[0][i], batch.gyro[1][i], batch.gyro[2][i]);
+            out.gyroResidual = Vector3D(batch.gyroResidual[0][i], batch.gyroResidual[1][i], batch.gyroResidual[2][i]);
+            out.imu.temperature = RawImuBatch::toCelsius(rawBatch.temperature[i]);
+            out.imu.index = rawBatch.firstIndex + i;
+            out.imu.timestampUs = rawBatch.timestampUs(i);
+            out.isCorrected = corrected;
+            out.profile = profile;
+
+            fusion.update(out.imu.accel, out.imu.gyro, dt);
+            out.orientation = fusion.orientation();
+            out.linearAccel = fusion.linearAcceleration(out.imu.accel);
+            sink(out);
+        }
+        return count;
+    }
+
+private:
+    SensorCorrection &correction;
+    MadgwickFilter fusion;
+    RawImuBatch rawBatch;
+    ImuBatch batch;
+};
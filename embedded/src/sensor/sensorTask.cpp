@@ -0,0 +1,149 @@
+#include "sensorTask.h"
+
+constexpr char SensorTask::MODULE_NAME[];
+
+SensorTask::SensorTask(ImuSampler &sampler, SensorCorrection &correction, SampleRing &ring) noexcept
+    : sampler(sampler),
+      ring(ring),
+      handle(nullptr),
+      pendingProfile(static_cast<uint8_t>(DEFAULT_ACQUISITION_PROFILE)),
+      wakeRequested(false),
+      wakeProfile(static_cast<uint8_t>(DEFAULT_ACQUISITION_PROFILE)),
+      wakeups(0),
+      wakeArmed(false),
+      pipeline(correction)
+{
+}
+
+Error SensorTask::start()
+{
+    if (handle)
+    {
+        return Error(Error::Code::INVALID_STATE, "Sensor task already running");
+    }
+
+    BaseType_t result = xTaskCreatePinnedToCore(taskEntry, "sensor",
+                                                Config::Tasks::SENSOR_STACK_SIZE, this,
+                                                Config::Tasks::SENSOR_PRIORITY, &handle,
+                                                Config::Tasks::SENSOR_CORE);
+    if (result != pdPASS)
+    {
+        handle = nullptr;
+        return Error(Error::Code::MEMORY_ERROR, "Failed to create sensor task");
+    }
+
+    Logger::info(MODULE_NAME, "Sensor task started");
+    return Error(Error::Code::NONE, "Success");
+}
+
+void SensorTask::requestProfile(AcquisitionProfile profile)
+{
+    pendingProfile.store(static_cast<uint8_t>(profile), std::memory_order_relaxed);
+}
+
+void SensorTask::attachMotionInterrupt(int pin)
+{
+    if (pin < 0)
+    {
+        Logger::info(MODULE_NAME, "No motion interrupt, polling the IMU flags");
+        return;
+    }
+
+    pinMode(pin, INPUT);
+    attachInterruptArg(pin, motionIsr, this, RISING);
+    Logger::logf(Logger::Level::INFO, MODULE_NAME, "Motion interrupt on GPIO %d", pin);
+}
+
+void SensorTask::armWakeOnMotion(AcquisitionProfile profile)
+{
+    wakeProfile.store(static_cast<uint8_t>(profile), std::memory_order_relaxed);
+    wakeRequested.store(true, std::memory_order_release);
+}
+
+void SensorTask::disarmWakeOnMotion()
+{
+    wakeRequested.store(false, std::memory_order_release);
+}
+
+void SensorTask::notifyMotion()
+{
+    if (handle)
+        xTaskNotifyGive(handle);
+}
+
+void IRAM_ATTR SensorTask::motionIsr(void *param)
+{
+    auto *task = static_cast<SensorTask *>(param);
+    if (!task->handle)
+        return;
+
+    BaseType_t woken = pdFALSE;
+    vTaskNotifyGiveFromISR(task->handle, &woken);
+    portYIELD_FROM_ISR(woken);
+}
+
+void SensorTask::taskEntry(void *param)
+{
+    static_cast<SensorTask *>(param)->run();
+}
+
+void SensorTask::run()
+{
+    TickType_t lastWake = xTaskGetTickCount();
+
+    while (true)
+    {
+        // Wait for the next drain; a motion notification ends the wait early
+        TickType_t period = pdMS_TO_TICKS(profileSettings(sampler.profile()).drainIntervalMs);
+        TickType_t elapsed = xTaskGetTickCount() - lastWake;
+        bool motion = ulTaskNotifyTake(pdTRUE, elapsed < period ? period - elapsed : 0) > 0;
+        lastWake = xTaskGetTickCount();
+        PerfCounters::mark(PerfTimerId::SENSOR_PERIOD);
+
+        pipeline.pump(sampler, [this](const CorrectedSample &sample) { ring.push(sample); });
+        // Without the INT line, motion only shows in the flags the drain read
+        motion = sampler.takeMotion() || motion;
+
+        if (motion)
+        {
+            handleMotion();
+        }
+        applyWakeOnMotion();
+        applyPendingProfile();
+    }
+}
+
+void SensorTask::handleMotion()
+{
+    if (!wakeRequested.load(std::memory_order_acquire))
+        return;
+
+    // Back to full rate now; the comms task follows up on the wakeup count
+    pendingProfile.store(wakeProfile.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    wakeRequested.store(false, std::memory_order_release);
+    wakeups.fetch_add(1, std::memory_order_relaxed);
+}
+
+void SensorTask::applyWakeOnMotion()
+{
+    bool requested = wakeRequested.load(std::memory_order_acquire);
+    if (requested == wakeArmed)
+        return;
+
+    sampler.setWakeOnMotion(requested, Config::Power::WAKE_THRESHOLD);
+    wakeArmed = requested;
+}
+
+void SensorTask::applyPendingProfile()
+{
+    auto profile = static_cast<AcquisitionProfile>(pendingProfile.load(std::memory_order_relaxed));
+    if (profile == sampler.profile())
+        return;
+
+    Error error = sampler.applyProfile(profile);
+    if (error.isError())
+    {
+        Logger::error(MODULE_NAME, error.message());
+        pendingProfile.store(static_cast<uint8_t>(sampler.profile()), std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,81 @@
+#pragma once
+#include <atomic>
+#include "config/config.h"
+#include "calibration/sensorCorrection.h"
+#include "sensor/correctedSample.h"
+#include "sensor/imuSampler.h"
+#include "sensor/samplePipeline.h"
+#include "utils/spscRing.h"
+#include "utils/error.h"
+
+using SampleRing = SpscRing<CorrectedSample, Config::Tasks::SAMPLE_RING_CAPACITY>;
+
+/**
+ * @brief High-priority FreeRTOS task that owns IMU acquisition
+ *
+ * Runs pinned to its own core, drains the IMU FIFO at a fixed period
+ * through a SamplePipeline (one batch correction pass, orientation fusion
+ * at the full sample rate) and pushes the results into the sample ring.
+ * It never waits on the consumer: when the ring is full the sample is
+ * dropped and counted by the ring.
+ */
+class SensorTask
+{
+public:
+    static constexpr char MODULE_NAME[] = "SENSOR";
+
+    SensorTask(ImuSampler &sampler, SensorCorrection &correction, SampleRing &ring) noexcept;
+
+    Error start();
+
+    /**
+     * @brief Asks the task to switch profile after its next FIFO drain
+     *
+     * Safe to call from any task; the IMU is only touched by the sensor task.
+     */
+    void requestProfile(AcquisitionProfile profile);
+
+    /**
+     * @brief Routes the IMU INT line to the task, so motion ends its wait early
+     *
+     * With pin -1 motion is still noticed, from the flags each drain reads.
+     */
+    void attachMotionInterrupt(int pin);
+
+    /**
+     * @brief Enables wake-on-motion; on motion the task switches itself to wakeProfile
+     *
+     * The switch happens right after the interrupt, without waiting for the
+     * comms task. Wake-on-motion disarms itself once triggered.
+     */
+    void armWakeOnMotion(AcquisitionProfile wakeProfile);
+    void disarmWakeOnMotion();
+
+    /**
+     * @brief Same as a motion interrupt, for wakeups the ISR did not see (light sleep)
+     */
+    void notifyMotion();
+
+    /**
+     * @brief Number of motion wakeups handled, to detect new ones by comparison
+     */
+    [[nodiscard]] uint32_t motionWakeups() const noexcept { return wakeups.load(std::memory_order_relaxed); }
+
+private:
+    ImuSampler &sampler;
+    SampleRing &ring;
+    TaskHandle_t handle;
+    std::atomic<uint8_t> pendingProfile;
+    std::atomic<bool> wakeRequested;  // Wake-on-motion wanted by the power manager
+    std::atomic<uint8_t> wakeProfile; // Profile to switch to on motion
+    std::atomic<uint32_t> wakeups;
+    bool wakeArmed;                   // Wake-on-motion configured in the IMU
+    SamplePipeline pipeline;
+
+    static void taskEntry(void *param);
+    static void IRAM_ATTR motionIsr(void *param);
+    void run();
+    void handleMotion();
+    void applyWakeOnMotion();
+    void applyPendingProfile();
+};
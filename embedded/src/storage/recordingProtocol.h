@@ -0,0 +1,101 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief Wire format of the recording characteristic
+ *
+ * The app writes RecordCommand messages, the device answers with
+ * notifications whose first byte is a RecordMessage. All fields are
+ * little-endian.
+ *
+ * Bulk download: after DOWNLOAD the device sends up to
+ * Config::Recording::WINDOW_FRAMES DATA frames beyond the last
+ * acknowledged sample and then waits. The app acknowledges cumulatively
+ * with ACK(nextSample) for every in-order frame. An ACK repeating the last
+ * acknowledged position (the app saw a gap), or no progress within
+ * Config::Recording::ACK_TIMEOUT, makes the device resend from the
+ * acknowledged position (go-back-N). The app drops frames that do not
+ * start at its next expected sample.
+ */
+enum class RecordCommand : uint8_t
+{
+    START = 1,     // Begin a new session
+    STOP = 2,      // End the active session
+    LIST = 3,      // SESSION_INFO for every session, then LIST_END
+    DOWNLOAD = 4,  // RecordDownloadRequest
+    ACK = 5,       // RecordDownloadRequest with the next expected sample
+    ERASE_ALL = 6, // Free the whole arena (stops recording)
+    STATUS = 7     // RecordStatus
+};
+
+enum class RecordMessage : uint8_t
+{
+    STATUS = 0x81,
+    SESSION_INFO = 0x82,
+    LIST_END = 0x83,
+    DATA = 0x84,
+    DOWNLOAD_END = 0x85,
+    ERROR = 0x8F
+};
+
+enum class RecordError : uint8_t
+{
+    UNKNOWN_COMMAND = 1,
+    UNKNOWN_SESSION = 2,
+    NO_STORAGE = 3,
+    STORAGE_FULL = 4,
+    BUSY = 5,
+    MTU_TOO_SMALL = 6 // Session info does not fit a notification at the negotiated MTU
+};
+
+struct __attribute__((packed)) RecordDownloadRequest
+{
+    RecordCommand command;
+    uint16_t sessionId;
+    uint32_t sample; // First sample to send (DOWNLOAD) or next expected (ACK)
+};
+
+struct __attribute__((packed)) RecordStatus
+{
+    RecordMessage type;
+    uint8_t recording;
+    uint16_t activeSessionId;
+    uint8_t sessionCount;
+    uint32_t usedBytes;
+    uint32_t capacityBytes;
+};
+
+struct __attribute__((packed)) RecordSessionInfo
+{
+    RecordMessage type;
+    uint16_t sessionId;
+    uint32_t sampleCount;
+    uint32_t ageMs; // Time since the first sample, lets the app recover wall-clock time
+    uint16_t samplePeriodUs;
+    float accelLsbPerG;
+    float gyroLsbPerDps;
+    uint8_t calibrated;
+    uint8_t complete; // 0 while still recording
+    uint32_t filledSamples; // Dropped samples replaced by repeating the previous one
+};
+
+struct __attribute__((packed)) RecordDataHeader
+{
+    RecordMessage type;
+    uint16_t sessionId;
+    uint32_t firstSample;
+    uint8_t sampleCount; // StreamSampleInt16 samples follow
+};
+
+struct __attribute__((packed)) RecordDownloadEnd
+{
+    RecordMessage type;
+    uint16_t sessionId;
+    uint32_t sampleCount;
+};
+
+struct __attribute__((packed)) RecordErrorMessage
+{
+    RecordMessage type;
+    RecordError error;
+};
@@ -0,0 +1,255 @@
+#include <cstring>
+#include "recordingTransfer.h"
+
+constexpr char RecordingTransfer::MODULE_NAME[];
+
+RecordingTransfer::RecordingTransfer(SessionRecorder &recorder, FrameSink &sink) noexcept
+    : recorder(recorder),
+      sink(sink),
+      payloadLimit(0),
+      frameSamples(1),
+      downloading(false),
+      downloadId(0),
+      ackedSample(0),
+      sentSample(0),
+      lastProgress(0),
+      resent(0)
+{
+    setMtu(Config::Stream::DEFAULT_MTU);
+}
+
+bool RecordingTransfer::enqueue(const uint8_t *data, size_t length)
+{
+    if (!data || length == 0)
+        return false;
+
+    Request request{static_cast<RecordCommand>(data[0]), 0, 0};
+    if (request.command == RecordCommand::DOWNLOAD || request.command == RecordCommand::ACK)
+    {
+        if (length < sizeof(RecordDownloadRequest))
+            return false;
+
+        RecordDownloadRequest message;
+        memcpy(&message, data, sizeof(message));
+        request.sessionId = message.sessionId;
+        request.sample = message.sample;
+    }
+
+    return requests.push(request);
+}
+
+void RecordingTransfer::setMtu(uint16_t mtu)
+{
+    size_t payload = mtu - Config::Stream::ATT_OVERHEAD;
+    if (payload > Config::Stream::MAX_FRAME_SIZE)
+        payload = Config::Stream::MAX_FRAME_SIZE;
+    payloadLimit = payload;
+
+    frameSamples = (payload - sizeof(RecordDataHeader)) / sizeof(StreamSampleInt16);
+    if (frameSamples == 0)
+        frameSamples = 1;
+    if (frameSamples > UINT8_MAX)
+        frameSamples = UINT8_MAX;
+}
+
+void RecordingTransfer::reset()
+{
+    Request request;
+    while (requests.pop(request))
+    {
+    }
+    downloading = false;
+}
+
+void RecordingTransfer::process(uint32_t now)
+{
+    Request request;
+    while (requests.pop(request))
+    {
+        handle(request, now);
+    }
+
+    pump(now);
+}
+
+void RecordingTransfer::handle(const Request &request, uint32_t now)
+{
+    switch (request.command)
+    {
+    case RecordCommand::START:
+    {
+        Error error = recorder.start();
+        if (error.isError())
+        {
+            Logger::error(MODULE_NAME, error.message());
+            sendError(recorder.hasStorage() ? RecordError::STORAGE_FULL : RecordError::NO_STORAGE);
+            break;
+        }
+        sendStatus();
+        break;
+    }
+    case RecordCommand::STOP:
+        recorder.stop();
+        sendStatus();
+        break;
+    case RecordCommand::STATUS:
+        sendStatus();
+        break;
+    case RecordCommand::LIST:
+        sendSessionList();
+        break;
+    case RecordCommand::ERASE_ALL:
+        downloading = false;
+        recorder.eraseAll();
+        sendStatus();
+        break;
+    case RecordCommand::DOWNLOAD:
+    {
+        const RecordedSession *session = recorder.findSession(request.sessionId);
+        if (!session)
+        {
+            sendError(RecordError::UNKNOWN_SESSION);
+            break;
+        }
+        if (!session->complete)
+        {
+            sendError(RecordError::BUSY);
+            break;
+        }
+
+        downloading = true;
+        downloadId = request.sessionId;
+        ackedSample = request.sample < session->sampleCount ? request.sample : session->sampleCount;
+        sentSample = ackedSample;
+        lastProgress = now;
+        Logger::logf(Logger::Level::INFO, MODULE_NAME, "Download of session %u from sample %lu",
+                     downloadId, static_cast<unsigned long>(ackedSample));
+        break;
+    }
+    case RecordCommand::ACK:
+        if (!downloading || request.sessionId != downloadId)
+            break;
+
+        if (request.sample > ackedSample && request.sample <= sentSample)
+        {
+            ackedSample = request.sample;
+            lastProgress = now;
+        }
+        else if (request.sample == ackedSample && sentSample > ackedSample)
+        {
+            // The app saw a gap: go back to the first unacknowledged sample
+            sentSample = ackedSample;
+            lastProgress = now;
+            resent++;
+        }
+        break;
+    default:
+        Logger::logf(Logger::Level::ERROR, MODULE_NAME, "Unknown record command: %d",
+                     static_cast<int>(request.command));
+        sendError(RecordError::UNKNOWN_COMMAND);
+        break;
+    }
+}
+
+void RecordingTransfer::pump(uint32_t now)
+{
+    if (!downloading)
+        return;
+
+    const RecordedSession *session = recorder.findSession(downloadId);
+    if (!session)
+    {
+        downloading = false;
+        sendError(RecordError::UNKNOWN_SESSION);
+        return;
+    }
+
+    if (ackedSample >= session->sampleCount)
+    {
+        RecordDownloadEnd end{RecordMessage::DOWNLOAD_END, downloadId, session->sampleCount};
+        sink.sendFrame(reinterpret_cast<const uint8_t *>(&end), sizeof(end));
+        downloading = false;
+        Logger::logf(Logger::Level::INFO, MODULE_NAME, "Download of session %u complete, %lu frames resent",
+                     downloadId, static_cast<unsigned long>(resent));
+        return;
+    }
+
+    if (sentSample > ackedSample && now - lastProgress >= Config::Recording::ACK_TIMEOUT)
+    {
+        sentSample = ackedSample;
+        lastProgress = now;
+        resent++;
+    }
+
+    uint32_t windowEnd = ackedSample + Config::Recording::WINDOW_FRAMES * frameSamples;
+    if (windowEnd > session->sampleCount)
+        windowEnd = session->sampleCount;
+
+    while (sentSample < windowEnd)
+    {
+        size_t samples = windowEnd - sentSample;
+        if (samples > frameSamples)
+            samples = frameSamples;
+
+        sendData(*session, sentSample, samples);
+        sentSample += samples;
+    }
+}
+
+void RecordingTransfer::sendStatus()
+{
+    RecordStatus status{RecordMessage::STATUS,
+                        static_cast<uint8_t>(recorder.isRecording() ? 1 : 0),
+                        recorder.activeSessionId(),
+                        static_cast<uint8_t>(recorder.sessionCount()),
+                        recorder.usedBytes(),
+                        recorder.capacityBytes()};
+    sink.sendFrame(reinterpret_cast<const uint8_t *>(&status), sizeof(status));
+}
+
+void RecordingTransfer::sendSessionList()
+{
+    // A truncated notification would be dropped by the app and the list
+    // would come back empty, so refuse until a larger MTU is negotiated
+    if (sizeof(RecordSessionInfo) > payloadLimit)
+    {
+        sendError(RecordError::MTU_TOO_SMALL);
+        return;
+    }
+
+    uint32_t now = millis();
+    for (size_t i = 0; i < recorder.sessionCount(); i++)
+    {
+        const RecordedSession &session = recorder.session(i);
+        RecordSessionInfo info{RecordMessage::SESSION_INFO,
+                               session.id,
+                               session.sampleCount,
+                               now - session.startMs,
+                               session.samplePeriodUs,
+                               session.accelLsbPerG,
+                               session.gyroLsbPerDps,
+                               static_cast<uint8_t>(session.calibrated ? 1 : 0),
+                               static_cast<uint8_t>(session.complete ? 1 : 0),
+                               session.filledSamples};
+        sink.sendFrame(reinterpret_cast<const uint8_t *>(&info), sizeof(info));
+    }
+
+    RecordMessage end = RecordMessage::LIST_END;
+    sink.sendFrame(reinterpret_cast<const uint8_t *>(&end), sizeof(end));
+}
+
+void RecordingTransfer::sendError(RecordError error)
+{
+    RecordErrorMessage message{RecordMessage::ERROR, error};
+    sink.sendFrame(reinterpret_cast<const uint8_t *>(&message), sizeof(message));
+}
+
+void RecordingTransfer::sendData(const RecordedSession &session, uint32_t first, size_t samples)
+{
+    RecordDataHeader header{RecordMessage::DATA, session.id, first, static_cast<uint8_t>(samples)};
+    memcpy(frame, &header, sizeof(header));
+
+    size_t payload = samples * sizeof(StreamSampleInt16);
+    memcpy(frame + sizeof(header), recorder.samples(session) + first, payload);
+    sink.sendFrame(frame, sizeof(header) + payload);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "config/config.h"
+#include "storage/recordingProtocol.h"
+#include "storage/sessionRecorder.h"
+#include "stream/frameSink.h"
+#include "utils/spscRing.h"
+#include "utils/logger.h"
+
+/**
+ * @brief Serves the recording characteristic: commands and bulk download
+ *
+ * Commands are written by the BLE task and queued; process() runs them and
+ * pumps the download window from the comms task, so the recorder is only
+ * ever touched by one task. See recordingProtocol.h for the wire format.
+ */
+class RecordingTransfer
+{
+public:
+    static constexpr char MODULE_NAME[] = "TRANSFER";
+
+    RecordingTransfer(SessionRecorder &recorder, FrameSink &sink) noexcept;
+
+    /**
+     * @brief Queues a command written by the app (BLE task)
+     * @return false if the command is malformed or the queue is full
+     */
+    bool enqueue(const uint8_t *data, size_t length);
+
+    void setMtu(uint16_t mtu);
+
+    /**
+     * @brief Aborts a running download, e.g. after a disconnect
+     */
+    void reset();
+
+    /**
+     * @brief Runs queued commands and sends the next DATA frames (comms task)
+     */
+    void process(uint32_t now);
+
+    uint32_t resentFrames() const { return resent; }
+
+private:
+    struct Request
+    {
+        RecordCommand command;
+        uint16_t sessionId;
+        uint32_t sample;
+    };
+
+    SessionRecorder &recorder;
+    FrameSink &sink;
+    SpscRing<Request, Config::Recording::COMMAND_QUEUE_SIZE> requests;
+    size_t payloadLimit;
+    size_t frameSamples;
+    bool downloading;
+    uint16_t downloadId;
+    uint32_t ackedSample;
+    uint32_t sentSample;
+    uint32_t lastProgress;
+    uint32_t resent;
+    uint8_t frame[Config::Stream::MAX_FRAME_SIZE];
+
+    void handle(const Request &request, uint32_t now);
+    void pump(uint32_t now);
+    void sendStatus();
+    void sendSessionList();
+    void sendError(RecordError error);
+    void sendData(const RecordedSession &session, uint32_t first, size_t samples);
+};
@@ -0,0 +1,189 @@
+#include <esp_heap_caps.h>
+#include <esp_random.h>
+#include "sessionRecorder.h"
+#include "stream/quantize.h"
+
+constexpr char SessionRecorder::MODULE_NAME[];
+
+SessionRecorder::SessionRecorder() noexcept
+    : arena(nullptr),
+      capacitySlots(0),
+      usedSlots(0),
+      sessions{},
+      count(0),
+      recording(false),
+      nextId(0),
+      accelLsbPerG(Config::IMU::Values::ACCEL_LSB_PER_G),
+      gyroLsbPerDps(Config::IMU::Values::GYRO_LSB_PER_DPS)
+{
+}
+
+Error SessionRecorder::begin()
+{
+    arena = static_cast<StreamSampleInt16 *>(
+        heap_caps_malloc(Config::Recording::ARENA_SIZE, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT));
+    if (!arena)
+    {
+        return Error(Error::Code::MEMORY_ERROR, "Failed to allocate recording arena in PSRAM");
+    }
+
+    capacitySlots = Config::Recording::ARENA_SIZE / sizeof(StreamSampleInt16);
+
+    // Random base so a reboot does not reuse IDs the app already imported
+    nextId = static_cast<uint16_t>(esp_random());
+    Logger::logf(Logger::Level::INFO, MODULE_NAME, "Recording arena: %lu samples",
+                 static_cast<unsigned long>(capacitySlots));
+    return Error(Error::Code::NONE, "Success");
+}
+
+Error SessionRecorder::start()
+{
+    if (!arena)
+    {
+        return Error(Error::Code::INVALID_STATE, "No recording storage");
+    }
+    if (recording)
+    {
+        return Error(Error::Code::NONE, "Already recording");
+    }
+    if (!openSession())
+    {
+        return Error(Error::Code::MEMORY_ERROR, "Recording storage full");
+    }
+
+    recording = true;
+    Logger::logf(Logger::Level::INFO, MODULE_NAME, "Recording session %u", sessions[count - 1].id);
+    return Error(Error::Code::NONE, "Success");
+}
+
+void SessionRecorder::stop()
+{
+    if (!recording)
+        return;
+
+    closeSession();
+    recording = false;
+    Logger::logf(Logger::Level::INFO, MODULE_NAME, "Recording stopped, %u sessions, %lu bytes used",
+                 static_cast<unsigned>(count), static_cast<unsigned long>(usedBytes()));
+}
+
+void SessionRecorder::eraseAll()
+{
+    recording = false;
+    count = 0;
+    usedSlots = 0;
+    Logger::info(MODULE_NAME, "Recordings erased");
+}
+
+void SessionRecorder::setScale(float accelLsbPerG, float gyroLsbPerDps)
+{
+    this->accelLsbPerG = accelLsbPerG;
+    this->gyroLsbPerDps = gyroLsbPerDps;
+}
+
+const RecordedSession *SessionRecorder::findSession(uint16_t id) const
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        if (sessions[i].id == id)
+            return &sessions[i];
+    }
+    return nullptr;
+}
+
+bool SessionRecorder::openSession()
+{
+    if (count >= Config::Recording::MAX_SESSIONS || usedSlots >= capacitySlots)
+        return false;
+
+    RecordedSession &session = sessions[count++];
+    session = RecordedSession{};
+    // 0 is the status packet's "not recording", never a session
+    if (nextId == 0)
+        nextId++;
+    session.id = nextId++;
+    session.firstSlot = usedSlots;
+    return true;
+}
+
+void SessionRecorder::closeSession()
+{
+    RecordedSession &session = sessions[count - 1];
+    session.complete = true;
+
+    // Drop sessions that never saw a sample
+    if (session.sampleCount == 0)
+        count--;
+}
+
+bool SessionRecorder::append(const StreamSampleInt16 &packed)
+{
+    if (usedSlots >= capacitySlots)
+        return false;
+
+    arena[usedSlots++] = packed;
+    sessions[count - 1].sampleCount++;
+    return true;
+}
+
+bool SessionRecorder::record(const CorrectedSample &sample, uint32_t periodUs)
+{
+    if (!recording)
+        return false;
+
+    RecordedSession *session = &sessions[count - 1];
+    if (session->sampleCount > 0)
+    {
+        uint32_t gap = sample.imu.index - session->nextIndex;
+        if (gap > Config::Recording::MAX_GAP_FILL || periodUs != session->samplePeriodUs ||
+            accelLsbPerG != session->accelLsbPerG || gyroLsbPerDps != session->gyroLsbPerDps ||
+            sample.isCorrected != session->calibrated)
+        {
+            closeSession();
+            if (!openSession())
+            {
+                recording = false;
+                Logger::error(MODULE_NAME, "Session table full, recording stopped");
+                return false;
+            }
+            session = &sessions[count - 1];
+        }
+        else
+        {
+            // Keep the timeline implicit: repeat the last sample for dropped indices
+            StreamSampleInt16 previous = arena[usedSlots - 1];
+            for (uint32_t i = 0; i < gap; i++)
+            {
+                if (!append(previous))
+                {
+                    closeSession();
+                    recording = false;
+                    Logger::error(MODULE_NAME, "Recording arena full, recording stopped");
+                    return false;
+                }
+                session->filledSamples++;
+            }
+        }
+    }
+
+    if (session->sampleCount == 0)
+    {
+        session->startMs = static_cast<uint32_t>(sample.imu.timestampUs / 1000);
+        session->samplePeriodUs = static_cast<uint16_t>(periodUs);
+        session->accelLsbPerG = accelLsbPerG;
+        session->gyroLsbPerDps = gyroLsbPerDps;
+        session->calibrated = sample.isCorrected;
+    }
+
+    StreamSampleInt16 packed = quantizeSample(sample.imu.accel, sample.imu.gyro, accelLsbPerG, gyroLsbPerDps);
+    if (!append(packed))
+    {
+        closeSession();
+        recording = false;
+        Logger::error(MODULE_NAME, "Recording arena full, recording stopped");
+        return false;
+    }
+
+    session->nextIndex = sample.imu.index + 1;
+    return true;
+}
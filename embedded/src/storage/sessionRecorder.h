@@ -0,0 +1,93 @@
+#pragma once
+#include "config/config.h"
+#include "sensor/correctedSample.h"
+#include "stream/streamProtocol.h"
+#include "utils/logger.h"
+#include "utils/error.h"
+
+/**
+ * @brief One recorded session inside the PSRAM arena
+ *
+ * Samples of a session are contiguous in the arena, starting at firstSlot.
+ */
+struct RecordedSession
+{
+    uint16_t id;
+    uint32_t firstSlot;
+    uint32_t sampleCount;
+    uint32_t nextIndex;      // Sampler index expected for the next sample
+    uint32_t startMs;        // Device time of the first sample
+    uint16_t samplePeriodUs;
+    float accelLsbPerG;
+    float gyroLsbPerDps;
+    bool calibrated;
+    bool complete;
+    uint32_t filledSamples;
+};
+
+/**
+ * @brief Records full-rate samples to PSRAM independent of the BLE link
+ *
+ * Samples are stored as StreamSampleInt16 with the IMU scale of the active
+ * profile, so a session costs 12 bytes per sample. Short sampler gaps are
+ * bridged by repeating the previous sample to keep the timeline implicit; a
+ * longer gap, a rate or scale change or switching between corrected and
+ * uncorrected samples closes the session and opens the next one. Recording
+ * stops when the arena or the session table is full.
+ *
+ * Not thread-safe: owned by the comms task.
+ */
+class SessionRecorder
+{
+public:
+    static constexpr char MODULE_NAME[] = "RECORDER";
+
+    SessionRecorder() noexcept;
+
+    /**
+     * @brief Allocates the arena in PSRAM
+     */
+    Error begin();
+
+    Error start();
+    void stop();
+    void eraseAll();
+
+    /**
+     * @brief Appends a sample to the active session
+     * @return false if not recording or out of space
+     */
+    bool record(const CorrectedSample &sample, uint32_t periodUs);
+
+    /**
+     * @brief Sets the quantization for subsequent samples
+     */
+    void setScale(float accelLsbPerG, float gyroLsbPerDps);
+
+    bool hasStorage() const { return arena != nullptr; }
+    bool isRecording() const { return recording; }
+    uint16_t activeSessionId() const { return recording ? sessions[count - 1].id : 0; } // Session ids are never 0
+
+    size_t sessionCount() const { return count; }
+    const RecordedSession &session(size_t i) const { return sessions[i]; }
+    const RecordedSession *findSession(uint16_t id) const;
+    const StreamSampleInt16 *samples(const RecordedSession &session) const { return arena + session.firstSlot; }
+
+    uint32_t usedBytes() const { return usedSlots * sizeof(StreamSampleInt16); }
+    uint32_t capacityBytes() const { return capacitySlots * sizeof(StreamSampleInt16); }
+
+private:
+    StreamSampleInt16 *arena;
+    uint32_t capacitySlots;
+    uint32_t usedSlots;
+    RecordedSession sessions[Config::Recording::MAX_SESSIONS];
+    size_t count;
+    bool recording;
+    uint16_t nextId;
+    float accelLsbPerG;
+    float gyroLsbPerDps;
+
+    bool openSession();
+    void closeSession();
+    bool append(const StreamSampleInt16 &packed);
+};
@@ -0,0 +1,13 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Receives completed frames for transmission, e.g. as BLE notifications
+ */
+class FrameSink
+{
+public:
+    virtual ~FrameSink() = default;
+    virtual void sendFrame(const uint8_t *data, size_t length) = 0;
+};
@@ -0,0 +1,25 @@
+#pragma once
+#include <cstdint>
+#include "stream/streamProtocol.h"
+#include "utils/vector3d.h"
+
+inline int16_t quantize(float value, float lsbPerUnit)
+{
+    float scaled = value * lsbPerUnit;
+    if (scaled >= INT16_MAX)
+        return INT16_MAX;
+    if (scaled <= INT16_MIN)
+        return INT16_MIN;
+    return static_cast<int16_t>(scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f);
+}
+
+inline StreamSampleInt16 quantizeSample(const Vector3D &accel, const Vector3D &gyro,
+                                        float accelLsbPerG, float gyroLsbPerDps)
+{
+    return StreamSampleInt16{quantize(accel.x, accelLsbPerG),
+                             quantize(accel.y, accelLsbPerG),
+                             quantize(accel.z, accelLsbPerG),
+                             quantize(gyro.x, gyroLsbPerDps),
+                             quantize(gyro.y, gyroLsbPerDps),
+                             quantize(gyro.z, gyroLsbPerDps)};
+}
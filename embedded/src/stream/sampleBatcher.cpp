@@ -0,0 +1,221 @@
+#include "sampleBatcher.h"
+#include "stream/quantize.h"
+
+constexpr char SampleBatcher::MODULE_NAME[];
+
+namespace
+{
+    size_t payloadForMtu(uint16_t mtu)
+    {
+        size_t payload = mtu > Config::Stream::ATT_OVERHEAD ? mtu - Config::Stream::ATT_OVERHEAD : 0;
+        return payload < Config::Stream::MAX_FRAME_SIZE ? payload : Config::Stream::MAX_FRAME_SIZE;
+    }
+
+    inline size_t writeVarint(uint8_t *out, uint32_t value)
+    {
+        size_t n = 0;
+        while (value >= 0x80)
+        {
+            out[n++] = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        out[n++] = static_cast<uint8_t>(value);
+        return n;
+    }
+
+    inline size_t writeDelta(uint8_t *out, int16_t current, int16_t previous)
+    {
+        int32_t delta = static_cast<int32_t>(current) - previous;
+        uint32_t zigzag = (static_cast<uint32_t>(delta) << 1) ^ static_cast<uint32_t>(delta >> 31);
+        return writeVarint(out, zigzag);
+    }
+}
+
+SampleBatcher::SampleBatcher(FrameSink &sink) noexcept
+    : sink(sink),
+      sampleFormat(StreamFormat::FLOAT32),
+      accelLsbPerG(Config::IMU::Values::ACCEL_LSB_PER_G),
+      gyroLsbPerDps(Config::IMU::Values::GYRO_LSB_PER_DPS),
+      unitTag(0),
+      payloadLimit(payloadForMtu(Config::Stream::DEFAULT_MTU)),
+      pendingLimit(payloadLimit),
+      used(0),
+      count(0),
+      sequence(0),
+      nextIndex(0),
+      openedAt(0),
+      previous(),
+      streamStats()
+{
+}
+
+void SampleBatcher::setMtu(uint16_t mtu)
+{
+    pendingLimit = payloadForMtu(mtu);
+    Logger::logf(Logger::Level::INFO, MODULE_NAME, "MTU %u, %u bytes per frame%s",
+                 mtu, static_cast<unsigned>(pendingLimit),
+                 canStream() ? "" : ", too small to stream");
+}
+
+void SampleBatcher::setFormat(StreamFormat format)
+{
+    if (format == sampleFormat)
+        return;
+
+    flush();
+    sampleFormat = format;
+}
+
+void SampleBatcher::setScale(float accelLsbPerG, float gyroLsbPerDps)
+{
+    flush();
+    this->accelLsbPerG = accelLsbPerG;
+    this->gyroLsbPerDps = gyroLsbPerDps;
+}
+
+void SampleBatcher::reset()
+{
+    count = 0;
+    used = 0;
+    sequence = 0;
+    streamStats = StreamStats();
+}
+
+bool SampleBatcher::canStream() const noexcept
+{
+    return sizeof(StreamFrameHeader) + firstSampleSize() <= pendingLimit &&
+           sizeof(StreamSessionHeader) <= pendingLimit;
+}
+
+size_t SampleBatcher::firstSampleSize() const
+{
+    switch (sampleFormat)
+    {
+    case StreamFormat::INT16:
+    case StreamFormat::INT16_DELTA:
+        return sizeof(StreamSampleInt16);
+    case StreamFormat::FUSION:
+        return sizeof(StreamSampleFusion);
+    default:
+        return sizeof(StreamSampleFloat);
+    }
+}
+
+size_t SampleBatcher::maxSampleSize() const
+{
+    if (sampleFormat == StreamFormat::INT16_DELTA && count > 0)
+        return STREAM_DELTA_MAX_SAMPLE_SIZE;
+    return firstSampleSize();
+}
+
+size_t SampleBatcher::encodeSample(const CorrectedSample &sample, uint8_t *out)
+{
+    const ImuSample &imu = sample.imu;
+    if (sampleFormat == StreamFormat::FLOAT32)
+    {
+        StreamSampleFloat packed{imu.accel.x, imu.accel.y, imu.accel.z,
+                                 imu.gyro.x, imu.gyro.y, imu.gyro.z};
+        memcpy(out, &packed, sizeof(packed));
+        return sizeof(packed);
+    }
+
+    if (sampleFormat == StreamFormat::FUSION)
+    {
+        const Quaternion &q = sample.orientation;
+        StreamSampleFusion packed{quantize(q.w, Config::Fusion::QUATERNION_SCALE),
+                                  quantize(q.x, Config::Fusion::QUATERNION_SCALE),
+                                  quantize(q.y, Config::Fusion::QUATERNION_SCALE),
+                                  quantize(q.z, Config::Fusion::QUATERNION_SCALE),
+                                  quantize(sample.linearAccel.x, accelLsbPerG),
+                                  quantize(sample.linearAccel.y, accelLsbPerG),
+                                  quantize(sample.linearAccel.z, accelLsbPerG)};
+        memcpy(out, &packed, sizeof(packed));
+        return sizeof(packed);
+    }
+
+    StreamSampleInt16 packed = quantizeSample(imu.accel, imu.gyro, accelLsbPerG, gyroLsbPerDps);
+    if (sampleFormat == StreamFormat::INT16 || count == 0)
+    {
+        memcpy(out, &packed, sizeof(packed));
+        previous = packed;
+        return sizeof(packed);
+    }
+
+    size_t n = 0;
+    n += writeDelta(out + n, packed.accX, previous.accX);
+    n += writeDelta(out + n, packed.accY, previous.accY);
+    n += writeDelta(out + n, packed.accZ, previous.accZ);
+    n += writeDelta(out + n, packed.gyrX, previous.gyrX);
+    n += writeDelta(out + n, packed.gyrY, previous.gyrY);
+    n += writeDelta(out + n, packed.gyrZ, previous.gyrZ);
+    previous = packed;
+    return n;
+}
+
+void SampleBatcher::openFrame(const ImuSample &sample, uint32_t samplePeriodUs)
+{
+    payloadLimit = pendingLimit;
+    used = sizeof(StreamFrameHeader);
+
+    StreamFrameHeader *h = header();
+    h->format = sampleFormat;
+    h->sampleCount = 0;
+    h->sequence = sequence;
+    h->baseTimestampUs = static_cast<uint32_t>(sample.timestampUs);
+    h->samplePeriodUs = static_cast<uint16_t>(samplePeriodUs);
+    h->unit = unitTag;
+    openedAt = millis();
+}
+
+void SampleBatcher::add(const CorrectedSample &sample, uint32_t samplePeriodUs)
+{
+    if (count > 0 && (sample.imu.index != nextIndex || header()->samplePeriodUs != samplePeriodUs))
+    {
+        flush();
+    }
+
+    if (count == 0)
+    {
+        if (!canStream())
+        {
+            streamStats.refused++;
+            return;
+        }
+        openFrame(sample.imu, samplePeriodUs);
+    }
+
+    used += encodeSample(sample, buffer + used);
+    count++;
+    nextIndex = sample.imu.index + 1;
+
+    // Close the frame once the worst-case next sample might not fit
+    if (count == UINT8_MAX || used + maxSampleSize() > payloadLimit)
+    {
+        flush();
+    }
+}
+
+void SampleBatcher::flushIfStale(uint32_t now)
+{
+    if (count > 0 && now - openedAt >= Config::Stream::MAX_FRAME_LATENCY)
+    {
+        flush();
+    }
+}
+
+void SampleBatcher::flush()
+{
+    if (count == 0)
+        return;
+
+    header()->sampleCount = count;
+    sink.sendFrame(buffer, used);
+
+    streamStats.frames++;
+    streamStats.samples += count;
+    streamStats.bytes += used;
+
+    count = 0;
+    used = 0;
+    sequence++;
+}
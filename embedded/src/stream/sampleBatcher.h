@@ -0,0 +1,118 @@
+#pragma once
+#include "config/config.h"
+#include "sensor/correctedSample.h"
+#include "stream/frameSink.h"
+#include "stream/streamProtocol.h"
+#include "utils/logger.h"
+
+/**
+ * @brief Byte counters used to verify the airtime saved by an encoding
+ */
+struct StreamStats
+{
+    uint32_t frames;
+    uint32_t samples;
+    uint32_t bytes; // Frame bytes including headers
+    uint32_t refused; // Samples not streamed because a frame would not fit the MTU
+
+    /**
+     * @brief Float32 sample bytes per byte actually sent, frame headers included
+     */
+    float compressionRatio() const
+    {
+        return bytes > 0 ? static_cast<float>(samples) * sizeof(StreamSampleFloat) / bytes : 0.0f;
+    }
+};
+
+/**
+ * @brief Packs consecutive samples into MTU-sized stream frames
+ *
+ * A frame is closed and handed to the sink when the next sample might not
+ * fit, when the next sample is not contiguous with it (dropped samples would
+ * break the base + i * period timestamp reconstruction), or when it has
+ * been open for longer than Config::Stream::MAX_FRAME_LATENCY.
+ *
+ * Runs on the comms task, so encoding cost never delays IMU sampling.
+ */
+class SampleBatcher
+{
+public:
+    static constexpr char MODULE_NAME[] = "BATCH";
+
+    explicit SampleBatcher(FrameSink &sink) noexcept;
+
+    /**
+     * @brief Sets the frame size from the negotiated ATT MTU
+     *
+     * Takes effect from the next frame.
+     */
+    void setMtu(uint16_t mtu);
+
+    /**
+     * @brief Selects the sample encoding, flushing the open frame first
+     */
+    void setFormat(StreamFormat format);
+
+    /**
+     * @brief Sets the quantization used by the int16 formats
+     */
+    void setScale(float accelLsbPerG, float gyroLsbPerDps);
+
+    [[nodiscard]] StreamFormat format() const noexcept { return sampleFormat; }
+
+    /**
+     * @brief Whether a session header and a frame holding one sample of the
+     * current format fit the MTU set last
+     *
+     * Not the case at the default ATT MTU of 23: the stack would cut longer
+     * notifications and the app would get corrupt frames. Until a larger MTU
+     * is negotiated nothing is streamed and add() counts the samples as
+     * refused; the per-axis characteristics still work.
+     */
+    [[nodiscard]] bool canStream() const noexcept;
+
+    /**
+     * @brief Sets the unit byte of the frames, from the next frame
+     */
+    void setUnitTag(uint8_t tag) { unitTag = tag; }
+
+    /**
+     * @brief Discards any open frame, restarts the sequence counter and stats
+     */
+    void reset();
+
+    void add(const CorrectedSample &sample, uint32_t samplePeriodUs);
+
+    /**
+     * @brief Sends the open frame if it is older than the latency limit
+     * @param now Current time in ms
+     */
+    void flushIfStale(uint32_t now);
+
+    void flush();
+
+    [[nodiscard]] const StreamStats &stats() const noexcept { return streamStats; }
+
+private:
+    FrameSink &sink;
+    uint8_t buffer[Config::Stream::MAX_FRAME_SIZE];
+    StreamFormat sampleFormat;
+    float accelLsbPerG;
+    float gyroLsbPerDps;
+    uint8_t unitTag;
+    size_t payloadLimit;   // Max frame bytes for the negotiated MTU
+    size_t pendingLimit;   // Applied when the next frame opens
+    size_t used;           // Bytes in the open frame, header included
+    uint8_t count;
+    uint16_t sequence;
+    uint32_t nextIndex;
+    uint32_t openedAt;
+    StreamSampleInt16 previous; // Last sample of the open frame, for delta coding
+    StreamStats streamStats;
+
+    void openFrame(const ImuSample &sample, uint32_t samplePeriodUs);
+    size_t firstSampleSize() const;
+    size_t maxSampleSize() const;
+    size_t encodeSample(const CorrectedSample &sample, uint8_t *out);
+    StreamFrameHeader *header() { return reinterpret_cast<StreamFrameHeader *>(buffer); }
+};
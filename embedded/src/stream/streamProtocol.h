@@ -0,0 +1,80 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * @brief Wire format of the batched sample stream characteristic
+ *
+ * Every notification is one frame: a StreamFrameHeader followed by
+ * sampleCount samples in the encoding selected by format. All fields are
+ * little-endian. Sample i of a frame was taken at
+ * baseTimestampUs + i * samplePeriodUs.
+ *
+ * A StreamSessionHeader (first byte SESSION_HEADER) is sent whenever
+ * streaming starts, the format, the acquisition profile, the calibration or
+ * the unit role changes. It carries the scale needed to decode quantized
+ * formats, and its version tells the frame header layout: version 1 frames
+ * end after samplePeriodUs.
+ */
+enum class StreamFormat : uint8_t
+{
+    FLOAT32 = 1,          // StreamSampleFloat per sample
+    INT16 = 2,            // StreamSampleInt16 per sample, scaled by the session header
+    INT16_DELTA = 3,      // First sample as StreamSampleInt16, then zig-zag varint deltas
+    FUSION = 4,           // StreamSampleFusion per sample: orientation and linear acceleration
+    SESSION_HEADER = 0x80 // StreamSessionHeader, not a sample frame
+};
+
+static constexpr uint8_t STREAM_PROTOCOL_VERSION = 2;
+
+/**
+ * INT16_DELTA frames start with one absolute StreamSampleInt16. Every
+ * following sample stores, per channel in StreamSampleInt16 order, the
+ * difference to the previous sample as a zig-zag encoded LEB128 varint
+ * (7 bits per byte, low bits first, high bit set on all but the last byte).
+ * Each frame is self-contained so a lost frame does not corrupt the next.
+ */
+static constexpr size_t STREAM_DELTA_MAX_SAMPLE_SIZE = 6 * 3; // 17-bit zig-zag deltas, 3 bytes each
+
+struct __attribute__((packed)) StreamFrameHeader
+{
+    StreamFormat format;
+    uint8_t sampleCount;
+    uint16_t sequence;        // Increments per frame, gaps mean lost frames
+    uint32_t baseTimestampUs; // Device time of the first sample, low 32 bits of the time sync clock
+    uint16_t samplePeriodUs;
+    uint8_t unit;             // UnitRole in the top 2 bits, low 6 bits of the unit ID; version 2
+};
+
+struct __attribute__((packed)) StreamSampleFloat
+{
+    float accX, accY, accZ; // g
+    float gyrX, gyrY, gyrZ; // °/s
+};
+
+struct __attribute__((packed)) StreamSampleInt16
+{
+    int16_t accX, accY, accZ; // value = raw / accelLsbPerG
+    int16_t gyrX, gyrY, gyrZ; // value = raw / gyroLsbPerDps
+};
+
+struct __attribute__((packed)) StreamSampleFusion
+{
+    int16_t qW, qX, qY, qZ;   // value = raw / Config::Fusion::QUATERNION_SCALE
+    int16_t linX, linY, linZ; // World frame, gravity removed, value = raw / accelLsbPerG
+};
+
+struct __attribute__((packed)) StreamSessionHeader
+{
+    StreamFormat type; // Always SESSION_HEADER
+    uint8_t version;   // STREAM_PROTOCOL_VERSION
+    StreamFormat sampleFormat;
+    uint8_t calibrationValid;
+    float accelLsbPerG;
+    float gyroLsbPerDps;
+    float accelScale;   // Mean diagonal of the accel correction matrix
+    float accelBias[3]; // Negated accel correction offset
+    float gyroBias[3];
+    uint8_t profile; // AcquisitionProfile, appended after the first release
+    uint8_t role;    // UnitRole, version 2
+    uint32_t unitId; // Device half of the factory MAC, version 2
+};
@@ -11,7 +11,8 @@ public:
         IMU_INIT_FAILED,
         CALIBRATION_FAILED,
         INVALID_STATE,
-        MEMORY_ERROR
+        MEMORY_ERROR,
+        IO_ERROR
     };
 
     Error(Code code, const char *message) : code_(code), message_(message) {}
@@ -0,0 +1,308 @@
+#include "logger.h"
+#include <soc/soc_memory_layout.h>
+
+constexpr char Logger::MODULE_NAME[];
+
+MpscRing<Logger::Record, Config::Logging::RING_CAPACITY> Logger::records;
+TaskHandle_t Logger::drainHandle = nullptr;
+
+namespace
+{
+    const char *levelName(Logger::Level level)
+    {
+        switch (level)
+        {
+        case Logger::Level::DEBUG:
+            return "DEBUG";
+        case Logger::Level::INFO:
+            return "INFO";
+        case Logger::Level::WARN:
+            return "WARN";
+        case Logger::Level::ERROR:
+            return "ERROR";
+        }
+        return "?";
+    }
+
+    template <typename V>
+    V readValue(const uint8_t *data)
+    {
+        V value;
+        memcpy(&value, data, sizeof(V));
+        return value;
+    }
+
+    bool hasLength(const char *length, size_t lengthSize, const char *expected)
+    {
+        return lengthSize == strlen(expected) && strncmp(length, expected, lengthSize) == 0;
+    }
+
+    size_t clampWritten(int written, size_t size)
+    {
+        if (written < 0 || size == 0)
+            return 0;
+        return static_cast<size_t>(written) < size ? written : size - 1;
+    }
+}
+
+Error Logger::begin()
+{
+    if (drainHandle)
+    {
+        return Error(Error::Code::INVALID_STATE, "Logger already running");
+    }
+
+    BaseType_t result = xTaskCreatePinnedToCore(drainTask, "log",
+                                                Config::Tasks::LOG_STACK_SIZE, nullptr,
+                                                Config::Tasks::LOG_PRIORITY, &drainHandle,
+                                                Config::Tasks::LOG_CORE);
+    if (result != pdPASS)
+    {
+        drainHandle = nullptr;
+        return Error(Error::Code::MEMORY_ERROR, "Failed to create log task");
+    }
+    return Error(Error::Code::NONE, "Success");
+}
+
+void Logger::flush()
+{
+    while (drainHandle && !records.empty())
+    {
+        vTaskDelay(1);
+    }
+}
+
+uint32_t Logger::droppedCount()
+{
+    return records.overflowCount();
+}
+
+void Logger::encodeString(Record &record, const char *value)
+{
+    // Literals live in flash for the lifetime of the program
+    if (!value || esp_ptr_in_drom(value))
+    {
+        encodeValue(record, ArgType::STRING, value);
+        return;
+    }
+
+    if (record.used + 2u > sizeof(record.args))
+    {
+        record.used = sizeof(record.args);
+        return;
+    }
+
+    size_t room = sizeof(record.args) - record.used - 2;
+    size_t length = strnlen(value, room);
+    record.args[record.used] = static_cast<uint8_t>(ArgType::TEXT);
+    memcpy(&record.args[record.used + 1], value, length);
+    record.args[record.used + 1 + length] = '\0';
+    record.used += 2 + length;
+    record.argCount++;
+}
+
+void Logger::enqueue(const Record &record)
+{
+    records.push(record);
+}
+
+void Logger::drainTask(void * /*param*/)
+{
+    Record record;
+    uint32_t reportedDrops = 0;
+
+    while (true)
+    {
+        while (records.pop(record))
+        {
+            write(record);
+        }
+
+        uint32_t drops = records.overflowCount();
+        if (drops != reportedDrops && Serial)
+        {
+            Serial.printf("[%lu][WARN][%s] %lu messages dropped\n", millis(), MODULE_NAME,
+                          static_cast<unsigned long>(drops - reportedDrops));
+            reportedDrops = drops;
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(Config::Tasks::LOG_INTERVAL));
+    }
+}
+
+void Logger::write(const Record &record)
+{
+    if (!Serial)
+        return; // Guard against uninitialized Serial
+
+    char message[Config::Logging::LINE_SIZE];
+    formatMessage(record, message, sizeof(message));
+
+    // Format: [TIME][LEVEL][MODULE] Message
+    Serial.printf("[%lu][%s][%s] %s\n", static_cast<unsigned long>(record.timeMs),
+                  levelName(record.level), record.module, message);
+}
+
+void Logger::formatMessage(const Record &record, char *out, size_t size)
+{
+    const char *p = record.format;
+    size_t pos = 0;
+    size_t offset = 0;
+    uint8_t consumed = 0;
+
+    while (*p && pos + 1 < size)
+    {
+        if (*p != '%')
+        {
+            out[pos++] = *p++;
+            continue;
+        }
+        if (p[1] == '%')
+        {
+            out[pos++] = '%';
+            p += 2;
+            continue;
+        }
+
+        // %[flags][width][.precision][length]conversion
+        const char *start = p++;
+        while (*p && strchr("-+ #0", *p))
+            p++;
+        while (*p >= '0' && *p <= '9')
+            p++;
+        if (*p == '.')
+        {
+            p++;
+            while (*p >= '0' && *p <= '9')
+                p++;
+        }
+        const char *length = p;
+        while (*p && strchr("hlLzjt", *p))
+            p++;
+        size_t lengthSize = p - length;
+        char conversion = *p;
+        if (!conversion)
+            break;
+        p++;
+
+        char spec[16];
+        size_t specSize = p - start;
+        bool available = consumed < record.argCount && specSize < sizeof(spec);
+        if (!available)
+        {
+            out[pos++] = '?';
+            continue;
+        }
+        memcpy(spec, start, specSize);
+        spec[specSize] = '\0';
+
+        auto type = static_cast<ArgType>(record.args[offset]);
+        const uint8_t *data = &record.args[offset + 1];
+        switch (type)
+        {
+        case ArgType::SIGNED:
+        case ArgType::UNSIGNED:
+        case ArgType::FLOAT:
+            offset += 1 + sizeof(uint64_t);
+            break;
+        case ArgType::STRING:
+            offset += 1 + sizeof(const char *);
+            break;
+        case ArgType::TEXT:
+            offset += 2 + strlen(reinterpret_cast<const char *>(data));
+            break;
+        case ArgType::POINTER:
+            offset += 1 + sizeof(uintptr_t);
+            break;
+        }
+        consumed++;
+
+        pos += formatArgument(out + pos, size - pos, spec, length, lengthSize, conversion, type, data);
+    }
+    out[pos] = '\0';
+}
+
+size_t Logger::formatArgument(char *out, size_t size, const char *spec, const char *length,
+                              size_t lengthSize, char conversion, ArgType type, const uint8_t *data)
+{
+    // Each value is passed as exactly the type its conversion expects
+    bool isInteger = type == ArgType::SIGNED || type == ArgType::UNSIGNED;
+    bool isLongLong = hasLength(length, lengthSize, "ll") || hasLength(length, lengthSize, "j");
+    bool isLong = hasLength(length, lengthSize, "l");
+    bool isSize = hasLength(length, lengthSize, "z") || hasLength(length, lengthSize, "t");
+    int written = -1;
+
+    switch (conversion)
+    {
+    case 'd':
+    case 'i':
+    {
+        if (!isInteger)
+            break;
+        int64_t value = type == ArgType::SIGNED ? readValue<int64_t>(data)
+                                                : static_cast<int64_t>(readValue<uint64_t>(data));
+        if (isLongLong)
+            written = snprintf(out, size, spec, static_cast<long long>(value));
+        else if (isLong)
+            written = snprintf(out, size, spec, static_cast<long>(value));
+        else if (isSize)
+            written = snprintf(out, size, spec, static_cast<ptrdiff_t>(value));
+        else
+            written = snprintf(out, size, spec, static_cast<int>(value));
+        break;
+    }
+    case 'u':
+    case 'o':
+    case 'x':
+    case 'X':
+    case 'c':
+    {
+        if (!isInteger)
+            break;
+        uint64_t value = readValue<uint64_t>(data);
+        if (isLongLong)
+            written = snprintf(out, size, spec, static_cast<unsigned long long>(value));
+        else if (isLong)
+            written = snprintf(out, size, spec, static_cast<unsigned long>(value));
+        else if (isSize)
+            written = snprintf(out, size, spec, static_cast<size_t>(value));
+        else if (conversion == 'c')
+            written = snprintf(out, size, spec, static_cast<int>(value));
+        else
+            written = snprintf(out, size, spec, static_cast<unsigned int>(value));
+        break;
+    }
+    case 'f':
+    case 'F':
+    case 'e':
+    case 'E':
+    case 'g':
+    case 'G':
+    case 'a':
+    case 'A':
+    {
+        if (type != ArgType::FLOAT)
+            break;
+        double value = readValue<double>(data);
+        if (hasLength(length, lengthSize, "L"))
+            written = snprintf(out, size, spec, static_cast<long double>(value));
+        else
+            written = snprintf(out, size, spec, value);
+        break;
+    }
+    case 's':
+        if (type == ArgType::STRING)
+            written = snprintf(out, size, spec, readValue<const char *>(data));
+        else if (type == ArgType::TEXT)
+            written = snprintf(out, size, spec, reinterpret_cast<const char *>(data));
+        break;
+    case 'p':
+        if (type == ArgType::POINTER)
+            written = snprintf(out, size, spec, reinterpret_cast<void *>(readValue<uintptr_t>(data)));
+        break;
+    }
+
+    if (written < 0)
+        written = snprintf(out, size, "?");
+    return clampWritten(written, size);
+}
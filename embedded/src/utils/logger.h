@@ -1,10 +1,36 @@
 #pragma once
 #include <Arduino.h>
+#include <cstring>
+#include <type_traits>
+#include "config/config.h"
+#include "utils/error.h"
+#include "utils/mpscRing.h"
 
+#ifndef CORE_DEBUG_LEVEL
+#define CORE_DEBUG_LEVEL 3
+#endif
+
+/**
+ * @brief Deferred logger, safe to call from hot paths and BLE callbacks
+ *
+ * A call only records the level, module, format pointer and the binary
+ * arguments into a lock-free ring; a low-priority task formats and writes
+ * the lines to Serial. Nothing is allocated and a caller never waits for the
+ * UART. When the ring is full the message is dropped and counted.
+ *
+ * Formats and module names must be string literals: only the pointer is
+ * kept. String arguments outside flash are copied into the record, so
+ * stack buffers may be logged too (truncated to the record size).
+ *
+ * Levels below CORE_DEBUG_LEVEL (1 = error ... 4 = debug) compile to
+ * nothing.
+ */
 class Logger
 {
 public:
-    enum class Level
+    static constexpr char MODULE_NAME[] = "LOG";
+
+    enum class Level : uint8_t
     {
         DEBUG, // Detailed information for debugging
         INFO,  // General operational messages
@@ -12,31 +38,31 @@ public:
         ERROR  // Error messages for actual problems
     };
 
-    // Main logging method with source location
-    static void log(Level level, const char *module, const char *message)
+    static constexpr bool isEnabled(Level level)
     {
-        if (!Serial)
-            return; // Guard against uninitialized Serial
+        return CORE_DEBUG_LEVEL >= 4 - static_cast<int>(level);
+    }
 
-        const char *levelStr;
-        switch (level)
-        {
-        case Level::DEBUG:
-            levelStr = "DEBUG";
-            break;
-        case Level::INFO:
-            levelStr = "INFO";
-            break;
-        case Level::WARN:
-            levelStr = "WARN";
-            break;
-        case Level::ERROR:
-            levelStr = "ERROR";
-            break;
-        }
+    /**
+     * @brief Starts the task that writes queued messages to Serial
+     *
+     * Messages logged earlier stay queued until then.
+     */
+    static Error begin();
+
+    /**
+     * @brief Waits until every queued message has been written
+     *
+     * For bulk debug output that would otherwise overflow the ring; must
+     * not be called with interrupts disabled.
+     */
+    static void flush();
+
+    [[nodiscard]] static uint32_t droppedCount();
 
-        // Format: [TIME][LEVEL][MODULE] Message
-        Serial.printf("[%lu][%s][%s] %s\n", millis(), levelStr, module, message);
+    static void log(Level level, const char *module, const char *message)
+    {
+        logf(level, module, "%s", message);
     }
 
     // Convenience methods
@@ -64,8 +90,100 @@ public:
     template <typename... Args>
     static void logf(Level level, const char *module, const char *format, Args... args)
     {
-        char buffer[256];
-        snprintf(buffer, sizeof(buffer), format, args...);
-        log(level, module, buffer);
+        if (!isEnabled(level))
+            return;
+
+        Record record;
+        record.timeMs = millis();
+        record.module = module;
+        record.format = format;
+        record.level = level;
+        record.argCount = 0;
+        record.used = 0;
+        int expand[] = {0, (encodeArg(record, args), 0)...};
+        (void)expand;
+        enqueue(record);
+    }
+
+private:
+    enum class ArgType : uint8_t
+    {
+        SIGNED,   // int64_t
+        UNSIGNED, // uint64_t
+        FLOAT,    // double
+        STRING,   // Pointer to a string in flash
+        TEXT,     // Copied characters, null-terminated
+        POINTER   // uintptr_t
+    };
+
+    /**
+     * @brief One queued message: each argument is a type byte and its value
+     */
+    struct Record
+    {
+        uint32_t timeMs;
+        const char *module;
+        const char *format;
+        Level level;
+        uint8_t argCount;
+        uint8_t used;
+        uint8_t args[Config::Logging::ARG_BYTES];
+    };
+
+    static MpscRing<Record, Config::Logging::RING_CAPACITY> records;
+    static TaskHandle_t drainHandle;
+
+    static void encodeArg(Record &record, const char *value) { encodeString(record, value); }
+    static void encodeArg(Record &record, char *value) { encodeString(record, value); }
+    static void encodeArg(Record &record, double value) { encodeValue(record, ArgType::FLOAT, value); }
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value>::type
+    encodeArg(Record &record, T value)
+    {
+        encodeValue(record, ArgType::SIGNED, static_cast<int64_t>(value));
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value>::type
+    encodeArg(Record &record, T value)
+    {
+        encodeValue(record, ArgType::UNSIGNED, static_cast<uint64_t>(value));
     }
-};
\ No newline at end of file
+
+    template <typename T>
+    static typename std::enable_if<std::is_enum<T>::value>::type encodeArg(Record &record, T value)
+    {
+        encodeArg(record, static_cast<typename std::underlying_type<T>::type>(value));
+    }
+
+    template <typename T>
+    static typename std::enable_if<std::is_pointer<T>::value>::type encodeArg(Record &record, T value)
+    {
+        encodeValue(record, ArgType::POINTER, reinterpret_cast<uintptr_t>(value));
+    }
+
+    template <typename V>
+    static void encodeValue(Record &record, ArgType type, V value)
+    {
+        // Arguments that no longer fit are printed as '?'
+        if (record.used + 1 + sizeof(V) > sizeof(record.args))
+        {
+            record.used = sizeof(record.args);
+            return;
+        }
+
+        record.args[record.used] = static_cast<uint8_t>(type);
+        memcpy(&record.args[record.used + 1], &value, sizeof(V));
+        record.used += 1 + sizeof(V);
+        record.argCount++;
+    }
+
+    static void encodeString(Record &record, const char *value);
+    static void enqueue(const Record &record);
+    static void drainTask(void *param);
+    static void write(const Record &record);
+    static void formatMessage(const Record &record, char *out, size_t size);
+    static size_t formatArgument(char *out, size_t size, const char *spec, const char *length,
+                                 size_t lengthSize, char conversion, ArgType type, const uint8_t *data);
+};
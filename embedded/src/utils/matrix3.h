@@ -0,0 +1,30 @@
+#pragma once
+#include "utils/vector3d.h"
+
+/**
+ * @brief Row-major 3x3 matrix for axis correction
+ */
+struct Matrix3
+{
+    float m[3][3];
+
+    static Matrix3 diagonal(float x, float y, float z)
+    {
+        return Matrix3{{{x, 0, 0}, {0, y, 0}, {0, 0, z}}};
+    }
+
+    static Matrix3 identity() { return diagonal(1, 1, 1); }
+
+    /**
+     * @brief Computes this * v + offset
+     */
+    Vector3D transform(const Vector3D &v, const Vector3D &offset) const
+    {
+        return Vector3D(
+            m[0][0] * v.x + m[0][1] * v.y + m[0][2] * v.z + offset.x,
+            m[1][0] * v.x + m[1][1] * v.y + m[1][2] * v.z + offset.y,
+            m[2][0] * v.x + m[2][1] * v.y + m[2][2] * v.z + offset.z);
+    }
+
+    float trace() const { return m[0][0] + m[1][1] + m[2][2]; }
+};
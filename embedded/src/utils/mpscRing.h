@@ -0,0 +1,94 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fixed-capacity multi-producer/single-consumer ring buffer
+ *
+ * Lock-free bounded queue with a sequence number per slot: producers claim
+ * a slot with a compare-and-swap on head and publish it through the slot
+ * sequence, so a producer preempted mid-write never blocks the others. A
+ * push into a full ring is rejected and counted as an overflow.
+ *
+ * @tparam T Trivially copyable element type
+ * @tparam Capacity Number of slots, must be a power of two
+ */
+template <typename T, size_t Capacity>
+class MpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    MpscRing() : head(0), tail(0), overflows(0)
+    {
+        for (size_t i = 0; i < Capacity; i++)
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    // Producer side, any task
+    bool push(const T &item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        Slot *slot;
+        while (true)
+        {
+            slot = &slots[h & (Capacity - 1)];
+            size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(h);
+            if (diff == 0)
+            {
+                if (head.compare_exchange_weak(h, h + 1, std::memory_order_relaxed))
+                    break;
+            }
+            else if (diff < 0)
+            {
+                overflows.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            else
+            {
+                h = head.load(std::memory_order_relaxed);
+            }
+        }
+
+        slot->item = item;
+        slot->sequence.store(h + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side, one task only
+    bool pop(T &item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        Slot &slot = slots[t & (Capacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != t + 1)
+            return false;
+
+        item = slot.item;
+        slot.sequence.store(t + Capacity, std::memory_order_release);
+        tail.store(t + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    bool empty() const
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        return slots[t & (Capacity - 1)].sequence.load(std::memory_order_acquire) != t + 1;
+    }
+
+    uint32_t overflowCount() const { return overflows.load(std::memory_order_relaxed); }
+    static constexpr size_t capacity() { return Capacity; }
+
+private:
+    struct Slot
+    {
+        std::atomic<size_t> sequence;
+        T item;
+    };
+
+    Slot slots[Capacity];
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+    std::atomic<uint32_t> overflows;
+};
@@ -0,0 +1,23 @@
+#pragma once
+#include <cmath>
+#include "utils/vector3d.h"
+
+/**
+ * @brief Unit quaternion describing the sensor orientation
+ *
+ * rotate() maps a vector from the sensor frame to the world frame (z up).
+ */
+struct Quaternion
+{
+    float w, x, y, z;
+
+    Quaternion(float _w = 1, float _x = 0, float _y = 0, float _z = 0) : w(_w), x(_x), y(_y), z(_z) {}
+
+    Vector3D rotate(const Vector3D &v) const
+    {
+        return Vector3D(
+            (1 - 2 * (y * y + z * z)) * v.x + 2 * (x * y - w * z) * v.y + 2 * (x * z + w * y) * v.z,
+            2 * (x * y + w * z) * v.x + (1 - 2 * (x * x + z * z)) * v.y + 2 * (y * z - w * x) * v.z,
+            2 * (x * z - w * y) * v.x + 2 * (y * z + w * x) * v.y + (1 - 2 * (x * x + y * y)) * v.z);
+    }
+};
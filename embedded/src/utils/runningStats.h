@@ -0,0 +1,79 @@
+#pragma once
+#include <cstdint>
+#include "utils/vector3d.h"
+
+/**
+ * @brief Per-axis running mean and variance (Welford's algorithm)
+ *
+ * Constant memory regardless of the number of samples and numerically
+ * stable in single precision, unlike summing squares.
+ */
+class RunningStats3D
+{
+public:
+    RunningStats3D() noexcept { reset(); }
+
+    void reset()
+    {
+        n = 0;
+        avg = Vector3D();
+        m2 = Vector3D();
+    }
+
+    void add(const Vector3D &value)
+    {
+        n++;
+        float inv = 1.0f / n;
+        Vector3D delta = value - avg;
+        avg = avg + Vector3D(delta.x * inv, delta.y * inv, delta.z * inv);
+        Vector3D delta2 = value - avg;
+        m2 = m2 + Vector3D(delta.x * delta2.x, delta.y * delta2.y, delta.z * delta2.z);
+    }
+
+    /**
+     * @brief Folds in statistics collected separately (Chan's parallel update)
+     */
+    void merge(const RunningStats3D &other)
+    {
+        if (other.n == 0)
+            return;
+        if (n == 0)
+        {
+            *this = other;
+            return;
+        }
+
+        uint32_t total = n + other.n;
+        float weight = static_cast<float>(other.n) / total;
+        float cross = static_cast<float>(n) * other.n / total;
+        Vector3D delta = other.avg - avg;
+        avg = avg + Vector3D(delta.x * weight, delta.y * weight, delta.z * weight);
+        m2 = m2 + other.m2 + Vector3D(delta.x * delta.x * cross, delta.y * delta.y * cross, delta.z * delta.z * cross);
+        n = total;
+    }
+
+    [[nodiscard]] uint32_t count() const noexcept { return n; }
+    [[nodiscard]] const Vector3D &mean() const noexcept { return avg; }
+
+    /**
+     * @brief Sample variance per axis, zero below two samples
+     */
+    [[nodiscard]] Vector3D variance() const
+    {
+        return n > 1 ? m2 / static_cast<float>(n - 1) : Vector3D();
+    }
+
+    /**
+     * @brief Sum of the per-axis variances, a rotation-invariant noise measure
+     */
+    [[nodiscard]] float totalVariance() const
+    {
+        Vector3D v = variance();
+        return v.x + v.y + v.z;
+    }
+
+private:
+    uint32_t n;
+    Vector3D avg;
+    Vector3D m2;
+};
@@ -0,0 +1,70 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Fixed-capacity single-producer/single-consumer ring buffer
+ *
+ * Lock-free: the producer only writes head, the consumer only writes tail.
+ * A push into a full ring is rejected and counted as an overflow, so the
+ * producer never blocks on a slow consumer.
+ *
+ * @tparam T Trivially copyable element type
+ * @tparam Capacity Number of slots, must be a power of two
+ */
+template <typename T, size_t Capacity>
+class SpscRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+    SpscRing() : head(0), tail(0), overflows(0), highWater(0) {}
+
+    // Producer side
+    bool push(const T &item)
+    {
+        size_t h = head.load(std::memory_order_relaxed);
+        size_t used = h - tail.load(std::memory_order_acquire);
+        if (used >= Capacity)
+        {
+            overflows.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        slots[h & (Capacity - 1)] = item;
+        head.store(h + 1, std::memory_order_release);
+
+        if (used + 1 > highWater.load(std::memory_order_relaxed))
+            highWater.store(used + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Consumer side
+    bool pop(T &item)
+    {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire))
+            return false;
+
+        item = slots[t & (Capacity - 1)];
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size() const
+    {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+    }
+
+    static constexpr size_t capacity() { return Capacity; }
+    uint32_t overflowCount() const { return overflows.load(std::memory_order_relaxed); }
+    size_t highWaterMark() const { return highWater.load(std::memory_order_relaxed); }
+
+private:
+    T slots[Capacity];
+    std::atomic<size_t> head;
+    std::atomic<size_t> tail;
+    std::atomic<uint32_t> overflows;
+    std::atomic<size_t> highWater;
+};
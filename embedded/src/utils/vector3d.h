@@ -0,0 +1,37 @@
+#pragma once
+#include <cmath>
+
+/**
+ * @brief 3D vector structure for sensor data processing
+ */
+struct Vector3D
+{
+    float x, y, z;
+
+    Vector3D(float _x = 0, float _y = 0, float _z = 0) : x(_x), y(_y), z(_z) {}
+
+    Vector3D operator+(const Vector3D &other) const
+    {
+        return Vector3D(x + other.x, y + other.y, z + other.z);
+    }
+
+    Vector3D operator*(float scalar) const
+    {
+        return Vector3D(x * scalar, y * scalar, z * scalar);
+    }
+
+    Vector3D operator/(float scalar) const
+    {
+        return Vector3D(x / scalar, y / scalar, z / scalar);
+    }
+
+    Vector3D operator-(const Vector3D &other) const
+    {
+        return Vector3D(x - other.x, y - other.y, z - other.z);
+    }
+
+    float magnitude() const
+    {
+        return sqrt(x * x + y * y + z * z);
+    }
+};
@@ -1,5 +1,7 @@
 import DeleteConfirmation from '@/components/delete_confirmation';
-import { dbService, ISession, SessionUpdate } from '@/shared/services/database';
+import { useBLE } from '@/shared/services/ble_context';
+import { dbService, ISession, SessionSummary, SessionUpdate } from '@/shared/services/database';
+import { RepAnalytics, SetAnalytics } from '@/shared/utils/rep_analytics';
 import { MaterialCommunityIcons } from '@expo/vector-icons';
 import * as FileSystem from 'expo-file-system';
 import * as Sharing from 'expo-sharing';
@@ -9,6 +11,7 @@ import {
   FlatList,
   Modal,
   RefreshControl,
+  ScrollView,
   StyleSheet,
   Text,
   TextInput,
@@ -21,7 +24,7 @@ const EXERCISE_TYPES = ['Bench Press', 'Deadlift', 'Squat', 'Shoulder Press', 'O
 type ExerciseType = (typeof EXERCISE_TYPES)[number];
 
 interface SessionDetailProps {
-  session: ISession;
+  session: SessionSummary;
   onClose: () => void;
   onDelete: () => void;
   onExport: () => void;
@@ -38,6 +41,18 @@ const SessionDetail: React.FC<SessionDetailProps> = ({
   const [exerciseType, setExerciseType] = useState<string>(session.exerciseType || '');
   const [comments, setComments] = useState<string>(session.comments || '');
   const [isEditing, setIsEditing] = useState(false);
+  const [sets, setSets] = useState<SetAnalytics[]>([]);
+  const [reps, setReps] = useState<RepAnalytics[]>([]);
+
+  // Cached at session close, no samples are read here
+  useEffect(() => {
+    Promise.all([dbService.getSetAnalytics(session.id), dbService.getRepAnalytics(session.id)])
+      .then(([loadedSets, loadedReps]) => {
+        setSets(loadedSets);
+        setReps(loadedReps);
+      })
+      .catch((error) => console.error('Error loading session analytics:', error));
+  }, [session.id, session.analytics]);
 
   const handleSave = () => {
     onUpdate({ exerciseType, comments });
@@ -62,6 +77,39 @@ const SessionDetail: React.FC<SessionDetailProps> = ({
         <Text style={styles.detailLabel}>Duration</Text>
         <Text style={styles.detailValue}>{formatDuration(session.startTime, session.endTime)}</Text>
 
+        {session.analytics && session.analytics.repCount > 0 && (
+          <>
+            <Text style={styles.detailLabel}>Reps</Text>
+            <Text style={styles.detailValue}>
+              {session.analytics.repCount} in {session.analytics.setCount}{' '}
+              {session.analytics.setCount === 1 ? 'set' : 'sets'}, mean{' '}
+              {session.analytics.meanVelocity.toFixed(2)} m/s, peak{' '}
+              {session.analytics.peakVelocity.toFixed(2)} m/s, ROM{' '}
+              {(session.analytics.meanRangeOfMotion * 100).toFixed(0)} cm
+            </Text>
+
+            <ScrollView style={styles.setList}>
+              {sets.map((set, setIndex) => (
+                <View key={setIndex} style={styles.setContainer}>
+                  <Text style={styles.setHeader}>
+                    Set {setIndex + 1}: {set.repCount} reps, velocity loss{' '}
+                    {set.velocityLoss.toFixed(0)}%
+                  </Text>
+                  {reps
+                    .filter((rep) => rep.setIndex === setIndex)
+                    .map((rep, repIndex) => (
+                      <Text key={repIndex} style={styles.repText}>
+                        {repIndex + 1}. {rep.meanVelocity.toFixed(2)} m/s mean,{' '}
+                        {rep.peakVelocity.toFixed(2)} m/s peak,{' '}
+                        {(rep.rangeOfMotion * 100).toFixed(0)} cm
+                      </Text>
+                    ))}
+                </View>
+              ))}
+            </ScrollView>
+          </>
+        )}
+
         <Text style={styles.detailLabel}>Exercise Type</Text>
         {isEditing ? (
           <View style={styles.exerciseTypeContainer}>
@@ -143,30 +191,53 @@ const formatDuration = (startTime: number, endTime: number | null) => {
 };
 
 export default function HistoryScreen() {
-  const [sessions, setSessions] = useState<ISession[]>([]);
+  const [sessions, setSessions] = useState<SessionSummary[]>([]);
   const [refreshing, setRefreshing] = useState(false);
-  const [selectedSession, setSelectedSession] = useState<ISession | null>(null);
+  const [selectedSession, setSelectedSession] = useState<SessionSummary | null>(null);
   const [showDeleteConfirmation, setShowDeleteConfirmation] = useState(false);
   const [sessionToDelete, setSessionToDelete] = useState<ISession | null>(null);
+  const [syncProgress, setSyncProgress] = useState<string | null>(null);
+  const {
+    isConnected,
+    hasDeviceRecording,
+    listDeviceSessions,
+    downloadDeviceSession,
+    eraseDeviceRecordings,
+  } = useBLE();
 
   const loadSessions = async () => {
     try {
-      const loadedSessions = await dbService.getSessions();
+      const loadedSessions = await dbService.getSessionSummaries();
       setSessions(loadedSessions);
+      setSelectedSession((prev) => loadedSessions.find((s) => s.id === prev?.id) ?? prev);
+      return loadedSessions;
     } catch (error) {
       console.error('Error loading sessions:', error);
       Alert.alert('Error', 'Failed to load sessions');
+      return [];
+    }
+  };
+
+  // Sessions without valid cached metrics are analyzed in the background, the list shows
+  // them without metrics until then
+  const loadSessionsAndAnalytics = async () => {
+    const loadedSessions = await loadSessions();
+    if (loadedSessions.some((s) => s.endTime !== null && s.analytics === null)) {
+      dbService
+        .refreshStaleAnalytics()
+        .then((computed) => computed > 0 && loadSessions())
+        .catch((error) => console.error('Error refreshing analytics:', error));
     }
   };
 
   const onRefresh = useCallback(async () => {
     setRefreshing(true);
-    await loadSessions();
+    await loadSessionsAndAnalytics();
     setRefreshing(false);
   }, []);
 
   useEffect(() => {
-    loadSessions();
+    loadSessionsAndAnalytics();
   }, []);
 
   const handleUpdateSession = async (sessionId: string, updates: SessionUpdate) => {
@@ -226,7 +297,61 @@ export default function HistoryScreen() {
     }
   };
 
-  const renderSessionItem = ({ item }: { item: ISession }) => (
+  const askEraseDeviceRecordings = () => {
+    Alert.alert('Erase device recordings?', 'All sessions were imported to this phone.', [
+      { text: 'Keep', style: 'cancel' },
+      {
+        text: 'Erase',
+        style: 'destructive',
+        onPress: () =>
+          eraseDeviceRecordings().catch((error) => {
+            console.error('Error erasing device recordings:', error);
+            Alert.alert('Error', 'Failed to erase device recordings');
+          }),
+      },
+    ]);
+  };
+
+  const handleSyncFromDevice = async () => {
+    try {
+      setSyncProgress('Listing sessions...');
+      const deviceSessions = (await listDeviceSessions()).filter((s) => s.complete);
+
+      let imported = 0;
+      for (const [index, info] of deviceSessions.entries()) {
+        const label = `Session ${index + 1}/${deviceSessions.length}`;
+        setSyncProgress(`${label}: 0%`);
+
+        const data = await downloadDeviceSession(info, (fraction) =>
+          setSyncProgress(`${label}: ${Math.round(fraction * 100)}%`),
+        );
+        if (data.length === 0) continue;
+
+        // Device ids restart from a random base, the start time keeps them unique
+        const sessionId = new Date(info.startTime).toISOString();
+        const endTime = data[data.length - 1].timestamp;
+        if (await dbService.importSession(sessionId, info.startTime, endTime, data)) {
+          imported++;
+        }
+      }
+
+      await loadSessionsAndAnalytics();
+      setSyncProgress(null);
+
+      if (deviceSessions.length > 0) {
+        console.log(`Imported ${imported} of ${deviceSessions.length} device sessions`);
+        askEraseDeviceRecordings();
+      } else {
+        Alert.alert('Sync', 'No recordings on the device');
+      }
+    } catch (error) {
+      console.error('Error syncing from device:', error);
+      setSyncProgress(null);
+      Alert.alert('Error', 'Failed to sync recordings from device');
+    }
+  };
+
+  const renderSessionItem = ({ item }: { item: SessionSummary }) => (
     <TouchableOpacity style={styles.sessionItem} onPress={() => setSelectedSession(item)}>
       <View style={styles.sessionHeader}>
         <View>
@@ -235,6 +360,12 @@ export default function HistoryScreen() {
         </View>
         <Text style={styles.sessionDuration}>{formatDuration(item.startTime, item.endTime)}</Text>
       </View>
+      {item.analytics && item.analytics.repCount > 0 && (
+        <Text style={styles.sessionMetrics}>
+          {item.analytics.repCount} reps · {item.analytics.meanVelocity.toFixed(2)} m/s · loss{' '}
+          {item.analytics.maxVelocityLoss.toFixed(0)}%
+        </Text>
+      )}
       {item.comments && (
         <Text style={styles.comments} numberOfLines={1}>
           {item.comments}
@@ -245,6 +376,16 @@ export default function HistoryScreen() {
 
   return (
     <View style={styles.container}>
+      {isConnected && hasDeviceRecording && (
+        <TouchableOpacity
+          style={styles.syncButton}
+          onPress={handleSyncFromDevice}
+          disabled={syncProgress !== null}
+        >
+          <MaterialCommunityIcons name="download" size={20} color="#FFFFFF" />
+          <Text style={styles.actionButtonText}>{syncProgress ?? 'Sync from device'}</Text>
+        </TouchableOpacity>
+      )}
       <FlatList
         data={sessions}
         renderItem={renderSessionItem}
@@ -294,6 +435,17 @@ const styles = StyleSheet.create({
     flex: 1,
     backgroundColor: '#111827',
   },
+  syncButton: {
+    flexDirection: 'row',
+    alignItems: 'center',
+    justifyContent: 'center',
+    gap: 8,
+    backgroundColor: '#6366F1',
+    marginHorizontal: 16,
+    marginTop: 16,
+    padding: 12,
+    borderRadius: 8,
+  },
   sessionItem: {
     backgroundColor: '#1F2937',
     marginHorizontal: 16,
@@ -320,6 +472,11 @@ const styles = StyleSheet.create({
     color: '#9CA3AF',
     fontSize: 14,
   },
+  sessionMetrics: {
+    color: '#FFFFFF',
+    fontSize: 14,
+    marginTop: 8,
+  },
   sessionActions: {
     flexDirection: 'row',
     justifyContent: 'flex-end',
@@ -374,6 +531,23 @@ const styles = StyleSheet.create({
     fontSize: 16,
     marginBottom: 16,
   },
+  setList: {
+    maxHeight: 200, // Long sessions scroll instead of pushing the actions off screen
+    marginBottom: 16,
+  },
+  setContainer: {
+    marginBottom: 12,
+  },
+  setHeader: {
+    color: '#9CA3AF',
+    fontSize: 14,
+    fontWeight: '500',
+    marginBottom: 4,
+  },
+  repText: {
+    color: '#FFFFFF',
+    fontSize: 14,
+  },
   modalActions: {
     flexDirection: 'row',
     justifyContent: 'space-between',
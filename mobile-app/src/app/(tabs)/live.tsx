@@ -7,10 +7,14 @@
  */
 
 import { MainDisplay } from '@/features/live/components/main_display';
-import { SensorData, useBLE } from '@/shared/services/ble_context';
+import { useBLE } from '@/shared/services/ble_context';
 import { dbService } from '@/shared/services/database';
+import { ACQUISITION_PROFILES, AcquisitionProfile } from '@/shared/types/acquisition';
+import { EnvelopeBuffer } from '@/shared/utils/envelope_buffer';
+import { SAMPLE_CHANNELS, SampleRing } from '@/shared/utils/sample_ring';
+import { StreamFormat } from '@/shared/utils/stream_decoder';
 import { removeGravity } from '@/shared/utils/gravity_compensation';
-import { OrientationFilter } from '@/shared/utils/orientation_filter';
+import { OrientationFilter, quaternionToEuler } from '@/shared/utils/orientation_filter';
 import { MaterialCommunityIcons } from '@expo/vector-icons';
 import React, { useCallback, useEffect, useRef, useState } from 'react';
 import { Alert, StyleSheet, Switch, Text, TouchableOpacity, View } from 'react-native';
@@ -74,11 +78,25 @@ const BlinkingRecordIndicator: React.FC<BlinkingRecordIndicatorProps> = ({ start
  * Main LiveScreen component for displaying and recording sensor data
  */
 const LiveScreen = () => {
-  const { isConnected, sensorData, setOnDataReceived } = useBLE();
+  const {
+    isConnected,
+    sensorData,
+    setOnSamplesReceived,
+    setStreamFormat,
+    acquisitionProfile,
+    setAcquisitionProfile,
+    hasRepSummary,
+    lastRep,
+    reps,
+    summaryOnly,
+    setSummaryOnly,
+  } = useBLE();
   const [isRecording, setIsRecording] = useState(false);
   const [measurementCount, setMeasurementCount] = useState(0);
   const [showDetails, setShowDetails] = useState(false);
   const [removeGravityEnabled, setRemoveGravityEnabled] = useState(false);
+  const [compactStreamEnabled, setCompactStreamEnabled] = useState(false);
+  const [deviceFusionEnabled, setDeviceFusionEnabled] = useState(false);
   const recordingRef = useRef<RecordingRef>({
     isRecording: false,
     sessionId: null,
@@ -86,9 +104,17 @@ const LiveScreen = () => {
   const [recordingStartTime, setRecordingStartTime] = useState<number>(0);
   const [orientationFilter] = useState(new OrientationFilter());
   const [orientation, setOrientation] = useState<{ x: number; y: number; z: number } | undefined>();
+  const [envelope] = useState(() => new EnvelopeBuffer());
+  const removeGravityRef = useRef(false);
+  removeGravityRef.current = removeGravityEnabled;
+  // Stored samples are counted here and shown at most once per display frame
+  const storedCountRef = useRef({ count: 0, request: undefined as number | undefined });
 
   useEffect(() => {
-    if (sensorData && sensorData.accX !== undefined && sensorData.gyrX !== undefined) {
+    if (sensorData?.quaternion) {
+      // Fused on the device at the full sample rate
+      setOrientation(quaternionToEuler(sensorData.quaternion));
+    } else if (sensorData && sensorData.accX !== undefined && sensorData.gyrX !== undefined) {
       const newOrientation = orientationFilter.update(
         { x: sensorData.accX, y: sensorData.accY, z: sensorData.accZ },
         { x: sensorData.gyrX, y: sensorData.gyrY, z: sensorData.gyrZ },
@@ -106,25 +132,42 @@ const LiveScreen = () => {
   };
 
   /**
-   * Handles incoming sensor data, storing it if recording is active
+   * Adds the acceleration magnitude of new samples to the chart history, read in place
    */
-  const handleSensorData = useCallback(async (data: SensorData) => {
+  const chartSamples = (ring: SampleRing, start: number, count: number) => {
+    for (let n = start; n < start + count; n++) {
+      const slot = ring.slot(n);
+      const base = slot * SAMPLE_CHANNELS;
+      let x = ring.values[base];
+      let y = ring.values[base + 1];
+      let z = ring.values[base + 2];
+      if (removeGravityRef.current && !ring.hasQuaternion[slot]) {
+        ({ x, y, z } = removeGravity({ x, y, z }));
+      }
+      envelope.push(ring.timestamps[slot], calculateMagnitude(x, y, z));
+    }
+  };
+
+  /**
+   * Charts incoming samples and stores them if recording is active, copied straight
+   * from the stream ring
+   */
+  const handleSamples = useCallback(async (ring: SampleRing, start: number, count: number) => {
+    chartSamples(ring, start, count);
     const { isRecording, sessionId } = recordingRef.current;
 
-    if (isRecording && sessionId && data) {
+    if (isRecording && sessionId) {
       try {
-        await dbService.storeMeasurement({
-          accX: data.accX,
-          accY: data.accY,
-          accZ: data.accZ,
-          gyrX: data.gyrX,
-          gyrY: data.gyrY,
-          gyrZ: data.gyrZ,
-          timestamp: data.timestamp,
-          sessionId: sessionId,
-        });
-
-        setMeasurementCount((prev) => prev + 1);
+        const stored = await dbService.storeSamples(sessionId, ring, start, count);
+        // Dropped samples are counted in the ingest stats logged when the session ends
+        const counter = storedCountRef.current;
+        counter.count += stored;
+        if (counter.request === undefined) {
+          counter.request = requestAnimationFrame(() => {
+            counter.request = undefined;
+            setMeasurementCount(counter.count);
+          });
+        }
       } catch (error) {
         Logger.error('Failed to store measurement:', error);
         Alert.alert('Storage Error', 'Failed to save measurement data');
@@ -132,22 +175,31 @@ const LiveScreen = () => {
     }
   }, []);
 
+  // Rep boundaries go into the chunk index of the recording
+  useEffect(() => {
+    const { isRecording, sessionId } = recordingRef.current;
+    if (isRecording && sessionId && lastRep?.phoneEndTime !== undefined) {
+      dbService.markRep(sessionId, {
+        startTime: lastRep.phoneEndTime - lastRep.timeUnderTensionMs,
+        endTime: lastRep.phoneEndTime,
+      });
+    }
+  }, [lastRep]);
+
   // Use ref to maintain latest callback reference
-  const handleSensorDataRef = useRef(handleSensorData);
+  const handleSamplesRef = useRef(handleSamples);
   useEffect(() => {
-    handleSensorDataRef.current = handleSensorData;
-  }, [handleSensorData]);
+    handleSamplesRef.current = handleSamples;
+  }, [handleSamples]);
 
   // Set up data handler
   useEffect(() => {
-    const dataHandler = async (data: SensorData) => {
-      await handleSensorDataRef.current(data);
-    };
-
-    setOnDataReceived(dataHandler);
+    setOnSamplesReceived((ring, start, count) => {
+      handleSamplesRef.current(ring, start, count);
+    });
 
     return () => {
-      setOnDataReceived(undefined);
+      setOnSamplesReceived(undefined);
     };
   }, []);
 
@@ -166,6 +218,7 @@ const LiveScreen = () => {
         recordingRef.current = { isRecording: true, sessionId };
         setIsRecording(true);
         setRecordingStartTime(startTime);
+        storedCountRef.current.count = 0;
         setMeasurementCount(0);
       } else if (recordingRef.current.sessionId) {
         const sessionId = recordingRef.current.sessionId;
@@ -173,7 +226,7 @@ const LiveScreen = () => {
 
         try {
           await dbService.endSession(sessionId);
-          Logger.info('Session ended successfully');
+          Logger.info('Session ended successfully', dbService.getIngestStats());
 
           recordingRef.current = { isRecording: false, sessionId: null };
           setIsRecording(false);
@@ -188,8 +241,82 @@ const LiveScreen = () => {
     }
   }, [measurementCount]);
 
+  /**
+   * Switches the device between float and delta-compressed int16 sample encoding
+   */
+  const toggleCompactStream = useCallback(
+    async (enabled: boolean) => {
+      try {
+        await setStreamFormat(enabled ? StreamFormat.INT16_DELTA : StreamFormat.FLOAT32);
+        setCompactStreamEnabled(enabled);
+        setDeviceFusionEnabled(false);
+      } catch (error) {
+        Logger.error('Failed to change stream format:', error);
+        Alert.alert('Connection Error', 'Failed to change stream format');
+      }
+    },
+    [setStreamFormat],
+  );
+
+  /**
+   * Switches to orientation and linear acceleration fused on the device
+   */
+  const toggleDeviceFusion = useCallback(
+    async (enabled: boolean) => {
+      try {
+        await setStreamFormat(enabled ? StreamFormat.FUSION : StreamFormat.FLOAT32);
+        setDeviceFusionEnabled(enabled);
+        setCompactStreamEnabled(false);
+      } catch (error) {
+        Logger.error('Failed to change stream format:', error);
+        Alert.alert('Connection Error', 'Failed to change stream format');
+      }
+    },
+    [setStreamFormat],
+  );
+
+  /**
+   * Selects the device's sample rate, filter and full-scale profile
+   */
+  const selectProfile = useCallback(
+    async (profile: AcquisitionProfile) => {
+      try {
+        await setAcquisitionProfile(profile);
+      } catch (error) {
+        Logger.error('Failed to change acquisition profile:', error);
+        Alert.alert('Connection Error', 'Failed to change acquisition profile');
+      }
+    },
+    [setAcquisitionProfile],
+  );
+
+  /**
+   * Stops the sample stream and keeps only the per-rep summaries from the device
+   */
+  const toggleSummaryOnly = useCallback(
+    async (enabled: boolean) => {
+      try {
+        await setSummaryOnly(enabled);
+      } catch (error) {
+        Logger.error('Failed to change stream subscription:', error);
+        Alert.alert('Connection Error', 'Failed to change stream subscription');
+      }
+    },
+    [setSummaryOnly],
+  );
+
+  // The device falls back to float encoding on every new connection
+  useEffect(() => {
+    if (!isConnected) {
+      envelope.reset();
+      setCompactStreamEnabled(false);
+      setDeviceFusionEnabled(false);
+    }
+  }, [isConnected]);
+
+  // Fusion frames already carry gravity-free world-frame acceleration
   const processedAccel = sensorData
-    ? removeGravityEnabled
+    ? removeGravityEnabled && !sensorData.quaternion
       ? removeGravity({ x: sensorData.accX, y: sensorData.accY, z: sensorData.accZ })
       : { x: sensorData.accX, y: sensorData.accY, z: sensorData.accZ }
     : { x: 0, y: 0, z: 0 };
@@ -219,8 +346,37 @@ const LiveScreen = () => {
         measurementCount={measurementCount}
         isRecording={isRecording}
         orientation={orientation}
+        envelope={envelope}
       />
 
+      {/* Last rep detected on the device */}
+      {lastRep && (
+        <View style={styles.repCard}>
+          <Text style={styles.detailsHeader}>
+            Rep {lastRep.repNumber}
+            {reps.length > 1 ? ` of ${reps.length}` : ''}
+          </Text>
+          <View style={styles.repMetrics}>
+            <View>
+              <Text style={styles.repValue}>{lastRep.meanVelocity.toFixed(2)}</Text>
+              <Text style={styles.repLabel}>Mean m/s</Text>
+            </View>
+            <View>
+              <Text style={styles.repValue}>{lastRep.peakVelocity.toFixed(2)}</Text>
+              <Text style={styles.repLabel}>Peak m/s</Text>
+            </View>
+            <View>
+              <Text style={styles.repValue}>{(lastRep.rangeOfMotion * 100).toFixed(0)}</Text>
+              <Text style={styles.repLabel}>ROM cm</Text>
+            </View>
+            <View>
+              <Text style={styles.repValue}>{(lastRep.timeUnderTensionMs / 1000).toFixed(1)}</Text>
+              <Text style={styles.repLabel}>TUT s</Text>
+            </View>
+          </View>
+        </View>
+      )}
+
       {/* Settings Section */}
       <View style={styles.settingsContainer}>
         <Text style={styles.settingsHeader}>Settings</Text>
@@ -258,6 +414,78 @@ const LiveScreen = () => {
               thumbColor={showDetails ? '#FFFFFF' : '#9CA3AF'}
             />
           </View>
+
+          <View style={styles.settingRow}>
+            <View style={styles.settingInfo}>
+              <Text style={styles.settingLabel}>Compact Transfer</Text>
+              <Text style={styles.settingDescription}>
+                Send delta-compressed 16-bit samples to save airtime
+              </Text>
+            </View>
+            <Switch
+              value={compactStreamEnabled}
+              onValueChange={toggleCompactStream}
+              disabled={!isConnected}
+              trackColor={{ false: '#374151', true: '#6544C0' }}
+              thumbColor={compactStreamEnabled ? '#FFFFFF' : '#9CA3AF'}
+            />
+          </View>
+
+          <View style={styles.settingRow}>
+            <View style={styles.settingInfo}>
+              <Text style={styles.settingLabel}>Device Fusion</Text>
+              <Text style={styles.settingDescription}>
+                Orientation and gravity-free acceleration computed on the sensor
+              </Text>
+            </View>
+            <Switch
+              value={deviceFusionEnabled}
+              onValueChange={toggleDeviceFusion}
+              disabled={!isConnected}
+              trackColor={{ false: '#374151', true: '#6544C0' }}
+              thumbColor={deviceFusionEnabled ? '#FFFFFF' : '#9CA3AF'}
+            />
+          </View>
+
+          <View style={styles.settingRow}>
+            <View style={styles.settingInfo}>
+              <Text style={styles.settingLabel}>Summary Only</Text>
+              <Text style={styles.settingDescription}>
+                Receive only per-rep metrics detected on the sensor
+              </Text>
+            </View>
+            <Switch
+              value={summaryOnly}
+              onValueChange={toggleSummaryOnly}
+              disabled={!isConnected || !hasRepSummary}
+              trackColor={{ false: '#374151', true: '#6544C0' }}
+              thumbColor={summaryOnly ? '#FFFFFF' : '#9CA3AF'}
+            />
+          </View>
+
+          <View style={styles.settingInfo}>
+            <Text style={styles.settingLabel}>Acquisition Profile</Text>
+            <Text style={styles.settingDescription}>
+              {ACQUISITION_PROFILES.find((p) => p.profile === acquisitionProfile)?.description ??
+                'Sample rate, filter and range of the sensor'}
+            </Text>
+            <View style={styles.profileRow}>
+              {ACQUISITION_PROFILES.map(({ profile, label }) => (
+                <TouchableOpacity
+                  key={profile}
+                  style={[
+                    styles.profileButton,
+                    acquisitionProfile === profile && styles.profileButtonSelected,
+                    !isConnected && styles.buttonDisabled,
+                  ]}
+                  onPress={() => selectProfile(profile)}
+                  disabled={!isConnected}
+                >
+                  <Text style={styles.profileButtonText}>{label}</Text>
+                </TouchableOpacity>
+              ))}
+            </View>
+          </View>
         </View>
       </View>
 
@@ -335,6 +563,25 @@ const styles = StyleSheet.create({
     color: '#FFFFFF',
     fontSize: 14,
   },
+  repCard: {
+    padding: 16,
+    backgroundColor: '#1F2937',
+    borderRadius: 12,
+    gap: 8,
+  },
+  repMetrics: {
+    flexDirection: 'row',
+    justifyContent: 'space-between',
+  },
+  repValue: {
+    color: '#FFFFFF',
+    fontSize: 24,
+    fontWeight: 'bold',
+  },
+  repLabel: {
+    color: '#9CA3AF',
+    fontSize: 12,
+  },
   controls: {
     padding: 16,
     alignItems: 'center',
@@ -357,6 +604,27 @@ const styles = StyleSheet.create({
   buttonDisabled: {
     opacity: 0.5,
   },
+  profileRow: {
+    flexDirection: 'row',
+    flexWrap: 'wrap',
+    gap: 8,
+    marginTop: 8,
+  },
+  profileButton: {
+    paddingVertical: 6,
+    paddingHorizontal: 12,
+    borderRadius: 16,
+    borderWidth: 1,
+    borderColor: '#4B5563',
+  },
+  profileButtonSelected: {
+    backgroundColor: '#6544C0',
+    borderColor: '#6544C0',
+  },
+  profileButtonText: {
+    color: '#FFFFFF',
+    fontSize: 14,
+  },
   buttonText: {
     color: '#FFFFFF',
     fontSize: 20,
@@ -15,6 +15,8 @@ export default function SettingsScreen() {
     isScanning,
     showCalibrationModal,
     calibrationState,
+    calibrationInfo,
+    linkInfo,
 
     // Actions
     startScan,
@@ -22,13 +24,15 @@ export default function SettingsScreen() {
     disconnect,
     handleStartCalibration,
     startQuickCalibration,
+    startSixPositionCalibration,
     abortCalibration,
     handleModalClose,
+    handleForgetCalibration,
   } = useDeviceSettings();
 
   return (
     <View style={styles.container}>
-      <ConnectionCard isConnected={isConnected} isScanning={isScanning} />
+      <ConnectionCard isConnected={isConnected} isScanning={isScanning} linkInfo={linkInfo} />
       <ConnectionControls
         isConnected={isConnected}
         isScanning={isScanning}
@@ -38,12 +42,15 @@ export default function SettingsScreen() {
       />
       <CalibrationControls
         isConnected={isConnected}
+        calibrationInfo={calibrationInfo}
         onStartQuickCalibration={() => handleStartCalibration()}
+        onForgetCalibration={handleForgetCalibration}
       />
       <CalibrationModal
         visible={showCalibrationModal}
         onClose={handleModalClose}
         startQuickCalibration={startQuickCalibration}
+        startSixPositionCalibration={startSixPositionCalibration}
         calibrationState={calibrationState}
         onAbort={abortCalibration}
       />
@@ -0,0 +1,102 @@
+import { theme } from '@/shared/styles/theme';
+import { EnvelopeBuffer } from '@/shared/utils/envelope_buffer';
+import React, { useEffect, useState } from 'react';
+import { LayoutChangeEvent, StyleSheet, View } from 'react-native';
+import Svg, { Path } from 'react-native-svg';
+
+interface EnvelopeChartProps {
+  buffer: EnvelopeBuffer;
+  height?: number;
+  minSpan?: number; // Smallest value range shown, keeps noise from filling the chart
+}
+
+/**
+ * One vertical stroke per column from its min to its max, new data on the right
+ */
+const buildPath = (buffer: EnvelopeBuffer, width: number, height: number, minSpan: number) => {
+  const range = buffer.range();
+  if (!range) {
+    return '';
+  }
+
+  const mid = (range.min + range.max) / 2;
+  const span = Math.max(range.max - range.min, minSpan);
+  const bottom = mid - span / 2;
+  const columnWidth = width / buffer.columns;
+  const offset = buffer.columns - buffer.length;
+  const toY = (value: number) => height - ((value - bottom) / span) * height;
+
+  let path = '';
+  buffer.forEachColumn((index, min, max) => {
+    if (Number.isNaN(min)) {
+      return;
+    }
+    const x = ((offset + index + 0.5) * columnWidth).toFixed(1);
+    const top = toY(max);
+    // At least a pixel, a flat column would not be drawn at all
+    const low = Math.max(toY(min), top + 1);
+    path += `M${x} ${top.toFixed(1)}V${low.toFixed(1)}`;
+  });
+  return path;
+};
+
+/**
+ * Live min/max chart of an EnvelopeBuffer.
+ *
+ * Redraws from an animation frame loop rather than per sample, so it renders
+ * at most once per display frame whatever the stream rate, and not at all
+ * while nothing arrives.
+ */
+export const EnvelopeChart: React.FC<EnvelopeChartProps> = ({
+  buffer,
+  height = 120,
+  minSpan = 0.5,
+}) => {
+  const [width, setWidth] = useState(0);
+  const [path, setPath] = useState('');
+
+  useEffect(() => {
+    if (width === 0) {
+      return;
+    }
+
+    let drawnVersion = -1;
+    let frame = 0;
+    const draw = () => {
+      if (buffer.version !== drawnVersion) {
+        drawnVersion = buffer.version;
+        setPath(buildPath(buffer, width, height, minSpan));
+      }
+      frame = requestAnimationFrame(draw);
+    };
+    frame = requestAnimationFrame(draw);
+
+    return () => cancelAnimationFrame(frame);
+  }, [buffer, width, height, minSpan]);
+
+  const handleLayout = (event: LayoutChangeEvent) => {
+    setWidth(Math.round(event.nativeEvent.layout.width));
+  };
+
+  return (
+    <View style={[styles.container, { height }]} onLayout={handleLayout}>
+      {width > 0 && (
+        <Svg width={width} height={height}>
+          <Path
+            d={path}
+            stroke={theme.colors.secondary}
+            strokeWidth={Math.max(1, width / buffer.columns)}
+            fill="none"
+          />
+        </Svg>
+      )}
+    </View>
+  );
+};
+
+const styles = StyleSheet.create({
+  container: {
+    width: '100%',
+    marginTop: theme.spacing.md,
+  },
+});
@@ -1,6 +1,8 @@
+import { EnvelopeChart } from '@/features/live/components/envelope_chart';
 import { SensorData } from '@/shared/services/ble_context';
 import { cardStyles } from '@/shared/styles/components';
 import { theme } from '@/shared/styles/theme';
+import { EnvelopeBuffer } from '@/shared/utils/envelope_buffer';
 import React from 'react';
 import { ScrollView, StyleSheet, Text, View } from 'react-native';
 
@@ -12,6 +14,7 @@ interface MainDisplayProps {
   measurementCount?: number;
   isRecording?: boolean;
   orientation?: { x: number; y: number; z: number };
+  envelope?: EnvelopeBuffer; // Magnitude history, drawn on its own frame loop
 }
 
 export const MainDisplay: React.FC<MainDisplayProps> = ({
@@ -22,6 +25,7 @@ export const MainDisplay: React.FC<MainDisplayProps> = ({
   measurementCount,
   isRecording,
   orientation,
+  envelope,
 }) => {
   // Convert radians to degrees for display
   const toDegrees = (rad: number): number => (rad * 180) / Math.PI;
@@ -34,6 +38,8 @@ export const MainDisplay: React.FC<MainDisplayProps> = ({
         <Text style={styles.dataUnit}> m/s²</Text>
       </Text>
 
+      {envelope && <EnvelopeChart buffer={envelope} />}
+
       {showDetails && sensorData && (
         <ScrollView style={[cardStyles.container, cardStyles.elevated, styles.detailsContainer]}>
           <View style={styles.detailsSection}>
@@ -1,20 +1,35 @@
 import { buttonStyles } from '@/shared/styles/components';
 import { theme } from '@/shared/styles/theme';
+import { CalibrationInfo, CalibrationMethod } from '@/shared/utils/calibration_info';
 import { MaterialCommunityIcons } from '@expo/vector-icons';
 import React from 'react';
 import { StyleSheet, Text, TouchableOpacity, View } from 'react-native';
 
 interface CalibrationControlsProps {
   isConnected: boolean;
+  calibrationInfo?: CalibrationInfo | null;
   onStartQuickCalibration: () => void;
+  onForgetCalibration?: () => void;
 }
 
+const describeCalibration = (info: CalibrationInfo): string => {
+  if (!info.valid) return 'Not calibrated';
+  const method = info.method === CalibrationMethod.SIX_POSITION ? 'Six-position' : 'Quick';
+  const stored = info.stored ? 'stored on device' : 'until power off';
+  return `${method} calibration at ${info.temperature.toFixed(1)} °C, ${stored}`;
+};
+
 export const CalibrationControls = ({
   isConnected,
+  calibrationInfo,
   onStartQuickCalibration,
+  onForgetCalibration,
 }: CalibrationControlsProps) => {
   return (
     <View style={styles.container}>
+      {isConnected && calibrationInfo && (
+        <Text style={styles.infoText}>{describeCalibration(calibrationInfo)}</Text>
+      )}
       <TouchableOpacity
         style={[buttonStyles.button, buttonStyles.primary, !isConnected && buttonStyles.disabled]}
         onPress={onStartQuickCalibration}
@@ -23,6 +38,15 @@ export const CalibrationControls = ({
         <MaterialCommunityIcons name="tune" size={24} color={theme.colors.text} />
         <Text style={buttonStyles.text}>Calibrate</Text>
       </TouchableOpacity>
+      {isConnected && calibrationInfo?.valid && onForgetCalibration && (
+        <TouchableOpacity
+          style={[buttonStyles.button, buttonStyles.cancel]}
+          onPress={onForgetCalibration}
+        >
+          <MaterialCommunityIcons name="delete-outline" size={24} color={theme.colors.text} />
+          <Text style={buttonStyles.text}>Forget Calibration</Text>
+        </TouchableOpacity>
+      )}
     </View>
   );
 };
@@ -31,4 +55,7 @@ const styles = StyleSheet.create({
   container: {
     gap: theme.spacing.md,
   },
+  infoText: {
+    color: theme.colors.textSecondary,
+  },
 });
@@ -1,5 +1,6 @@
 import { cardStyles } from '@/shared/styles/components';
 import { theme } from '@/shared/styles/theme';
+import { LinkInfo } from '@/shared/utils/link_info';
 import { MaterialCommunityIcons } from '@expo/vector-icons';
 import React from 'react';
 import { Text, View } from 'react-native';
@@ -7,9 +8,10 @@ import { Text, View } from 'react-native';
 interface ConnectionCardProps {
   isConnected: boolean;
   isScanning: boolean;
+  linkInfo?: LinkInfo | null;
 }
 
-export const ConnectionCard = ({ isConnected, isScanning }: ConnectionCardProps) => {
+export const ConnectionCard = ({ isConnected, isScanning, linkInfo }: ConnectionCardProps) => {
   return (
     <View style={[cardStyles.container, cardStyles.elevated, cardStyles.basePadding]}>
       <View style={cardStyles.header}>
@@ -23,6 +25,12 @@ export const ConnectionCard = ({ isConnected, isScanning }: ConnectionCardProps)
       <Text style={cardStyles.text}>
         Status: {isConnected ? 'Connected' : isScanning ? 'Scanning...' : 'Disconnected'}
       </Text>
+      {isConnected && linkInfo && (
+        <Text style={cardStyles.text}>
+          Link: MTU {linkInfo.mtu}, {linkInfo.connIntervalMs.toFixed(2)} ms interval, latency{' '}
+          {linkInfo.latency}, {linkInfo.txDataLength} B packets
+        </Text>
+      )}
     </View>
   );
 };
@@ -2,7 +2,7 @@ import { buttonStyles, modalStyles } from '@/shared/styles/components';
 import { theme } from '@/shared/styles/theme';
 import { CalibrationState, DeviceCalibrationState } from '@/shared/types/calibration';
 import { MaterialCommunityIcons } from '@expo/vector-icons';
-import React from 'react';
+import React, { useState } from 'react';
 import { Modal, StyleSheet, Text, TouchableOpacity, View } from 'react-native';
 import { PlaceDeviceAnimation } from '../animations/place_device_animation';
 
@@ -13,6 +13,7 @@ interface CalibrationModalProps {
   visible: boolean;
   calibrationState: CalibrationState;
   startQuickCalibration: () => Promise<void>;
+  startSixPositionCalibration: () => Promise<void>;
   onAbort: () => Promise<void>;
   onClose: () => void;
 }
@@ -27,6 +28,10 @@ export const getCalibrationInstructions = (deviceState: DeviceCalibrationState):
       return 'Hold the device still...';
     case DeviceCalibrationState.QUICK_STATIC_SIDE:
       return 'Keep the device steady with display facing you';
+    case DeviceCalibrationState.SIX_WAITING_POSITION:
+      return 'Rest the device on a side it has not been measured on yet and let go';
+    case DeviceCalibrationState.SIX_STATIC:
+      return 'Keep the device still on this side...';
     default:
       return 'Follow the calibration steps';
   }
@@ -36,9 +41,13 @@ export const CalibrationModal = ({
   visible,
   calibrationState,
   startQuickCalibration,
+  startSixPositionCalibration,
   onAbort,
   onClose,
 }: CalibrationModalProps) => {
+  // Remembered so "Try Again" repeats the same mode
+  const [sixPosition, setSixPosition] = useState(false);
+
   const getModalState = (): ModalState => {
     if (calibrationState.status === 'failed') return 'failed';
     if (calibrationState.status === 'completed') return 'success';
@@ -46,9 +55,10 @@ export const CalibrationModal = ({
     return 'initial';
   };
 
-  const handleStartCalibration = async () => {
+  const handleStartCalibration = async (useSixPosition = sixPosition) => {
+    setSixPosition(useSixPosition);
     try {
-      await startQuickCalibration();
+      await (useSixPosition ? startSixPositionCalibration() : startQuickCalibration());
     } catch (error) {
       console.error('Error starting calibration:', error);
     }
@@ -76,7 +86,7 @@ export const CalibrationModal = ({
               </TouchableOpacity>
               <TouchableOpacity
                 style={[buttonStyles.button, buttonStyles.primary, modalStyles.buttonRowItem]}
-                onPress={handleStartCalibration}
+                onPress={() => handleStartCalibration()}
               >
                 <Text style={buttonStyles.text}>Try Again</Text>
               </TouchableOpacity>
@@ -100,7 +110,7 @@ export const CalibrationModal = ({
               </TouchableOpacity>
               <TouchableOpacity
                 style={[buttonStyles.button, buttonStyles.primary, modalStyles.buttonRowItem]}
-                onPress={handleStartCalibration}
+                onPress={() => handleStartCalibration()}
               >
                 <Text style={buttonStyles.text}>Calibrate Again</Text>
               </TouchableOpacity>
@@ -137,12 +147,20 @@ export const CalibrationModal = ({
                 'Place the sensor on a flat, stable surface. The device will need to be moved to different positions during calibration.'
               }
             </Text>
-            <TouchableOpacity
-              style={[buttonStyles.button, buttonStyles.primary, modalStyles.buttonSingle]}
-              onPress={handleStartCalibration}
-            >
-              <Text style={buttonStyles.text}>Start Calibration</Text>
-            </TouchableOpacity>
+            <View style={modalStyles.buttonRow}>
+              <TouchableOpacity
+                style={[buttonStyles.button, buttonStyles.primary, modalStyles.buttonRowItem]}
+                onPress={() => handleStartCalibration(false)}
+              >
+                <Text style={buttonStyles.text}>Quick</Text>
+              </TouchableOpacity>
+              <TouchableOpacity
+                style={[buttonStyles.button, buttonStyles.primary, modalStyles.buttonRowItem]}
+                onPress={() => handleStartCalibration(true)}
+              >
+                <Text style={buttonStyles.text}>Six-Position</Text>
+              </TouchableOpacity>
+            </View>
           </View>
         );
     }
@@ -162,7 +180,9 @@ export const CalibrationModal = ({
       >
         <View style={modalStyles.bottomSheet} onStartShouldSetResponder={() => true}>
           <View style={modalStyles.handle} />
-          <Text style={modalStyles.title}>{'Quick Calibration'}</Text>
+          <Text style={modalStyles.title}>
+            {sixPosition ? 'Six-Position Calibration' : 'Quick Calibration'}
+          </Text>
           {renderContent()}
         </View>
       </TouchableOpacity>
@@ -1,14 +1,16 @@
 import { useBLE } from '@/shared/services/ble_context';
 import { DeviceCalibrationState } from '@/shared/types/calibration';
-import { useState } from 'react';
+import { CalibrationInfo } from '@/shared/utils/calibration_info';
+import { useCallback, useEffect, useState } from 'react';
 import { Alert } from 'react-native';
 
 export const useDeviceSettings = () => {
   // State
-  const { isConnected, isScanning, calibrationState } = useBLE();
+  const { isConnected, isScanning, calibrationState, linkInfo } = useBLE();
 
   // Local state
   const [showCalibrationModal, setShowCalibrationModal] = useState(false);
+  const [calibrationInfo, setCalibrationInfo] = useState<CalibrationInfo | null>(null);
 
   // Actions
   const {
@@ -17,9 +19,52 @@ export const useDeviceSettings = () => {
     disconnect,
     setCalibrationState,
     startQuickCalibration,
+    startSixPositionCalibration,
     abortCalibration,
+    readCalibrationInfo,
+    forgetCalibration,
   } = useBLE();
 
+  const refreshCalibrationInfo = useCallback(async () => {
+    try {
+      setCalibrationInfo(await readCalibrationInfo());
+    } catch (error) {
+      console.error('Failed to read calibration info:', error);
+      setCalibrationInfo(null);
+    }
+  }, [readCalibrationInfo]);
+
+  // The device restores its stored calibration at boot; show it on connect and after calibrating
+  useEffect(() => {
+    if (!isConnected) {
+      setCalibrationInfo(null);
+      return;
+    }
+    if (calibrationState.status !== 'in_progress') {
+      refreshCalibrationInfo();
+    }
+  }, [isConnected, calibrationState.status, refreshCalibrationInfo]);
+
+  const handleForgetCalibration = () => {
+    Alert.alert('Forget Calibration', 'Remove the calibration stored on the device?', [
+      { text: 'Cancel', style: 'cancel' },
+      {
+        text: 'Forget',
+        style: 'destructive',
+        onPress: async () => {
+          try {
+            await forgetCalibration();
+            await refreshCalibrationInfo();
+          } catch (error) {
+            const errorMessage =
+              error instanceof Error ? error.message : 'Failed to forget calibration';
+            Alert.alert('Calibration Error', errorMessage);
+          }
+        },
+      },
+    ]);
+  };
+
   // Action handlers
   const handleStartCalibrationPress = async () => {
     try {
@@ -62,6 +107,8 @@ export const useDeviceSettings = () => {
     isScanning,
     showCalibrationModal,
     calibrationState,
+    calibrationInfo,
+    linkInfo,
 
     // Actions
     startScan,
@@ -70,7 +117,9 @@ export const useDeviceSettings = () => {
     handleStartCalibration,
     handleModalClose,
     startQuickCalibration,
+    startSixPositionCalibration,
     abortCalibration,
     handleStartCalibrationPress,
+    handleForgetCalibration,
   };
 };
@@ -8,16 +8,57 @@
 
 import React, { createContext, useCallback, useContext, useState } from 'react';
 import { Alert } from 'react-native';
-import { BleError, BleManager, Characteristic, Device } from 'react-native-ble-plx';
+import { BleError, BleManager, Characteristic, Device, Subscription } from 'react-native-ble-plx';
+import { AcquisitionProfile } from '../types/acquisition';
 import { CalibrationState, CalibrationStatus, DeviceCalibrationState } from '../types/calibration';
+import { UnitRole } from '../types/unit';
+import {
+  DeviceRecordingStatus,
+  DeviceSessionInfo,
+  encodeRecordCommand,
+  parseRecordMessage,
+  RecordCommand,
+  RecordError,
+  RecordMessage,
+  RecordMessageType,
+  SessionDownload,
+} from '../utils/bulk_download';
+import { LinkInfo, parseLinkInfo } from '../utils/link_info';
+import { parsePerfStats, PerfStats } from '../utils/perf_stats';
+import { parseRepSummary, RepSummary } from '../utils/rep_summary';
+import { CalibrationInfo, parseCalibrationInfo } from '../utils/calibration_info';
+import { decodeBase64, decodeBase64Into } from '../utils/base64';
+import { SampleListener, SampleRing } from '../utils/sample_ring';
+import { StreamDecoder, StreamFormat, StreamSession } from '../utils/stream_decoder';
+import { StreamMerger } from '../utils/stream_merger';
+import {
+  ClockSync,
+  encodeTimeSyncPing,
+  parseTimeSyncEcho,
+  phoneNow,
+} from '../utils/time_sync';
 
 // Configuration constants
 const SERVICE_UUID = '4fafc201-1fb5-459e-8fcc-c5c9c331914b';
 const CHAR_ACC_UUID = 'beb5483e-36e1-4688-b7f5-ea07361b26a8';
 const CHAR_GYR_UUID = 'beb5483e-36e1-4688-b7f5-ea07361b26a9';
 const CHAR_CALIB_UUID = 'beb5483e-36e1-4688-b7f5-ea07361b26aa';
+const CHAR_STREAM_UUID = 'beb5483e-36e1-4688-b7f5-ea07361b26ab';
+const CHAR_RECORD_UUID = 'beb5483e-36e1-4688-b7f5-ea07361b26ac';
+const CHAR_REP_UUID = 'beb5483e-36e1-4688-b7f5-ea07361b26ad';
+const CHAR_LINK_UUID = 'beb5483e-36e1-4688-b7f5-ea07361b26ae';
+const CHAR_PERF_UUID = 'beb5483e-36e1-4688-b7f5-ea07361b26af';
+const CHAR_TIME_UUID = 'beb5483e-36e1-4688-b7f5-ea07361b26b0';
 const DEVICE_NAME = 'PowerFlux';
 const SCAN_TIMEOUT = 10000; // 10 seconds
+const REQUESTED_MTU = 247; // Larger MTU lets the device pack more samples per frame
+const MAX_NOTIFICATION_SIZE = 512; // Longest attribute value BLE allows
+const RECORD_REPLY_TIMEOUT = 5000; // ms without any reply from the recording characteristic
+const TIME_SYNC_BURST = 8; // Quick pings after connecting, for an offset before streaming starts
+const TIME_SYNC_BURST_INTERVAL = 250; // ms
+const TIME_SYNC_INTERVAL = 5000; // ms between pings afterwards, for the skew
+// Two full-rate streams only fit one phone's connection events in the compact format
+const MULTI_UNIT_FORMAT = StreamFormat.INT16_DELTA;
 export const BATCH_SIZE = 2;
 
 // Type definitions and interfaces
@@ -30,6 +71,17 @@ export interface SensorData {
   gyrZ: number;
   temperature?: number;
   timestamp: number;
+  // Set for on-device fusion frames: acc* is then world-frame linear acceleration
+  // with gravity removed and gyr* is zero
+  quaternion?: { w: number; x: number; y: number; z: number };
+  // Index into BLEContextType.units, set on samples of the merged multi-unit stream
+  unit?: number;
+}
+
+export interface UnitInfo {
+  deviceId: string;
+  role?: UnitRole; // From the session header, missing on older firmware
+  unitId?: number;
 }
 
 export interface BLEContextType {
@@ -41,9 +93,42 @@ export interface BLEContextType {
   disconnect: () => Promise<void>;
   calibrationState: CalibrationState;
   startQuickCalibration: () => Promise<void>;
+  startSixPositionCalibration: () => Promise<void>;
+  readCalibrationInfo: () => Promise<CalibrationInfo | null>;
+  forgetCalibration: () => Promise<void>;
   abortCalibration: () => Promise<void>;
+  setStreamFormat: (format: StreamFormat) => Promise<void>;
+  acquisitionProfile: AcquisitionProfile | null;
+  setAcquisitionProfile: (profile: AcquisitionProfile) => Promise<void>;
+  hasDeviceRecording: boolean;
+  getDeviceRecordingStatus: () => Promise<DeviceRecordingStatus>;
+  startDeviceRecording: () => Promise<DeviceRecordingStatus>;
+  stopDeviceRecording: () => Promise<DeviceRecordingStatus>;
+  eraseDeviceRecordings: () => Promise<DeviceRecordingStatus>;
+  listDeviceSessions: () => Promise<DeviceSessionInfo[]>;
+  downloadDeviceSession: (
+    info: DeviceSessionInfo,
+    onProgress?: (fraction: number) => void,
+  ) => Promise<SensorData[]>;
+  hasRepSummary: boolean;
+  lastRep: RepSummary | null;
+  reps: RepSummary[];
+  clearReps: () => void;
+  summaryOnly: boolean;
+  setSummaryOnly: (enabled: boolean) => Promise<void>;
+  linkInfo: LinkInfo | null;
+  readPerfStats: () => Promise<PerfStats | null>;
+  resetPerfStats: () => Promise<void>;
   sensorData: SensorData | null;
   setOnDataReceived: (callback: ((data: SensorData) => void) | undefined) => void;
+  // Stream samples in place, without an object per sample
+  sampleRing: SampleRing;
+  setOnSamplesReceived: (listener: SampleListener | undefined) => void;
+  units: UnitInfo[];
+  connectSecondUnit: () => Promise<void>;
+  disconnectSecondUnit: () => Promise<void>;
+  setUnitRole: (role: UnitRole, unit?: number) => Promise<void>;
+  setOnMergedDataReceived: (callback: ((data: SensorData) => void) | undefined) => void;
   onCalibrationProgress: (progress: CalibrationProgress) => void;
   setCalibrationState: React.Dispatch<React.SetStateAction<CalibrationState>>;
 }
@@ -51,6 +136,12 @@ export interface BLEContextType {
 export enum CalibrationCommand {
   ABORT = 2,
   START_QUICK = 1,
+  SET_STREAM_FORMAT = 3,
+  SET_PROFILE = 4,
+  START_SIX_POSITION = 5,
+  READ_INFO = 6,
+  FORGET = 7,
+  SET_ROLE = 8,
 }
 
 export interface CalibrationProgress {
@@ -63,6 +154,53 @@ const bleManager = new BleManager();
 const BLEContext = createContext<BLEContextType | undefined>(undefined);
 const dataCallbackRef = { current: undefined as ((data: SensorData) => void) | undefined };
 const latestData = { current: {} as Partial<SensorData> };
+const streamDecoder = new StreamDecoder();
+const streamRing = new SampleRing();
+const samplesCallbackRef = { current: undefined as SampleListener | undefined };
+// Every stream notification is decoded into this one buffer
+const notificationBytes = new Uint8Array(MAX_NOTIFICATION_SIZE);
+const recordHandlerRef = { current: undefined as ((message: RecordMessage) => void) | undefined };
+const streamSubscriptionRef = { current: undefined as Subscription | undefined };
+// Newest sample for the screen, handed to React at most once per display frame
+const sensorDataFrame = {
+  pending: null as SensorData | null,
+  request: undefined as number | undefined,
+};
+
+interface TimeSyncState {
+  clockSync: ClockSync;
+  timer: ReturnType<typeof setTimeout> | undefined;
+  sequence: number;
+  pending: Map<number, number>; // Ping sequence to phone send time
+}
+
+const createTimeSyncState = (): TimeSyncState => ({
+  clockSync: new ClockSync(),
+  timer: undefined,
+  sequence: 0,
+  pending: new Map(),
+});
+
+// The second unit of a multi-unit session, streaming alongside the first
+interface SecondUnit {
+  device: Device;
+  decoder: StreamDecoder;
+  ring: SampleRing;
+  timeSync: TimeSyncState;
+  subscription?: Subscription;
+}
+
+const timeSyncRef = createTimeSyncState();
+const secondUnitRef = { current: undefined as SecondUnit | undefined };
+const mergedCallbackRef = { current: undefined as ((data: SensorData) => void) | undefined };
+const streamMerger = new StreamMerger((unit, ring, sample) => {
+  const callback = mergedCallbackRef.current;
+  if (callback) {
+    const data = ring.toSensorData(sample);
+    data.unit = unit;
+    callback(data);
+  }
+});
 
 // Helper functions
 const Logger = {
@@ -86,11 +224,10 @@ const Logger = {
 
 const getConnectedDevice = async (): Promise<Device | null> => {
   try {
+    // The second unit of a multi-unit session only streams, commands go to the first
+    const secondId = secondUnitRef.current?.device.id;
     const connectedDevices = await bleManager.connectedDevices([SERVICE_UUID]);
-    if (connectedDevices.length === 0) {
-      return null;
-    }
-    return connectedDevices[0];
+    return connectedDevices.find((device) => device.id !== secondId) ?? null;
   } catch (error) {
     Logger.error('Error getting connected device:', error);
     return null;
@@ -128,6 +265,116 @@ const findCalibrationCharacteristic = async (device: Device): Promise<Characteri
   }
 };
 
+/** Writes a command to the calibration characteristic of a specific unit */
+const writeUnitCommand = (device: Device, command: number[]) =>
+  device.writeCharacteristicWithResponseForService(
+    SERVICE_UUID,
+    CHAR_CALIB_UUID,
+    btoa(String.fromCharCode.apply(null, command)),
+  );
+
+/** Moves ring samples [start, start + count) onto the phone clock in place, once synced */
+const toPhoneTime = (
+  ring: SampleRing,
+  start: number,
+  count: number,
+  clockSync: ClockSync,
+): boolean => {
+  if (!clockSync.isSynced) {
+    return false;
+  }
+  for (let n = start; n < start + count; n++) {
+    const slot = ring.slot(n);
+    ring.timestamps[slot] = clockSync.toPhoneTime(ring.timestamps[slot]);
+  }
+  return true;
+};
+
+const writeRecordCommand = async (device: Device, command: Uint8Array, withResponse = true) => {
+  const base64Command = btoa(String.fromCharCode.apply(null, Array.from(command)));
+  if (withResponse) {
+    await device.writeCharacteristicWithResponseForService(
+      SERVICE_UUID,
+      CHAR_RECORD_UUID,
+      base64Command,
+    );
+  } else {
+    await device.writeCharacteristicWithoutResponseForService(
+      SERVICE_UUID,
+      CHAR_RECORD_UUID,
+      base64Command,
+    );
+  }
+};
+
+/**
+ * Sends a recording command and feeds the replies to handle until it resolves.
+ * Rejects on a device error or when no reply arrives for RECORD_REPLY_TIMEOUT.
+ */
+const sendRecordCommand = async <T,>(
+  command: Uint8Array,
+  handle: (message: RecordMessage, resolve: (value: T) => void) => void,
+): Promise<T> => {
+  const device = await getConnectedDevice();
+  if (!device) throw new Error('No device connected');
+
+  return new Promise<T>((resolve, reject) => {
+    let timer: ReturnType<typeof setTimeout> | undefined;
+    const finish = () => {
+      clearTimeout(timer);
+      recordHandlerRef.current = undefined;
+    };
+    const fail = (error: Error) => {
+      finish();
+      reject(error);
+    };
+    const arm = () => {
+      clearTimeout(timer);
+      timer = setTimeout(() => fail(new Error('Device did not respond')), RECORD_REPLY_TIMEOUT);
+    };
+
+    recordHandlerRef.current = (message) => {
+      arm();
+      if (message.type === RecordMessageType.ERROR) {
+        fail(
+          new Error(
+            message.error === RecordError.MTU_TOO_SMALL
+              ? 'Connection MTU too small for recording transfer'
+              : `Device recording error ${message.error}`,
+          ),
+        );
+        return;
+      }
+      handle(message, (value) => {
+        finish();
+        resolve(value);
+      });
+    };
+
+    arm();
+    writeRecordCommand(device, command).catch((error) =>
+      fail(error instanceof Error ? error : new Error('Failed to send recording command')),
+    );
+  });
+};
+
+const handleRecordNotification = (
+  error: BleError | null,
+  characteristic: Characteristic | null,
+) => {
+  if (error) {
+    Logger.error('record monitoring error:', error);
+    return;
+  }
+
+  if (characteristic?.value) {
+    const message = parseRecordMessage(decodeBase64(characteristic.value));
+    if (message && recordHandlerRef.current) {
+      recordHandlerRef.current(message);
+    }
+  }
+};
+
 /**
  * BLE Provider Component
  * Manages BLE connection and data processing for the application
@@ -137,6 +384,16 @@ export const BLEProvider: React.FC<{ children: React.ReactNode }> = ({ children
   const [isConnected, setIsConnected] = useState(false);
   const [isScanning, setIsScanning] = useState(false);
   const [sensorData, setSensorData] = useState<SensorData | null>(null);
+  const [hasDeviceRecording, setHasDeviceRecording] = useState(false);
+  const [acquisitionProfile, setAcquisitionProfileState] = useState<AcquisitionProfile | null>(
+    null,
+  );
+  const [hasRepSummary, setHasRepSummary] = useState(false);
+  const [lastRep, setLastRep] = useState<RepSummary | null>(null);
+  const [reps, setReps] = useState<RepSummary[]>([]);
+  const [summaryOnly, setSummaryOnlyState] = useState(false);
+  const [linkInfo, setLinkInfo] = useState<LinkInfo | null>(null);
+  const [units, setUnits] = useState<UnitInfo[]>([]);
   const [calibrationState, setCalibrationState] = useState<CalibrationState>({
     isCalibrating: false,
     status: 'idle',
@@ -150,6 +407,46 @@ export const BLEProvider: React.FC<{ children: React.ReactNode }> = ({ children
     dataCallbackRef.current = callback;
   }, []);
 
+  const setOnSamplesReceived = useCallback((listener: SampleListener | undefined) => {
+    samplesCallbackRef.current = listener;
+  }, []);
+
+  const setOnMergedDataReceived = useCallback(
+    (callback: ((data: SensorData) => void) | undefined) => {
+      mergedCallbackRef.current = callback;
+    },
+    [],
+  );
+
+  const updateUnitInfo = (unit: number, session: StreamSession | null) => {
+    if (!session || session.role === undefined) {
+      return;
+    }
+    setUnits((prev) =>
+      prev.map((info, i) =>
+        i === unit && (info.role !== session.role || info.unitId !== session.unitId)
+          ? { ...info, role: session.role, unitId: session.unitId }
+          : info,
+      ),
+    );
+  };
+
+  const publishSensorData = (data: SensorData | null) => {
+    sensorDataFrame.pending = data;
+    if (data === null) {
+      if (sensorDataFrame.request !== undefined) {
+        cancelAnimationFrame(sensorDataFrame.request);
+        sensorDataFrame.request = undefined;
+      }
+      setSensorData(null);
+    } else if (sensorDataFrame.request === undefined) {
+      sensorDataFrame.request = requestAnimationFrame(() => {
+        sensorDataFrame.request = undefined;
+        setSensorData(sensorDataFrame.pending);
+      });
+    }
+  };
+
   const updateSensorData = useCallback(
     (data: { type: 'acc' | 'gyr'; timestamp: number; x: number; y: number; z: number }) => {
       const measurement: Partial<SensorData> = {
@@ -168,11 +465,25 @@ export const BLEProvider: React.FC<{ children: React.ReactNode }> = ({ children
         if (dataCallbackRef.current) {
           dataCallbackRef.current(completeData);
         }
+
+        // Ring listeners see per-axis firmware like a stream of one-sample frames
+        streamRing.set(
+          0,
+          completeData.timestamp,
+          completeData.accX,
+          completeData.accY,
+          completeData.accZ,
+          completeData.gyrX,
+          completeData.gyrY,
+          completeData.gyrZ,
+        );
+        streamRing.commit(1);
+        samplesCallbackRef.current?.(streamRing, streamRing.written - 1, 1);
       } else {
         latestData.current = measurement;
       }
 
-      setSensorData((prev) => ({ ...prev, ...measurement }) as SensorData);
+      publishSensorData({ ...sensorDataFrame.pending, ...measurement } as SensorData);
     },
     [],
   );
@@ -203,10 +514,212 @@ export const BLEProvider: React.FC<{ children: React.ReactNode }> = ({ children
       }
     };
 
+  const handleStreamNotification = (
+    error: BleError | null,
+    characteristic: Characteristic | null,
+  ) => {
+    if (error) {
+      Logger.error('stream monitoring error:', error);
+      return;
+    }
+
+    if (characteristic?.value) {
+      const length = decodeBase64Into(characteristic.value, notificationBytes);
+      const start = streamRing.written;
+      const count = streamDecoder.decodeInto(notificationBytes, length, streamRing);
+
+      if (count === 0) {
+        // Session headers report the profile the device is actually running
+        const profile = streamDecoder.session?.profile;
+        if (profile !== undefined) {
+          setAcquisitionProfileState(profile);
+        }
+        updateUnitInfo(0, streamDecoder.session);
+        return;
+      }
+
+      // Device timestamps onto the phone clock in place, once the first ping came back
+      const synced = toPhoneTime(streamRing, start, count, timeSyncRef.clockSync);
+
+      samplesCallbackRef.current?.(streamRing, start, count);
+
+      // Objects only for listeners that still take them
+      const dataCallback = dataCallbackRef.current;
+      if (dataCallback) {
+        for (let n = start; n < start + count; n++) {
+          dataCallback(streamRing.toSensorData(n));
+        }
+      }
+      // Unsynced timestamps cannot be lined up with the other unit
+      if (secondUnitRef.current !== undefined && synced) {
+        streamMerger.push(0, start, count);
+      }
+
+      // Ring listeners get every sample, the screen only the newest one per display frame
+      publishSensorData(streamRing.toSensorData(start + count - 1));
+    }
+  };
+
+  const handleSecondStreamNotification = (
+    error: BleError | null,
+    characteristic: Characteristic | null,
+  ) => {
+    const unit = secondUnitRef.current;
+    if (error) {
+      Logger.error('second unit stream monitoring error:', error);
+      return;
+    }
+
+    if (unit && characteristic?.value) {
+      const length = decodeBase64Into(characteristic.value, notificationBytes);
+      const start = unit.ring.written;
+      const count = unit.decoder.decodeInto(notificationBytes, length, unit.ring);
+      if (count === 0) {
+        updateUnitInfo(1, unit.decoder.session);
+        return;
+      }
+      if (toPhoneTime(unit.ring, start, count, unit.timeSync.clockSync)) {
+        streamMerger.push(1, start, count);
+      }
+    }
+  };
+
+  const handleRepNotification = (error: BleError | null, characteristic: Characteristic | null) => {
+    if (error) {
+      Logger.error('rep monitoring error:', error);
+      return;
+    }
+
+    if (characteristic?.value) {
+      const binaryString = atob(characteristic.value);
+      const bytes = new Uint8Array(binaryString.length);
+
+      for (let i = 0; i < binaryString.length; i++) {
+        bytes[i] = binaryString.charCodeAt(i);
+      }
+
+      const rep = parseRepSummary(bytes);
+      if (!rep) {
+        return;
+      }
+      if (timeSyncRef.clockSync.isSynced) {
+        rep.phoneEndTime = timeSyncRef.clockSync.toPhoneTime(rep.endTime);
+      }
+
+      // The device restarts counting after a reconnect or calibration
+      setReps((prev) => (rep.repNumber <= 1 ? [rep] : [...prev, rep]));
+      setLastRep(rep);
+    }
+  };
+
+  const handleLinkNotification = (
+    error: BleError | null,
+    characteristic: Characteristic | null,
+  ) => {
+    if (error) {
+      Logger.error('link monitoring error:', error);
+      return;
+    }
+
+    if (characteristic?.value) {
+      const binaryString = atob(characteristic.value);
+      const bytes = new Uint8Array(binaryString.length);
+
+      for (let i = 0; i < binaryString.length; i++) {
+        bytes[i] = binaryString.charCodeAt(i);
+      }
+
+      const info = parseLinkInfo(bytes);
+      if (info) {
+        Logger.info('Link parameters:', info);
+        setLinkInfo(info);
+      }
+    }
+  };
+
+  const createTimeSyncHandler =
+    (state: TimeSyncState) => (error: BleError | null, characteristic: Characteristic | null) => {
+      const receivedMs = phoneNow();
+      if (error) {
+        Logger.error('time sync monitoring error:', error);
+        return;
+      }
+
+      if (characteristic?.value) {
+        const echo = parseTimeSyncEcho(decodeBase64(characteristic.value));
+        const sentMs = echo ? state.pending.get(echo.sequence) : undefined;
+        if (!echo || sentMs === undefined) {
+          return;
+        }
+        state.pending.delete(echo.sequence);
+        state.clockSync.addExchange(sentMs, receivedMs, echo);
+      }
+    };
+
+  const stopTimeSync = (state: TimeSyncState) => {
+    clearTimeout(state.timer);
+    state.timer = undefined;
+    state.pending.clear();
+    state.clockSync.reset();
+  };
+
+  /** Pings every unit separately: each has its own crystal and so its own skew */
+  const startTimeSync = (device: Device, state: TimeSyncState) => {
+    stopTimeSync(state);
+    device.monitorCharacteristicForService(
+      SERVICE_UUID,
+      CHAR_TIME_UUID,
+      createTimeSyncHandler(state),
+    );
+
+    let pings = 0;
+    const ping = async () => {
+      const sequence = state.sequence;
+      state.sequence = (sequence + 1) & 0xffff;
+      // Lost echoes would otherwise pile up
+      state.pending.clear();
+      state.pending.set(sequence, phoneNow());
+      try {
+        await device.writeCharacteristicWithoutResponseForService(
+          SERVICE_UUID,
+          CHAR_TIME_UUID,
+          btoa(String.fromCharCode.apply(null, encodeTimeSyncPing(sequence))),
+        );
+      } catch (error) {
+        Logger.warn('Time sync ping failed:', error);
+        return;
+      }
+
+      pings++;
+      if (pings === TIME_SYNC_BURST) {
+        Logger.info(
+          `Clock of ${device.id} synced, best round trip ` +
+            `${state.clockSync.bestRoundTripMs.toFixed(1)} ms`,
+        );
+      }
+      state.timer = setTimeout(
+        ping,
+        pings < TIME_SYNC_BURST ? TIME_SYNC_BURST_INTERVAL : TIME_SYNC_INTERVAL,
+      );
+    };
+    ping();
+  };
+
+  const subscribeStream = (device: Device) => {
+    // The device sends a fresh session header on every subscribe
+    streamDecoder.reset();
+    streamSubscriptionRef.current = device.monitorCharacteristicForService(
+      SERVICE_UUID,
+      CHAR_STREAM_UUID,
+      handleStreamNotification,
+    );
+  };
+
   const handleCalibrationProgress = useCallback((progress: CalibrationProgress) => {
     const getStatus = (state: DeviceCalibrationState): CalibrationStatus => {
       switch (state) {
         case DeviceCalibrationState.QUICK_COMPLETE:
+        case DeviceCalibrationState.SIX_COMPLETE:
           return 'completed';
         case DeviceCalibrationState.FAILED:
           return 'failed';
@@ -221,6 +734,7 @@ export const BLEProvider: React.FC<{ children: React.ReactNode }> = ({ children
       ...prev,
       isCalibrating:
         progress.state !== DeviceCalibrationState.QUICK_COMPLETE &&
+        progress.state !== DeviceCalibrationState.SIX_COMPLETE &&
         progress.state !== DeviceCalibrationState.FAILED,
       status: getStatus(progress.state),
       progress: progress.progress,
@@ -295,26 +809,84 @@ export const BLEProvider: React.FC<{ children: React.ReactNode }> = ({ children
           bleManager.stopDeviceScan();
 
           try {
-            const connectedDevice = await device.connect();
+            const connectedDevice = await device.connect({ requestMTU: REQUESTED_MTU });
             await connectedDevice.discoverAllServicesAndCharacteristics();
             Logger.info('Device connected and services discovered');
 
-            // Monitor both accelerometer and gyroscope data with single processing logic
-            connectedDevice.monitorCharacteristicForService(
-              SERVICE_UUID,
-              CHAR_ACC_UUID,
-              createCharacteristicHandler('acc'),
-            );
-
-            connectedDevice.monitorCharacteristicForService(
-              SERVICE_UUID,
-              CHAR_GYR_UUID,
-              createCharacteristicHandler('gyr'),
-            );
+            const characteristics = await connectedDevice.characteristicsForService(SERVICE_UUID);
+            const hasStream = characteristics.some((c) => c.uuid === CHAR_STREAM_UUID);
+
+            // Summary-only mode needs device rep detection to be of any use
+            const hasRep = characteristics.some((c) => c.uuid === CHAR_REP_UUID);
+            const streamWanted = !(summaryOnly && hasRep);
+
+            if (hasStream) {
+              // Batched frames carry accelerometer and gyroscope together
+              if (streamWanted) {
+                subscribeStream(connectedDevice);
+              }
+            } else {
+              // Older firmware: monitor both per-axis characteristics
+              Logger.info('Stream characteristic not found, using per-axis characteristics');
+              connectedDevice.monitorCharacteristicForService(
+                SERVICE_UUID,
+                CHAR_ACC_UUID,
+                createCharacteristicHandler('acc'),
+              );
+
+              connectedDevice.monitorCharacteristicForService(
+                SERVICE_UUID,
+                CHAR_GYR_UUID,
+                createCharacteristicHandler('gyr'),
+              );
+            }
+
+            // Recording download is only offered by firmware with on-device storage
+            const hasRecord = characteristics.some((c) => c.uuid === CHAR_RECORD_UUID);
+            if (hasRecord) {
+              connectedDevice.monitorCharacteristicForService(
+                SERVICE_UUID,
+                CHAR_RECORD_UUID,
+                handleRecordNotification,
+              );
+            }
+            setHasDeviceRecording(hasRecord);
+
+            if (hasRep) {
+              connectedDevice.monitorCharacteristicForService(
+                SERVICE_UUID,
+                CHAR_REP_UUID,
+                handleRepNotification,
+              );
+            }
+            setHasRepSummary(hasRep);
+            setReps([]);
+            setLastRep(null);
+
+            // Negotiated MTU, interval and data length, notified on every change
+            const hasLink = characteristics.some((c) => c.uuid === CHAR_LINK_UUID);
+            setLinkInfo(null);
+            if (hasLink) {
+              handleLinkNotification(
+                null,
+                await connectedDevice.readCharacteristicForService(SERVICE_UUID, CHAR_LINK_UUID),
+              );
+              connectedDevice.monitorCharacteristicForService(
+                SERVICE_UUID,
+                CHAR_LINK_UUID,
+                handleLinkNotification,
+              );
+            }
+
+            // Maps sample timestamps onto the phone clock
+            if (characteristics.some((c) => c.uuid === CHAR_TIME_UUID)) {
+              startTimeSync(connectedDevice, timeSyncRef);
+            }
 
             // Monitor calibration progress
             setupCalibrationMonitoring(connectedDevice);
 
+            setUnits([{ deviceId: connectedDevice.id }]);
             setIsConnected(true);
             setIsScanning(false);
             Logger.info('Device setup complete');
@@ -340,7 +912,7 @@ export const BLEProvider: React.FC<{ children: React.ReactNode }> = ({ children
       setIsScanning(false);
       Alert.alert('Scan Error', 'Failed to start scanning');
     }
-  }, [isScanning, updateSensorData]);
+  }, [isScanning, summaryOnly, updateSensorData]);
 
   const stopScan = useCallback(() => {
     if (isScanning) {
@@ -355,6 +927,17 @@ export const BLEProvider: React.FC<{ children: React.ReactNode }> = ({ children
       Logger.info('Initiating disconnect');
       const connectedDevices = await bleManager.connectedDevices([SERVICE_UUID]);
 
+      // Shared link settings would otherwise stick to units used alone next time
+      if (secondUnitRef.current) {
+        await Promise.all(
+          connectedDevices.map((device) =>
+            writeUnitCommand(device, [CalibrationCommand.SET_ROLE, UnitRole.SOLO]).catch((error) =>
+              Logger.warn(`Failed to reset the role of ${device.id}:`, error),
+            ),
+          ),
+        );
+      }
+
       // Properly disconnect from each device and wait for all to complete
       await Promise.all(
         connectedDevices.map(async (device) => {
@@ -371,8 +954,21 @@ export const BLEProvider: React.FC<{ children: React.ReactNode }> = ({ children
       );
 
       // Reset all state
+      stopTimeSync(timeSyncRef);
+      if (secondUnitRef.current) {
+        stopTimeSync(secondUnitRef.current.timeSync);
+        secondUnitRef.current = undefined;
+      }
+      streamMerger.reset();
+      setUnits([]);
       setIsConnected(false);
-      setSensorData(null);
+      publishSensorData(null);
+      setHasDeviceRecording(false);
+      setAcquisitionProfileState(null);
+      setHasRepSummary(false);
+      setLinkInfo(null);
+      recordHandlerRef.current = undefined;
+      streamSubscriptionRef.current = undefined;
       setCalibrationState({
         isCalibrating: false,
         status: 'idle',
@@ -388,6 +984,128 @@ export const BLEProvider: React.FC<{ children: React.ReactNode }> = ({ children
     }
   }, []);
 
+  /**
+   * Connects a second unit and merges both streams in phone time, e.g. the two
+   * ends of a bar. Both units get a bar role, which tunes their connection
+   * intervals for sharing the phone, and the compact stream format.
+   */
+  const connectSecondUnit = useCallback(async () => {
+    const primary = await getConnectedDevice();
+    if (!primary) throw new Error('No device connected');
+    if (secondUnitRef.current) {
+      return;
+    }
+
+    const found = await new Promise<Device>((resolve, reject) => {
+      const timer = setTimeout(() => {
+        bleManager.stopDeviceScan();
+        reject(new Error('No second unit found'));
+      }, SCAN_TIMEOUT);
+
+      bleManager.startDeviceScan(null, { allowDuplicates: false }, (error, device) => {
+        if (error) {
+          clearTimeout(timer);
+          bleManager.stopDeviceScan();
+          reject(error);
+        } else if (device?.name === DEVICE_NAME && device.id !== primary.id) {
+          clearTimeout(timer);
+          bleManager.stopDeviceScan();
+          resolve(device);
+        }
+      });
+    });
+
+    const device = await found.connect({ requestMTU: REQUESTED_MTU });
+    await device.discoverAllServicesAndCharacteristics();
+    const characteristics = await device.characteristicsForService(SERVICE_UUID);
+    const required = [CHAR_STREAM_UUID, CHAR_TIME_UUID];
+    if (!required.every((uuid) => characteristics.some((c) => c.uuid === uuid))) {
+      await device.cancelConnection();
+      throw new Error('Second unit firmware does not support multi-unit streaming');
+    }
+
+    const primaryCommands = [
+      [CalibrationCommand.SET_ROLE, UnitRole.BAR_LEFT],
+      [CalibrationCommand.SET_STREAM_FORMAT, MULTI_UNIT_FORMAT],
+    ];
+    const secondCommands = [
+      [CalibrationCommand.SET_ROLE, UnitRole.BAR_RIGHT],
+      [CalibrationCommand.SET_STREAM_FORMAT, MULTI_UNIT_FORMAT],
+    ];
+    for (const command of primaryCommands) {
+      await writeUnitCommand(primary, command);
+    }
+    for (const command of secondCommands) {
+      await writeUnitCommand(device, command);
+    }
+
+    const unit: SecondUnit = {
+      device,
+      decoder: new StreamDecoder(),
+      ring: new SampleRing(),
+      timeSync: createTimeSyncState(),
+    };
+    secondUnitRef.current = unit;
+    streamMerger.reset();
+    streamMerger.addUnit(0, streamRing);
+    streamMerger.addUnit(1, unit.ring);
+    setUnits((prev) => [...prev.slice(0, 1), { deviceId: device.id }]);
+
+    startTimeSync(device, unit.timeSync);
+    unit.subscription = device.monitorCharacteristicForService(
+      SERVICE_UUID,
+      CHAR_STREAM_UUID,
+      handleSecondStreamNotification,
+    );
+
+    device.onDisconnected(() => {
+      if (secondUnitRef.current?.device.id !== device.id) {
+        return;
+      }
+      Logger.warn('Second unit disconnected');
+      stopTimeSync(unit.timeSync);
+      secondUnitRef.current = undefined;
+      streamMerger.removeUnit(1);
+      setUnits((prev) => prev.slice(0, 1));
+    });
+    Logger.info(`Second unit connected: ${device.id}`);
+  }, []);
+
+  const disconnectSecondUnit = useCallback(async () => {
+    const unit = secondUnitRef.current;
+    if (!unit) {
+      return;
+    }
+
+    secondUnitRef.current = undefined;
+    stopTimeSync(unit.timeSync);
+    unit.subscription?.remove();
+    streamMerger.reset();
+    setUnits((prev) => prev.slice(0, 1));
+
+    const primary = await getConnectedDevice();
+    if (primary) {
+      await writeUnitCommand(primary, [CalibrationCommand.SET_ROLE, UnitRole.SOLO]);
+    }
+    await writeUnitCommand(unit.device, [CalibrationCommand.SET_ROLE, UnitRole.SOLO]).catch(
+      (error) => Logger.warn('Failed to reset the second unit role:', error),
+    );
+    await unit.device.cancelConnection();
+    Logger.info('Second unit disconnected');
+  }, []);
+
+  /**
+   * Sets the role of a unit, kept on the device across reboots
+   * @param unit Index into units, the first unit by default
+   */
+  const setUnitRole = useCallback(async (role: UnitRole, unit = 0) => {
+    const device = unit === 0 ? await getConnectedDevice() : secondUnitRef.current?.device;
+    if (!device) throw new Error('No device connected');
+
+    await writeUnitCommand(device, [CalibrationCommand.SET_ROLE, role]);
+    Logger.info(`Unit ${unit} role set to ${role}`);
+  }, []);
+
   // Calibration operations
   const startQuickCalibration = useCallback(async () => {
     try {
@@ -453,6 +1171,118 @@ export const BLEProvider: React.FC<{ children: React.ReactNode }> = ({ children
     }
   }, []);
 
+  /**
+   * Starts the six-position calibration: the device is rested on each of its
+   * faces in any order and fits per-axis scale, cross-axis terms and bias.
+   */
+  const startSixPositionCalibration = useCallback(async () => {
+    try {
+      const device = await getConnectedDevice();
+      if (!device) throw new Error('No device connected');
+
+      setCalibrationState({
+        isCalibrating: true,
+        status: 'in_progress',
+        progress: 0,
+        error: undefined,
+        deviceState: DeviceCalibrationState.SIX_WAITING_POSITION,
+      });
+
+      const characteristic = await findCalibrationCharacteristic(device);
+      if (!characteristic) throw new Error('Calibration characteristic not found');
+
+      const command = new Uint8Array([CalibrationCommand.START_SIX_POSITION]);
+      await characteristic.writeWithResponse(btoa(String.fromCharCode.apply(null, command)));
+    } catch (error) {
+      Logger.error('Six-position calibration error:', error);
+      setCalibrationState({
+        isCalibrating: false,
+        status: 'failed',
+        progress: 0,
+        error: error instanceof Error ? error.message : 'Unknown calibration error',
+        deviceState: DeviceCalibrationState.FAILED,
+      });
+      throw error;
+    }
+  }, []);
+
+  /**
+   * Reads the active calibration; null for firmware without stored calibration
+   */
+  const readCalibrationInfo = useCallback(async (): Promise<CalibrationInfo | null> => {
+    const device = await getConnectedDevice();
+    if (!device) throw new Error('No device connected');
+
+    const characteristic = await findCalibrationCharacteristic(device);
+    if (!characteristic) throw new Error('Calibration characteristic not found');
+
+    const command = new Uint8Array([CalibrationCommand.READ_INFO]);
+    await characteristic.writeWithResponse(btoa(String.fromCharCode.apply(null, command)));
+
+    const response = await characteristic.read();
+    if (!response?.value) {
+      return null;
+    }
+    const binaryString = atob(response.value);
+    const bytes = new Uint8Array(binaryString.length);
+    for (let i = 0; i < binaryString.length; i++) {
+      bytes[i] = binaryString.charCodeAt(i);
+    }
+    return parseCalibrationInfo(bytes);
+  }, []);
+
+  /**
+   * Invalidates the device calibration, including the copy kept across power cycles
+   */
+  const forgetCalibration = useCallback(async () => {
+    const device = await getConnectedDevice();
+    if (!device) throw new Error('No device connected');
+
+    const characteristic = await findCalibrationCharacteristic(device);
+    if (!characteristic) throw new Error('Calibration characteristic not found');
+
+    const command = new Uint8Array([CalibrationCommand.FORGET]);
+    await characteristic.writeWithResponse(btoa(String.fromCharCode.apply(null, command)));
+    Logger.info('Device calibration forgotten');
+  }, []);
+
+  /**
+   * Reads the firmware timing and memory counters; null for firmware without them
+   */
+  const readPerfStats = useCallback(async (): Promise<PerfStats | null> => {
+    const device = await getConnectedDevice();
+    if (!device) throw new Error('No device connected');
+
+    const characteristics = await device.characteristicsForService(SERVICE_UUID);
+    if (!characteristics.some((c) => c.uuid === CHAR_PERF_UUID)) {
+      return null;
+    }
+
+    const response = await device.readCharacteristicForService(SERVICE_UUID, CHAR_PERF_UUID);
+    if (!response?.value) {
+      return null;
+    }
+    const binaryString = atob(response.value);
+    const bytes = new Uint8Array(binaryString.length);
+    for (let i = 0; i < binaryString.length; i++) {
+      bytes[i] = binaryString.charCodeAt(i);
+    }
+    return parsePerfStats(bytes);
+  }, []);
+
+  const resetPerfStats = useCallback(async () => {
+    const device = await getConnectedDevice();
+    if (!device) throw new Error('No device connected');
+
+    const command = new Uint8Array([1]);
+    await device.writeCharacteristicWithResponseForService(
+      SERVICE_UUID,
+      CHAR_PERF_UUID,
+      btoa(String.fromCharCode.apply(null, command)),
+    );
+    Logger.info('Device perf counters reset');
+  }, []);
+
   const abortCalibration = useCallback(async () => {
     try {
       const device = await getConnectedDevice();
@@ -477,6 +1307,149 @@ export const BLEProvider: React.FC<{ children: React.ReactNode }> = ({ children
     }
   }, []);
 
+  const setStreamFormat = useCallback(async (format: StreamFormat) => {
+    try {
+      const device = await getConnectedDevice();
+      if (!device) throw new Error('No device connected');
+
+      const characteristic = await findCalibrationCharacteristic(device);
+      if (!characteristic) throw new Error('Calibration characteristic not found');
+
+      const command = new Uint8Array([CalibrationCommand.SET_STREAM_FORMAT, format]);
+      const base64Command = btoa(String.fromCharCode.apply(null, Array.from(command)));
+
+      await characteristic.writeWithResponse(base64Command);
+      Logger.info(`Stream format set to ${format}`);
+    } catch (error) {
+      Logger.error('Set stream format error:', error);
+      throw error;
+    }
+  }, []);
+
+  const setAcquisitionProfile = useCallback(async (profile: AcquisitionProfile) => {
+    try {
+      const device = await getConnectedDevice();
+      if (!device) throw new Error('No device connected');
+
+      const characteristic = await findCalibrationCharacteristic(device);
+      if (!characteristic) throw new Error('Calibration characteristic not found');
+
+      const command = new Uint8Array([CalibrationCommand.SET_PROFILE, profile]);
+      const base64Command = btoa(String.fromCharCode.apply(null, Array.from(command)));
+
+      await characteristic.writeWithResponse(base64Command);
+      Logger.info(`Acquisition profile set to ${profile}`);
+    } catch (error) {
+      Logger.error('Set acquisition profile error:', error);
+      throw error;
+    }
+  }, []);
+
+  // Device recording operations
+  const sendRecordStatusCommand = (command: RecordCommand) =>
+    sendRecordCommand<DeviceRecordingStatus>(encodeRecordCommand(command), (message, resolve) => {
+      if (message.type === RecordMessageType.STATUS) {
+        resolve(message.status);
+      }
+    });
+
+  const getDeviceRecordingStatus = useCallback(
+    () => sendRecordStatusCommand(RecordCommand.STATUS),
+    [],
+  );
+  const startDeviceRecording = useCallback(() => sendRecordStatusCommand(RecordCommand.START), []);
+  const stopDeviceRecording = useCallback(() => sendRecordStatusCommand(RecordCommand.STOP), []);
+  const eraseDeviceRecordings = useCallback(
+    () => sendRecordStatusCommand(RecordCommand.ERASE_ALL),
+    [],
+  );
+
+  const listDeviceSessions = useCallback(() => {
+    const sessions: DeviceSessionInfo[] = [];
+    return sendRecordCommand<DeviceSessionInfo[]>(
+      encodeRecordCommand(RecordCommand.LIST),
+      (message, resolve) => {
+        if (message.type === RecordMessageType.SESSION_INFO) {
+          sessions.push(message.info);
+        } else if (message.type === RecordMessageType.LIST_END) {
+          resolve(sessions);
+        }
+      },
+    );
+  }, []);
+
+  const downloadDeviceSession = useCallback(
+    async (info: DeviceSessionInfo, onProgress?: (fraction: number) => void) => {
+      const device = await getConnectedDevice();
+      if (!device) throw new Error('No device connected');
+
+      const download = new SessionDownload(info);
+      const startedAt = Date.now();
+
+      const data = await sendRecordCommand<SensorData[]>(
+        encodeRecordCommand(RecordCommand.DOWNLOAD, info.sessionId, 0),
+        (message, resolve) => {
+          if (message.type === RecordMessageType.DATA && message.sessionId === info.sessionId) {
+            const ack = download.handleData(message.firstSample, message.payload);
+            if (ack === null) {
+              return;
+            }
+
+            // Acknowledgements must not stall the window, so skip the write response
+            writeRecordCommand(
+              device,
+              encodeRecordCommand(RecordCommand.ACK, info.sessionId, ack),
+              false,
+            ).catch((error) => Logger.warn('ACK write failed:', error));
+            onProgress?.(download.receivedSamples / Math.max(info.sampleCount, 1));
+          } else if (
+            message.type === RecordMessageType.DOWNLOAD_END &&
+            message.sessionId === info.sessionId
+          ) {
+            resolve(download.toSensorData());
+          }
+        },
+      );
+
+      const seconds = (Date.now() - startedAt) / 1000;
+      Logger.info(
+        `Downloaded session ${info.sessionId}: ${data.length} samples in ${seconds.toFixed(1)} s`,
+      );
+      return data;
+    },
+    [],
+  );
+
+  const clearReps = useCallback(() => {
+    setReps([]);
+    setLastRep(null);
+  }, []);
+
+  /**
+   * Summary-only mode unsubscribes from the stream so the device stops sending
+   * samples and only notifies rep summaries, which saves radio time and power.
+   */
+  const setSummaryOnly = useCallback(async (enabled: boolean) => {
+    setSummaryOnlyState(enabled);
+
+    const device = await getConnectedDevice();
+    if (!device) {
+      return;
+    }
+
+    if (enabled) {
+      streamSubscriptionRef.current?.remove();
+      streamSubscriptionRef.current = undefined;
+      Logger.info('Stream unsubscribed, receiving rep summaries only');
+    } else if (!streamSubscriptionRef.current) {
+      const characteristics = await device.characteristicsForService(SERVICE_UUID);
+      if (characteristics.some((c) => c.uuid === CHAR_STREAM_UUID)) {
+        subscribeStream(device);
+        Logger.info('Stream resubscribed');
+      }
+    }
+  }, []);
+
   return (
     <BLEContext.Provider
       value={{
@@ -490,8 +1463,37 @@ export const BLEProvider: React.FC<{ children: React.ReactNode }> = ({ children
         calibrationState,
         setCalibrationState,
         startQuickCalibration,
+        startSixPositionCalibration,
+        readCalibrationInfo,
+        forgetCalibration,
         abortCalibration,
+        setStreamFormat,
+        acquisitionProfile,
+        setAcquisitionProfile,
+        hasDeviceRecording,
+        getDeviceRecordingStatus,
+        startDeviceRecording,
+        stopDeviceRecording,
+        eraseDeviceRecordings,
+        listDeviceSessions,
+        downloadDeviceSession,
+        hasRepSummary,
+        lastRep,
+        reps,
+        clearReps,
+        summaryOnly,
+        setSummaryOnly,
+        linkInfo,
+        readPerfStats,
+        resetPerfStats,
         setOnDataReceived,
+        sampleRing: streamRing,
+        setOnSamplesReceived,
+        units,
+        connectSecondUnit,
+        disconnectSecondUnit,
+        setUnitRole,
+        setOnMergedDataReceived,
         onCalibrationProgress: handleCalibrationProgress,
       }}
     >
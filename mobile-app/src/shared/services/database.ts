@@ -1,5 +1,14 @@
 import * as SQLite from 'expo-sqlite';
 import { Platform } from 'react-native';
+import { ANALYTICS_VERSION, RepAnalyzer } from '../utils/rep_analytics';
+import type {
+  AnalyticsResult,
+  RepAnalytics,
+  SessionAnalytics,
+  SetAnalytics,
+} from '../utils/rep_analytics';
+import { decodeSampleChunk, encodeSampleChunk } from '../utils/sample_chunk';
+import { SAMPLE_CHANNELS, SampleRing } from '../utils/sample_ring';
 
 interface IMeasurement {
   id?: number;
@@ -21,9 +30,24 @@ interface ISession {
   comments: string | null;
 }
 
-interface MeasurementBuffer {
-  data: IMeasurement[];
-  lastWrite: number;
+/** Start and end of a rep in ms on the phone clock */
+export interface RepBoundary {
+  startTime: number;
+  endTime: number;
+}
+
+/** Index entry of one stored chunk, readable without touching its samples */
+export interface ChunkIndex {
+  chunkIndex: number;
+  startTime: number;
+  endTime: number;
+  sampleCount: number;
+  reps: RepBoundary[];
+}
+
+/** Session with its cached metrics, null until they are computed */
+export interface SessionSummary extends ISession {
+  analytics: SessionAnalytics | null;
 }
 
 export interface SessionUpdate {
@@ -31,15 +55,69 @@ export interface SessionUpdate {
   comments?: string;
 }
 
+/** Live recording write statistics, for spotting a flush that falls behind */
+export interface IngestStats {
+  pendingRows: number; // Buffered, not yet written
+  writtenRows: number;
+  droppedRows: number; // Refused because the buffer was full
+  rowsPerSecond: number; // Write throughput while flushing
+  lastFlushMs: number;
+  maxFlushMs: number;
+}
+
+interface ChunkRow {
+  chunkIndex: number;
+  startTime: number;
+  endTime: number;
+  sampleCount: number;
+  repBoundaries: string | null; // JSON RepBoundary[]
+  data: Uint8Array;
+}
+
+type SessionSummaryRow = ISession & { [K in keyof SessionAnalytics]: number | null };
+
+interface ChunkWrite {
+  sessionId: string;
+  chunkIndex: number;
+  startTime: number;
+  endTime: number;
+  sampleCount: number;
+  reps: RepBoundary[];
+  data: Uint8Array;
+}
+
 class DatabaseService {
   private db: SQLite.SQLiteDatabase | null = null;
   private dbInitPromise: Promise<void>;
-  private measurementBuffer: MeasurementBuffer = {
-    data: [],
-    lastWrite: Date.now(),
+  private flushPromise: Promise<void> | null = null;
+  private flushTimer: ReturnType<typeof setInterval> | null = null;
+  private insertStatement: Promise<SQLite.SQLiteStatement> | null = null;
+  private nextChunkIndex = new Map<string, number>(); // Per recording session
+  private pendingReps = new Map<string, RepBoundary[]>(); // Marked since the last chunk
+  private stats: IngestStats = {
+    pendingRows: 0,
+    writtenRows: 0,
+    droppedRows: 0,
+    rowsPerSecond: 0,
+    lastFlushMs: 0,
+    maxFlushMs: 0,
   };
-  private readonly BATCH_SIZE = 50;
-  private readonly WRITE_INTERVAL = 1000;
+  private flushTimeMs = 0; // Total time spent in flushes
+  // Samples per stored chunk: about 10 kB, and what a crash can lose of a recording
+  private readonly CHUNK_SAMPLES = 1000;
+  private readonly FLUSH_INTERVAL = 250; // ms
+  // Writers wait for a flush above this, e.g. 4 s at 1 kHz
+  private readonly HIGH_WATER_ROWS = 4000;
+  // New rows are refused above this, so a stalled database cannot exhaust memory
+  private readonly MAX_PENDING_ROWS = 20000;
+  // Samples waiting for a flush, columnar like SampleRing, all of pendingSessionId
+  private pendingTimestamps = new Float64Array(this.MAX_PENDING_ROWS);
+  private pendingValues = new Float32Array(this.MAX_PENDING_ROWS * SAMPLE_CHANNELS);
+  private pendingCount = 0;
+  private pendingSessionId: string | null = null;
+  private failedChunks: ChunkWrite[] = []; // Encoded already, retried first on the next flush
+  private analyticsQueue: Promise<unknown> = Promise.resolve(); // One analysis at a time
+  private analyticsJobs = new Map<string, Promise<boolean>>(); // Queued or running, per session
 
   constructor() {
     if (Platform.OS === 'web') {
@@ -72,6 +150,58 @@ class DatabaseService {
                     sessionId TEXT,
                     FOREIGN KEY (sessionId) REFERENCES sessions (id)
                 );
+                CREATE TABLE IF NOT EXISTS sample_chunks (
+                    sessionId TEXT NOT NULL,
+                    chunkIndex INTEGER NOT NULL,
+                    startTime REAL NOT NULL,
+                    endTime REAL NOT NULL,
+                    sampleCount INTEGER NOT NULL,
+                    repBoundaries TEXT,
+                    data BLOB NOT NULL,
+                    PRIMARY KEY (sessionId, chunkIndex),
+                    FOREIGN KEY (sessionId) REFERENCES sessions (id)
+                );
+                CREATE INDEX IF NOT EXISTS sample_chunks_time
+                    ON sample_chunks (sessionId, startTime);
+                CREATE TABLE IF NOT EXISTS session_analytics (
+                    sessionId TEXT PRIMARY KEY,
+                    algorithmVersion INTEGER NOT NULL,
+                    computedAt INTEGER NOT NULL,
+                    repCount INTEGER NOT NULL,
+                    setCount INTEGER NOT NULL,
+                    meanVelocity REAL NOT NULL,
+                    peakVelocity REAL NOT NULL,
+                    meanRangeOfMotion REAL NOT NULL,
+                    timeUnderTensionMs REAL NOT NULL,
+                    maxVelocityLoss REAL NOT NULL,
+                    FOREIGN KEY (sessionId) REFERENCES sessions (id)
+                );
+                CREATE TABLE IF NOT EXISTS set_analytics (
+                    sessionId TEXT NOT NULL,
+                    setIndex INTEGER NOT NULL,
+                    startTime REAL NOT NULL,
+                    endTime REAL NOT NULL,
+                    repCount INTEGER NOT NULL,
+                    bestMeanVelocity REAL NOT NULL,
+                    lastMeanVelocity REAL NOT NULL,
+                    velocityLoss REAL NOT NULL,
+                    PRIMARY KEY (sessionId, setIndex),
+                    FOREIGN KEY (sessionId) REFERENCES sessions (id)
+                );
+                CREATE TABLE IF NOT EXISTS rep_analytics (
+                    sessionId TEXT NOT NULL,
+                    repIndex INTEGER NOT NULL,
+                    setIndex INTEGER NOT NULL,
+                    startTime REAL NOT NULL,
+                    endTime REAL NOT NULL,
+                    meanVelocity REAL NOT NULL,
+                    peakVelocity REAL NOT NULL,
+                    rangeOfMotion REAL NOT NULL,
+                    concentricMs REAL NOT NULL,
+                    timeUnderTensionMs REAL NOT NULL,
+                    PRIMARY KEY (sessionId, repIndex),
+                    FOREIGN KEY (sessionId) REFERENCES sessions (id)
+                );
             `);
     } catch (error) {
       console.error('Database initialization error:', error);
@@ -84,38 +214,161 @@ class DatabaseService {
     if (!this.db) throw new Error('Database not initialized');
   }
 
-  private async flushBuffer(): Promise<void> {
-    if (this.measurementBuffer.data.length === 0) return;
-
-    const measurements = [...this.measurementBuffer.data];
-    this.measurementBuffer.data = [];
-    this.measurementBuffer.lastWrite = Date.now();
+  /**
+   * Prepares the chunk insert once and reuses it for every flush and import,
+   * so SQLite does not parse the statement per chunk.
+   */
+  private getInsertStatement(): Promise<SQLite.SQLiteStatement> {
+    if (!this.insertStatement) {
+      this.insertStatement = this.db!.prepareAsync(
+        `INSERT INTO sample_chunks
+             (sessionId, chunkIndex, startTime, endTime, sampleCount, repBoundaries, data)
+             VALUES (?, ?, ?, ?, ?, ?, ?)`,
+      );
+      this.insertStatement.catch(() => {
+        this.insertStatement = null;
+      });
+    }
+    return this.insertStatement;
+  }
 
-    try {
-      // Execute without transaction wrapper since it might be called within another transaction
-      const placeholders = measurements.map(() => '(?, ?, ?, ?, ?, ?, ?, ?)').join(',');
-
-      const values = measurements.flatMap((m) => [
-        m.accX,
-        m.accY,
-        m.accZ,
-        m.gyrX,
-        m.gyrY,
-        m.gyrZ,
-        m.timestamp,
-        m.sessionId,
+  /**
+   * Inserts encoded chunks; the caller owns the transaction
+   */
+  private async insertChunks(chunks: ChunkWrite[]): Promise<void> {
+    const statement = await this.getInsertStatement();
+    for (const chunk of chunks) {
+      await statement.executeAsync([
+        chunk.sessionId,
+        chunk.chunkIndex,
+        chunk.startTime,
+        chunk.endTime,
+        chunk.sampleCount,
+        chunk.reps.length > 0 ? JSON.stringify(chunk.reps) : null,
+        chunk.data,
       ]);
+    }
+  }
 
-      await this.db!.runAsync(
-        `INSERT INTO measurements 
-             (accX, accY, accZ, gyrX, gyrY, gyrZ, timestamp, sessionId)
-             VALUES ${placeholders}`,
-        values,
+  /**
+   * Packs samples [0, count) of the columns into chunks of CHUNK_SAMPLES,
+   * numbered from firstIndex
+   */
+  private encodeChunks(
+    sessionId: string,
+    firstIndex: number,
+    timestamps: Float64Array,
+    values: Float32Array,
+    count: number,
+  ): ChunkWrite[] {
+    const chunks: ChunkWrite[] = [];
+    for (let start = 0; start < count; start += this.CHUNK_SAMPLES) {
+      const sampleCount = Math.min(this.CHUNK_SAMPLES, count - start);
+      chunks.push({
+        sessionId,
+        chunkIndex: firstIndex + chunks.length,
+        startTime: timestamps[start],
+        endTime: timestamps[start + sampleCount - 1],
+        sampleCount,
+        reps: [],
+        data: encodeSampleChunk(timestamps, values, start, sampleCount),
+      });
+    }
+    return chunks;
+  }
+
+  /**
+   * Writes what is buffered in one transaction. Only one flush runs at a
+   * time; rows stored meanwhile go into the next one.
+   */
+  private flushBuffer(final = false): Promise<void> {
+    if (this.flushPromise) return this.flushPromise;
+    if (this.pendingCount === 0 && this.failedChunks.length === 0) return Promise.resolve();
+
+    this.flushPromise = this.writePending(final).finally(() => {
+      this.flushPromise = null;
+    });
+    return this.flushPromise;
+  }
+
+  /** Flushes until nothing is buffered, including rows stored during a running flush */
+  private async drainBuffer(): Promise<void> {
+    while (this.flushPromise || this.pendingCount > 0 || this.failedChunks.length > 0) {
+      await this.flushBuffer(true);
+    }
+  }
+
+  /**
+   * Writes the full chunks buffered, or everything when final. A partial
+   * chunk otherwise waits for more samples, so chunks stay large.
+   */
+  private async writePending(final: boolean): Promise<void> {
+    const count = final
+      ? this.pendingCount
+      : this.pendingCount - (this.pendingCount % this.CHUNK_SAMPLES);
+    const chunks = this.failedChunks;
+    this.failedChunks = [];
+
+    // Encoded before the first await, so samples stored meanwhile cannot shift under it
+    if (count > 0) {
+      const sessionId = this.pendingSessionId!;
+      const firstIndex = this.nextChunkIndex.get(sessionId) ?? 0;
+      const encoded = this.encodeChunks(
+        sessionId,
+        firstIndex,
+        this.pendingTimestamps,
+        this.pendingValues,
+        count,
       );
+      // Reps marked so far go into the index of the last chunk
+      encoded[encoded.length - 1].reps = this.pendingReps.get(sessionId) ?? [];
+      this.pendingReps.delete(sessionId);
+      this.nextChunkIndex.set(sessionId, firstIndex + encoded.length);
+      chunks.push(...encoded);
+
+      this.pendingTimestamps.copyWithin(0, count, this.pendingCount);
+      this.pendingValues.copyWithin(
+        0,
+        count * SAMPLE_CHANNELS,
+        this.pendingCount * SAMPLE_CHANNELS,
+      );
+      this.pendingCount -= count;
+    }
+    if (chunks.length === 0) return;
+
+    const started = Date.now();
+    try {
+      await this.db!.withTransactionAsync(() => this.insertChunks(chunks));
     } catch (error) {
-      console.error('Batch insert error:', error);
+      // Kept for the next flush, the transaction rolled back
+      this.failedChunks = chunks;
+      console.error('Chunk insert error:', error);
       throw error;
     }
+
+    const elapsed = Date.now() - started;
+    this.flushTimeMs += elapsed;
+    this.stats.writtenRows += chunks.reduce((sum, chunk) => sum + chunk.sampleCount, 0);
+    this.stats.lastFlushMs = elapsed;
+    this.stats.maxFlushMs = Math.max(this.stats.maxFlushMs, elapsed);
+    this.stats.rowsPerSecond =
+      this.flushTimeMs > 0 ? (this.stats.writtenRows * 1000) / this.flushTimeMs : 0;
+  }
+
+  private startFlushTimer(): void {
+    if (this.flushTimer) return;
+    this.flushTimer = setInterval(() => {
+      this.flushBuffer().catch(() => {
+        // Logged in writePending, the rows are retried on the next tick
+      });
+    }, this.FLUSH_INTERVAL);
+  }
+
+  private stopFlushTimer(): void {
+    if (this.flushTimer) {
+      clearInterval(this.flushTimer);
+      this.flushTimer = null;
+    }
   }
 
   async startSession(): Promise<string> {
@@ -142,32 +395,155 @@ class DatabaseService {
 
     try {
       // First flush any remaining measurements
-      if (this.measurementBuffer.data.length > 0) {
-        await this.flushBuffer();
-      }
+      this.stopFlushTimer();
+      await this.drainBuffer();
+      this.nextChunkIndex.delete(sessionId);
+      this.pendingReps.delete(sessionId);
 
       // Then update session end time
       const endTime = Date.now();
       await this.db!.runAsync(`UPDATE sessions SET endTime = ? WHERE id = ?`, [endTime, sessionId]);
+
+      // Metrics for the history view, computed once in the background
+      this.scheduleAnalytics(sessionId);
     } catch (error) {
       console.error('Error ending session:', error);
       throw error;
     }
   }
 
-  async storeMeasurement(measurement: IMeasurement): Promise<void> {
-    await this.ensureDbInitialized();
-    this.measurementBuffer.data.push(measurement);
+  /**
+   * Buffers samples [start, start + count) of a stream ring for the next
+   * periodic flush, copying the columns without creating objects. Resolves
+   * right away unless the buffer is above its high-water mark, then once a
+   * flush has written it down, so awaiting writers slow to the database's
+   * pace. Samples beyond a full buffer, or already overwritten in the ring,
+   * are dropped.
+   * @returns Samples stored
+   */
+  async storeSamples(
+    sessionId: string,
+    ring: SampleRing,
+    start: number,
+    count: number,
+  ): Promise<number> {
+    await this.beginPending(sessionId);
+
+    const first = Math.max(start, ring.oldest);
+    const stored = Math.max(
+      0,
+      Math.min(start + count - first, this.MAX_PENDING_ROWS - this.pendingCount),
+    );
+    this.stats.droppedRows += count - stored;
+    ring.copyTo(first, stored, this.pendingTimestamps, this.pendingValues, this.pendingCount);
+    this.pendingCount += stored;
+
+    await this.afterPending();
+    return stored;
+  }
 
-    const shouldWrite =
-      this.measurementBuffer.data.length >= this.BATCH_SIZE ||
-      Date.now() - this.measurementBuffer.lastWrite > this.WRITE_INTERVAL;
+  /**
+   * Buffers one measurement like storeSamples.
+   * Returns false if the buffer is full and the measurement was dropped.
+   */
+  async storeMeasurement(measurement: IMeasurement): Promise<boolean> {
+    await this.beginPending(measurement.sessionId);
+    if (this.pendingCount >= this.MAX_PENDING_ROWS) {
+      this.stats.droppedRows++;
+      return false;
+    }
+
+    const base = this.pendingCount * SAMPLE_CHANNELS;
+    this.pendingTimestamps[this.pendingCount] = measurement.timestamp;
+    this.pendingValues.set(
+      [
+        measurement.accX,
+        measurement.accY,
+        measurement.accZ,
+        measurement.gyrX,
+        measurement.gyrY,
+        measurement.gyrZ,
+      ],
+      base,
+    );
+    this.pendingCount++;
 
-    if (shouldWrite) {
+    await this.afterPending();
+    return true;
+  }
+
+  /** The buffer holds one session, an earlier one is written out first */
+  private async beginPending(sessionId: string): Promise<void> {
+    await this.ensureDbInitialized();
+    if (this.pendingSessionId !== sessionId) {
+      await this.drainBuffer();
+      this.pendingSessionId = sessionId;
+    }
+  }
+
+  private async afterPending(): Promise<void> {
+    this.startFlushTimer();
+    if (this.pendingCount >= this.HIGH_WATER_ROWS) {
       await this.flushBuffer();
     }
   }
 
+  /**
+   * Records a rep of the session being recorded; stored in the index of the
+   * next chunk written
+   */
+  markRep(sessionId: string, rep: RepBoundary): void {
+    const reps = this.pendingReps.get(sessionId) ?? [];
+    reps.push(rep);
+    this.pendingReps.set(sessionId, reps);
+  }
+
+  getIngestStats(): IngestStats {
+    const failedRows = this.failedChunks.reduce((sum, chunk) => sum + chunk.sampleCount, 0);
+    return { ...this.stats, pendingRows: this.pendingCount + failedRows };
+  }
+
+  /**
+   * Stores a complete session recorded on the device in one transaction.
+   * Returns false if a session with the same id was imported before.
+   */
+  async importSession(
+    sessionId: string,
+    startTime: number,
+    endTime: number,
+    measurements: Omit<IMeasurement, 'sessionId'>[],
+  ): Promise<boolean> {
+    await this.ensureDbInitialized();
+
+    try {
+      const existing = await this.getSessionMetaData(sessionId);
+      if (existing) return false;
+
+      await this.db!.withTransactionAsync(async () => {
+        await this.db!.runAsync(`INSERT INTO sessions (id, startTime, endTime) VALUES (?, ?, ?)`, [
+          sessionId,
+          startTime,
+          endTime,
+        ]);
+
+        const timestamps = new Float64Array(measurements.length);
+        const values = new Float32Array(measurements.length * SAMPLE_CHANNELS);
+        measurements.forEach((m, i) => {
+          timestamps[i] = m.timestamp;
+          values.set([m.accX, m.accY, m.accZ, m.gyrX, m.gyrY, m.gyrZ], i * SAMPLE_CHANNELS);
+        });
+        await this.insertChunks(
+          this.encodeChunks(sessionId, 0, timestamps, values, measurements.length),
+        );
+      });
+      this.scheduleAnalytics(sessionId);
+      return true;
+    } catch (error) {
+      console.error('Error importing session:', error);
+      throw error;
+    }
+  }
+
   async updateSession(sessionId: string, updates: SessionUpdate): Promise<void> {
     await this.ensureDbInitialized();
     try {
@@ -195,19 +571,334 @@ class DatabaseService {
     }
   }
 
-  async getSessionMeasurements(sessionId: string): Promise<IMeasurement[]> {
+  /**
+   * Chunk time ranges, sample counts and reps of a session, without reading
+   * any samples
+   */
+  async getSessionChunkIndex(sessionId: string): Promise<ChunkIndex[]> {
     await this.ensureDbInitialized();
     try {
-      return await this.db!.getAllAsync<IMeasurement>(
-        `SELECT * FROM measurements WHERE sessionId = ? ORDER BY timestamp ASC`,
+      const rows = await this.db!.getAllAsync<Omit<ChunkRow, 'data'>>(
+        `SELECT chunkIndex, startTime, endTime, sampleCount, repBoundaries
+             FROM sample_chunks WHERE sessionId = ? ORDER BY chunkIndex ASC`,
         [sessionId],
       );
+      return rows.map((row) => ({
+        chunkIndex: row.chunkIndex,
+        startTime: row.startTime,
+        endTime: row.endTime,
+        sampleCount: row.sampleCount,
+        reps: row.repBoundaries ? JSON.parse(row.repBoundaries) : [],
+      }));
+    } catch (error) {
+      console.error('Error getting chunk index:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Measurements of a session, optionally only those in [from, to] ms, which
+   * reads just the chunks overlapping that range. Sessions recorded before
+   * chunked storage are read from the measurements table.
+   */
+  async getSessionMeasurements(
+    sessionId: string,
+    from = -Infinity,
+    to = Infinity,
+  ): Promise<IMeasurement[]> {
+    await this.ensureDbInitialized();
+    try {
+      // SQLite has no infinite REAL literal to bind, so open ends stay out of the query
+      const range = [
+        ...(Number.isFinite(from) ? [{ clause: 'endTime >= ?', value: from }] : []),
+        ...(Number.isFinite(to) ? [{ clause: 'startTime <= ?', value: to }] : []),
+      ];
+      const chunks = await this.db!.getAllAsync<Pick<ChunkRow, 'data'>>(
+        `SELECT data FROM sample_chunks WHERE sessionId = ?
+             ${range.map((r) => `AND ${r.clause}`).join(' ')}
+             ORDER BY chunkIndex ASC`,
+        [sessionId, ...range.map((r) => r.value)],
+      );
+
+      if (chunks.length === 0) {
+        const chunked = await this.db!.getFirstAsync<{ count: number }>(
+          'SELECT COUNT(*) AS count FROM sample_chunks WHERE sessionId = ?',
+          [sessionId],
+        );
+        if (chunked && chunked.count > 0) {
+          return []; // Chunked session, nothing in the range
+        }
+        return await this.db!.getAllAsync<IMeasurement>(
+          `SELECT * FROM measurements WHERE sessionId = ? AND timestamp BETWEEN ? AND ?
+               ORDER BY timestamp ASC`,
+          [sessionId, Math.max(from, -Number.MAX_VALUE), Math.min(to, Number.MAX_VALUE)],
+        );
+      }
+
+      const measurements: IMeasurement[] = [];
+      for (const chunk of chunks) {
+        for (const sample of decodeSampleChunk(chunk.data)) {
+          if (sample.timestamp >= from && sample.timestamp <= to) {
+            measurements.push({ ...sample, sessionId });
+          }
+        }
+      }
+      return measurements;
     } catch (error) {
       console.error('Error getting measurements:', error);
       throw error;
     }
   }
 
+  /**
+   * Sessions with their cached metrics, newest first. Reads no samples, so it
+   * costs the same however much was recorded; sessions whose metrics are
+   * missing or stale come back with null analytics, see refreshStaleAnalytics.
+   */
+  async getSessionSummaries(): Promise<SessionSummary[]> {
+    await this.ensureDbInitialized();
+    try {
+      const rows = await this.db!.getAllAsync<SessionSummaryRow>(
+        `SELECT s.*, a.repCount, a.setCount, a.meanVelocity, a.peakVelocity,
+                a.meanRangeOfMotion, a.timeUnderTensionMs, a.maxVelocityLoss
+             FROM sessions s
+             LEFT JOIN session_analytics a ON a.sessionId = s.id
+                 AND a.algorithmVersion = ?
+             ORDER BY s.startTime DESC`,
+        [ANALYTICS_VERSION],
+      );
+      return rows.map((row) => ({
+        id: row.id,
+        startTime: row.startTime,
+        endTime: row.endTime,
+        exerciseType: row.exerciseType,
+        comments: row.comments,
+        analytics:
+          row.repCount === null
+            ? null
+            : {
+                repCount: row.repCount,
+                setCount: row.setCount!,
+                meanVelocity: row.meanVelocity!,
+                peakVelocity: row.peakVelocity!,
+                meanRangeOfMotion: row.meanRangeOfMotion!,
+                timeUnderTensionMs: row.timeUnderTensionMs!,
+                maxVelocityLoss: row.maxVelocityLoss!,
+              },
+      }));
+    } catch (error) {
+      console.error('Error getting session summaries:', error);
+      throw error;
+    }
+  }
+
+  /** Cached sets of a session in order; empty while its metrics are stale */
+  async getSetAnalytics(sessionId: string): Promise<SetAnalytics[]> {
+    await this.ensureDbInitialized();
+    try {
+      return await this.db!.getAllAsync<SetAnalytics>(
+        `SELECT t.startTime, t.endTime, t.repCount, t.bestMeanVelocity, t.lastMeanVelocity,
+                t.velocityLoss
+             FROM set_analytics t
+             JOIN session_analytics a ON a.sessionId = t.sessionId
+             WHERE t.sessionId = ? AND a.algorithmVersion = ?
+             ORDER BY t.setIndex ASC`,
+        [sessionId, ANALYTICS_VERSION],
+      );
+    } catch (error) {
+      console.error('Error getting set analytics:', error);
+      throw error;
+    }
+  }
+
+  /** Cached reps of a session in order; empty while its metrics are stale */
+  async getRepAnalytics(sessionId: string): Promise<RepAnalytics[]> {
+    await this.ensureDbInitialized();
+    try {
+      return await this.db!.getAllAsync<RepAnalytics>(
+        `SELECT r.setIndex, r.startTime, r.endTime, r.meanVelocity, r.peakVelocity,
+                r.rangeOfMotion, r.concentricMs, r.timeUnderTensionMs
+             FROM rep_analytics r
+             JOIN session_analytics a ON a.sessionId = r.sessionId
+             WHERE r.sessionId = ? AND a.algorithmVersion = ?
+             ORDER BY r.repIndex ASC`,
+        [sessionId, ANALYTICS_VERSION],
+      );
+    } catch (error) {
+      console.error('Error getting rep analytics:', error);
+      throw error;
+    }
+  }
+
+  /**
+   * Computes the metrics of every finished session without valid cached
+   * ones, e.g. sessions recorded before the cache existed, or all of them
+   * after an ANALYTICS_VERSION change. Calibration is not part of the key:
+   * samples are stored already corrected, so recalibrating cannot change
+   * the metrics of a past session.
+   * @returns Sessions computed
+   */
+  async refreshStaleAnalytics(): Promise<number> {
+    await this.ensureDbInitialized();
+    const stale = await this.db!.getAllAsync<{ id: string }>(
+      `SELECT s.id FROM sessions s
+           LEFT JOIN session_analytics a ON a.sessionId = s.id
+               AND a.algorithmVersion = ?
+           WHERE s.endTime IS NOT NULL AND a.sessionId IS NULL`,
+      [ANALYTICS_VERSION],
+    );
+    const computed = await Promise.all(stale.map(({ id }) => this.scheduleAnalytics(id)));
+    return computed.filter(Boolean).length;
+  }
+
+  /**
+   * Queues the analysis of a session behind any running one, so background
+   * work never competes with itself for the database.
+   * @returns Whether the metrics were computed and stored
+   */
+  private scheduleAnalytics(sessionId: string): Promise<boolean> {
+    const queued = this.analyticsJobs.get(sessionId);
+    if (queued) return queued;
+
+    const job = this.analyticsQueue.then(() => this.computeAnalytics(sessionId));
+    this.analyticsQueue = job.catch(() => undefined);
+    const result = job
+      .then(
+        () => true,
+        (error) => {
+          console.error('Error computing session analytics:', error);
+          return false;
+        },
+      )
+      .finally(() => this.analyticsJobs.delete(sessionId));
+    this.analyticsJobs.set(sessionId, result);
+    return result;
+  }
+
+  /**
+   * Runs a session through RepAnalyzer a chunk at a time, so memory stays
+   * bounded by one chunk plus the open motion segment, and replaces its
+   * cached metrics in one transaction
+   */
+  private async computeAnalytics(sessionId: string): Promise<void> {
+    await this.ensureDbInitialized();
+    const analyzer = new RepAnalyzer();
+
+    const chunks = await this.db!.getAllAsync<Pick<ChunkRow, 'chunkIndex'>>(
+      'SELECT chunkIndex FROM sample_chunks WHERE sessionId = ? ORDER BY chunkIndex ASC',
+      [sessionId],
+    );
+    if (chunks.length > 0) {
+      for (const { chunkIndex } of chunks) {
+        const chunk = await this.db!.getFirstAsync<Pick<ChunkRow, 'data'>>(
+          'SELECT data FROM sample_chunks WHERE sessionId = ? AND chunkIndex = ?',
+          [sessionId, chunkIndex],
+        );
+        if (chunk) {
+          decodeSampleChunk(chunk.data).forEach((sample) => analyzer.add(sample));
+        }
+      }
+    } else {
+      // Recorded before chunked storage, paged by the row order
+      for (let offset = 0; ; offset += this.CHUNK_SAMPLES) {
+        const rows = await this.db!.getAllAsync<IMeasurement>(
+          `SELECT * FROM measurements WHERE sessionId = ?
+               ORDER BY timestamp ASC LIMIT ? OFFSET ?`,
+          [sessionId, this.CHUNK_SAMPLES, offset],
+        );
+        rows.forEach((row) => analyzer.add(row));
+        if (rows.length < this.CHUNK_SAMPLES) break;
+      }
+    }
+
+    await this.storeAnalytics(sessionId, analyzer.finish());
+  }
+
+  private async storeAnalytics(
+    sessionId: string,
+    { summary, sets, reps }: AnalyticsResult,
+  ): Promise<void> {
+    await this.db!.withTransactionAsync(async () => {
+      // The session may have been deleted while it was analyzed
+      const session = await this.db!.getFirstAsync<{ id: string }>(
+        'SELECT id FROM sessions WHERE id = ?',
+        [sessionId],
+      );
+      await this.deleteAnalytics(sessionId);
+      if (!session) return;
+
+      await this.db!.runAsync(
+        `INSERT INTO session_analytics
+             (sessionId, algorithmVersion, computedAt, repCount, setCount, meanVelocity,
+              peakVelocity, meanRangeOfMotion, timeUnderTensionMs, maxVelocityLoss)
+             VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)`,
+        [
+          sessionId,
+          ANALYTICS_VERSION,
+          Date.now(),
+          summary.repCount,
+          summary.setCount,
+          summary.meanVelocity,
+          summary.peakVelocity,
+          summary.meanRangeOfMotion,
+          summary.timeUnderTensionMs,
+          summary.maxVelocityLoss,
+        ],
+      );
+
+      const setStatement = await this.db!.prepareAsync(
+        `INSERT INTO set_analytics
+             (sessionId, setIndex, startTime, endTime, repCount, bestMeanVelocity,
+              lastMeanVelocity, velocityLoss)
+             VALUES (?, ?, ?, ?, ?, ?, ?, ?)`,
+      );
+      const repStatement = await this.db!.prepareAsync(
+        `INSERT INTO rep_analytics
+             (sessionId, repIndex, setIndex, startTime, endTime, meanVelocity, peakVelocity,
+              rangeOfMotion, concentricMs, timeUnderTensionMs)
+             VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?)`,
+      );
+      try {
+        for (const [index, set] of sets.entries()) {
+          await setStatement.executeAsync([
+            sessionId,
+            index,
+            set.startTime,
+            set.endTime,
+            set.repCount,
+            set.bestMeanVelocity,
+            set.lastMeanVelocity,
+            set.velocityLoss,
+          ]);
+        }
+        for (const [index, rep] of reps.entries()) {
+          await repStatement.executeAsync([
+            sessionId,
+            index,
+            rep.setIndex,
+            rep.startTime,
+            rep.endTime,
+            rep.meanVelocity,
+            rep.peakVelocity,
+            rep.rangeOfMotion,
+            rep.concentricMs,
+            rep.timeUnderTensionMs,
+          ]);
+        }
+      } finally {
+        await setStatement.finalizeAsync();
+        await repStatement.finalizeAsync();
+      }
+    });
+  }
+
+  /** Deletes the cached metrics of a session; the caller owns the transaction */
+  private async deleteAnalytics(sessionId: string): Promise<void> {
+    await this.db!.runAsync('DELETE FROM rep_analytics WHERE sessionId = ?', [sessionId]);
+    await this.db!.runAsync('DELETE FROM set_analytics WHERE sessionId = ?', [sessionId]);
+    await this.db!.runAsync('DELETE FROM session_analytics WHERE sessionId = ?', [sessionId]);
+  }
+
   async getSessions(): Promise<ISession[]> {
     await this.ensureDbInitialized();
     try {
@@ -222,6 +913,8 @@ class DatabaseService {
     await this.ensureDbInitialized();
     try {
       await this.db!.withTransactionAsync(async () => {
+        await this.deleteAnalytics(sessionId);
+        await this.db!.runAsync('DELETE FROM sample_chunks WHERE sessionId = ?', [sessionId]);
         await this.db!.runAsync('DELETE FROM measurements WHERE sessionId = ?', [sessionId]);
         await this.db!.runAsync('DELETE FROM sessions WHERE id = ?', [sessionId]);
       });
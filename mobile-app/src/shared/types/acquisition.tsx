@@ -0,0 +1,26 @@
+/**
+ * Acquisition profiles, mirrors embedded/src/sensor/acquisitionProfile.h
+ */
+export enum AcquisitionProfile {
+  IDLE = 0,
+  STRENGTH = 1,
+  OLYMPIC = 2,
+  OLYMPIC_MAX = 3,
+}
+
+export const DEFAULT_ACQUISITION_PROFILE = AcquisitionProfile.STRENGTH;
+
+export const ACQUISITION_PROFILES: {
+  profile: AcquisitionProfile;
+  label: string;
+  description: string;
+}[] = [
+  { profile: AcquisitionProfile.IDLE, label: 'Idle', description: '25 Hz, low power' },
+  { profile: AcquisitionProfile.STRENGTH, label: 'Strength', description: '100 Hz, ±8 g' },
+  { profile: AcquisitionProfile.OLYMPIC, label: 'Olympic', description: '500 Hz, ±16 g' },
+  {
+    profile: AcquisitionProfile.OLYMPIC_MAX,
+    label: '1 kHz',
+    description: '1 kHz, ±16 g, ±2000 °/s',
+  },
+];
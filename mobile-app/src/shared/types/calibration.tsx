@@ -8,6 +8,9 @@ export enum DeviceCalibrationState {
   QUICK_STATIC_SIDE = 4,
   QUICK_COMPLETE = 5,
   FAILED = 6,
+  SIX_WAITING_POSITION = 7,
+  SIX_STATIC = 8,
+  SIX_COMPLETE = 9,
 }
 
 export interface CalibrationState {
@@ -0,0 +1,22 @@
+/**
+ * Unit roles, mirrors embedded/src/ble/unitIdentity.h
+ */
+export enum UnitRole {
+  SOLO = 0,
+  BAR_LEFT = 1,
+  BAR_RIGHT = 2,
+  ATHLETE = 3,
+}
+
+export const UNIT_ROLES: { role: UnitRole; label: string }[] = [
+  { role: UnitRole.SOLO, label: 'Single unit' },
+  { role: UnitRole.BAR_LEFT, label: 'Bar, left end' },
+  { role: UnitRole.BAR_RIGHT, label: 'Bar, right end' },
+  { role: UnitRole.ATHLETE, label: 'Athlete' },
+];
+
+/** Splits the unit byte of a stream frame */
+export const parseUnitTag = (tag: number): { role: UnitRole; idBits: number } => ({
+  role: (tag >> 6) as UnitRole,
+  idBits: tag & 0x3f,
+});
@@ -0,0 +1,84 @@
+/**
+ * Base64 decoding straight into bytes.
+ *
+ * react-native-ble-plx hands characteristic values over as base64 strings.
+ * atob plus a charCodeAt loop builds an intermediate binary string and a new
+ * array per notification; this decodes through a lookup table into a
+ * caller-owned buffer, so high-rate handlers allocate nothing per packet.
+ */
+const INVALID = 0xff;
+const ALPHABET = 'ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/';
+
+const LOOKUP = (() => {
+  const table = new Uint8Array(128).fill(INVALID);
+  for (let i = 0; i < ALPHABET.length; i++) {
+    table[ALPHABET.charCodeAt(i)] = i;
+  }
+  // URL-safe variants, for completeness
+  table['-'.charCodeAt(0)] = 62;
+  table['_'.charCodeAt(0)] = 63;
+  return table;
+})();
+
+const sextet = (base64: string, index: number): number => {
+  const code = base64.charCodeAt(index);
+  return code < 128 ? LOOKUP[code] : INVALID;
+};
+
+/** Bytes a base64 string decodes to, ignoring padding */
+export const base64DecodedLength = (base64: string): number => {
+  let length = base64.length;
+  while (length > 0 && base64.charCodeAt(length - 1) === 61) {
+    length--; // '='
+  }
+  return Math.floor((length * 3) / 4);
+};
+
+/**
+ * Decodes into target from offset 0.
+ * @returns Bytes written, or -1 if target is too small or the input is not base64
+ */
+export const decodeBase64Into = (base64: string, target: Uint8Array): number => {
+  const length = base64DecodedLength(base64);
+  if (length > target.length) {
+    return -1;
+  }
+
+  // Whole groups of four characters to three bytes, then the padded tail
+  let out = 0;
+  let i = 0;
+  const whole = length - (length % 3);
+  while (out < whole) {
+    const a = sextet(base64, i);
+    const b = sextet(base64, i + 1);
+    const c = sextet(base64, i + 2);
+    const d = sextet(base64, i + 3);
+    if ((a | b | c | d) === INVALID) {
+      return -1;
+    }
+    target[out++] = (a << 2) | (b >> 4);
+    target[out++] = ((b & 0x0f) << 4) | (c >> 2);
+    target[out++] = ((c & 0x03) << 6) | d;
+    i += 4;
+  }
+
+  if (out < length) {
+    const a = sextet(base64, i);
+    const b = sextet(base64, i + 1);
+    const c = length - out === 2 ? sextet(base64, i + 2) : 0;
+    if ((a | b | c) === INVALID) {
+      return -1;
+    }
+    target[out++] = (a << 2) | (b >> 4);
+    if (out < length) {
+      target[out++] = ((b & 0x0f) << 4) | (c >> 2);
+    }
+  }
+  return out;
+};
+
+/** Decodes into a new array; for low-rate characteristics */
+export const decodeBase64 = (base64: string): Uint8Array => {
+  const bytes = new Uint8Array(base64DecodedLength(base64));
+  return decodeBase64Into(base64, bytes) < 0 ? new Uint8Array(0) : bytes;
+};
@@ -0,0 +1,236 @@
+import type { SensorData } from '../services/ble_context';
+
+/**
+ * Helpers for the recording characteristic.
+ *
+ * Mirrors embedded/src/storage/recordingProtocol.h. The device records
+ * sessions to its own memory; the app lists them and downloads one session at
+ * a time. DATA frames arrive in windows and are acknowledged cumulatively
+ * with ACK(nextSample). A frame that does not start at the next expected
+ * sample means one was lost: the app repeats its last ACK once, which makes
+ * the device resend from there, and drops frames until the gap is filled.
+ */
+export enum RecordCommand {
+  START = 1,
+  STOP = 2,
+  LIST = 3,
+  DOWNLOAD = 4,
+  ACK = 5,
+  ERASE_ALL = 6,
+  STATUS = 7,
+}
+
+export enum RecordMessageType {
+  STATUS = 0x81,
+  SESSION_INFO = 0x82,
+  LIST_END = 0x83,
+  DATA = 0x84,
+  DOWNLOAD_END = 0x85,
+  ERROR = 0x8f,
+}
+
+export enum RecordError {
+  UNKNOWN_COMMAND = 1,
+  UNKNOWN_SESSION = 2,
+  NO_STORAGE = 3,
+  STORAGE_FULL = 4,
+  BUSY = 5,
+  MTU_TOO_SMALL = 6,
+}
+
+export interface DeviceRecordingStatus {
+  recording: boolean;
+  activeSessionId: number;
+  sessionCount: number;
+  usedBytes: number;
+  capacityBytes: number;
+}
+
+export interface DeviceSessionInfo {
+  sessionId: number;
+  sampleCount: number;
+  startTime: number; // Wall-clock ms, derived from the age reported by the device
+  samplePeriodUs: number;
+  accelLsbPerG: number;
+  gyroLsbPerDps: number;
+  calibrated: boolean;
+  complete: boolean;
+  filledSamples: number;
+}
+
+export type RecordMessage =
+  | { type: RecordMessageType.STATUS; status: DeviceRecordingStatus }
+  | { type: RecordMessageType.SESSION_INFO; info: DeviceSessionInfo }
+  | { type: RecordMessageType.LIST_END }
+  | { type: RecordMessageType.DATA; sessionId: number; firstSample: number; payload: DataView }
+  | { type: RecordMessageType.DOWNLOAD_END; sessionId: number; sampleCount: number }
+  | { type: RecordMessageType.ERROR; error: number };
+
+const STATUS_SIZE = 13;
+const SESSION_INFO_SIZE = 27;
+const DATA_HEADER_SIZE = 8;
+const DOWNLOAD_END_SIZE = 7;
+const ERROR_SIZE = 2;
+const SAMPLE_SIZE = 12;
+
+/** Encodes a command, with session and sample for DOWNLOAD and ACK */
+export const encodeRecordCommand = (
+  command: RecordCommand,
+  sessionId = 0,
+  sample = 0,
+): Uint8Array => {
+  if (command !== RecordCommand.DOWNLOAD && command !== RecordCommand.ACK) {
+    return new Uint8Array([command]);
+  }
+
+  const bytes = new Uint8Array(7);
+  const view = new DataView(bytes.buffer);
+  view.setUint8(0, command);
+  view.setUint16(1, sessionId, true);
+  view.setUint32(3, sample, true);
+  return bytes;
+};
+
+/** Parses one notification, returns null for malformed messages */
+export const parseRecordMessage = (
+  bytes: Uint8Array,
+  receivedAt = Date.now(),
+): RecordMessage | null => {
+  if (bytes.length < 1) {
+    return null;
+  }
+
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  switch (view.getUint8(0)) {
+    case RecordMessageType.STATUS:
+      if (bytes.length < STATUS_SIZE) return null;
+      return {
+        type: RecordMessageType.STATUS,
+        status: {
+          recording: view.getUint8(1) !== 0,
+          activeSessionId: view.getUint16(2, true),
+          sessionCount: view.getUint8(4),
+          usedBytes: view.getUint32(5, true),
+          capacityBytes: view.getUint32(9, true),
+        },
+      };
+    case RecordMessageType.SESSION_INFO:
+      if (bytes.length < SESSION_INFO_SIZE) return null;
+      return {
+        type: RecordMessageType.SESSION_INFO,
+        info: {
+          sessionId: view.getUint16(1, true),
+          sampleCount: view.getUint32(3, true),
+          startTime: receivedAt - view.getUint32(7, true),
+          samplePeriodUs: view.getUint16(11, true),
+          accelLsbPerG: view.getFloat32(13, true),
+          gyroLsbPerDps: view.getFloat32(17, true),
+          calibrated: view.getUint8(21) !== 0,
+          complete: view.getUint8(22) !== 0,
+          filledSamples: view.getUint32(23, true),
+        },
+      };
+    case RecordMessageType.LIST_END:
+      return { type: RecordMessageType.LIST_END };
+    case RecordMessageType.DATA: {
+      if (bytes.length < DATA_HEADER_SIZE) return null;
+      const sampleCount = view.getUint8(7);
+      if (bytes.length < DATA_HEADER_SIZE + sampleCount * SAMPLE_SIZE) return null;
+      return {
+        type: RecordMessageType.DATA,
+        sessionId: view.getUint16(1, true),
+        firstSample: view.getUint32(3, true),
+        payload: new DataView(
+          bytes.buffer,
+          bytes.byteOffset + DATA_HEADER_SIZE,
+          sampleCount * SAMPLE_SIZE,
+        ),
+      };
+    }
+    case RecordMessageType.DOWNLOAD_END:
+      if (bytes.length < DOWNLOAD_END_SIZE) return null;
+      return {
+        type: RecordMessageType.DOWNLOAD_END,
+        sessionId: view.getUint16(1, true),
+        sampleCount: view.getUint32(3, true),
+      };
+    case RecordMessageType.ERROR:
+      if (bytes.length < ERROR_SIZE) return null;
+      return { type: RecordMessageType.ERROR, error: view.getUint8(1) };
+    default:
+      return null;
+  }
+};
+
+/**
+ * Reassembles one session from DATA frames into a preallocated int16 buffer.
+ */
+export class SessionDownload {
+  readonly info: DeviceSessionInfo;
+  private readonly raw: Int16Array;
+  private nextSample = 0;
+  private gapReported = false;
+
+  constructor(info: DeviceSessionInfo) {
+    this.info = info;
+    this.raw = new Int16Array(info.sampleCount * 6);
+  }
+
+  get receivedSamples(): number {
+    return this.nextSample;
+  }
+
+  get isComplete(): boolean {
+    return this.nextSample >= this.info.sampleCount;
+  }
+
+  /**
+   * Stores an in-order frame and returns the sample to acknowledge, or null
+   * when nothing should be sent (duplicate or already reported gap).
+   */
+  handleData(firstSample: number, payload: DataView): number | null {
+    if (firstSample !== this.nextSample) {
+      if (firstSample < this.nextSample || this.gapReported) {
+        return null;
+      }
+      // Lost frame: repeat the last acknowledgement once to trigger a resend
+      this.gapReported = true;
+      return this.nextSample;
+    }
+
+    const samples = Math.min(
+      payload.byteLength / SAMPLE_SIZE,
+      this.info.sampleCount - this.nextSample,
+    );
+    let offset = this.nextSample * 6;
+    for (let i = 0; i < samples * 6; i++) {
+      this.raw[offset++] = payload.getInt16(i * 2, true);
+    }
+
+    this.nextSample += samples;
+    this.gapReported = false;
+    return this.nextSample;
+  }
+
+  /** Converts to physical units with wall-clock millisecond timestamps */
+  toSensorData(): SensorData[] {
+    const accelRes = 1 / this.info.accelLsbPerG;
+    const gyroRes = 1 / this.info.gyroLsbPerDps;
+    const periodMs = this.info.samplePeriodUs / 1000;
+    const data: SensorData[] = new Array(this.nextSample);
+
+    for (let i = 0; i < this.nextSample; i++) {
+      const o = i * 6;
+      data[i] = {
+        accX: this.raw[o] * accelRes,
+        accY: this.raw[o + 1] * accelRes,
+        accZ: this.raw[o + 2] * accelRes,
+        gyrX: this.raw[o + 3] * gyroRes,
+        gyrY: this.raw[o + 4] * gyroRes,
+        gyrZ: this.raw[o + 5] * gyroRes,
+        timestamp: Math.round(this.info.startTime + i * periodMs),
+      };
+    }
+    return data;
+  }
+}
@@ -0,0 +1,47 @@
+/**
+ * Decoder for the CalibrationInfo value of the calibration characteristic.
+ *
+ * Mirrors embedded/src/calibration/setupCalibration.h. The device sets the
+ * value after a READ_INFO command; it is told apart from the two-byte
+ * progress value by its length.
+ */
+export enum CalibrationMethod {
+  NONE = 0,
+  QUICK = 1,
+  SIX_POSITION = 2,
+}
+
+export interface CalibrationInfo {
+  valid: boolean;
+  stored: boolean; // Persisted on the device, survives a power cycle
+  method: CalibrationMethod;
+  temperature: number; // °C during calibration
+  accelMatrix: number[]; // Row-major 3x3
+  accelOffset: [number, number, number];
+  gyroBias: [number, number, number];
+}
+
+const CALIBRATION_INFO_SIZE = 67;
+
+/** Parses the value, returns null for anything else (e.g. a progress value) */
+export const parseCalibrationInfo = (bytes: Uint8Array): CalibrationInfo | null => {
+  if (bytes.length < CALIBRATION_INFO_SIZE) {
+    return null;
+  }
+
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  const floats = (offset: number, count: number) =>
+    Array.from({ length: count }, (_, i) => view.getFloat32(offset + i * 4, true));
+  const [ox, oy, oz] = floats(43, 3);
+  const [gx, gy, gz] = floats(55, 3);
+
+  return {
+    valid: view.getUint8(0) !== 0,
+    stored: view.getUint8(1) !== 0,
+    method: view.getUint8(2),
+    temperature: view.getFloat32(3, true),
+    accelMatrix: floats(7, 9),
+    accelOffset: [ox, oy, oz],
+    gyroBias: [gx, gy, gz],
+  };
+};
@@ -0,0 +1,101 @@
+/**
+ * Fixed-size min/max history of a signal for live charts.
+ *
+ * The visible window is split into one bucket per drawn column and every
+ * sample only widens the range of its bucket, so a chart costs the same to
+ * draw at 50 Hz and at 1 kHz and a one-sample peak still shows as a spike.
+ * Columns live in a ring of typed arrays; buckets no sample fell into hold
+ * NaN so gaps in the stream show as gaps.
+ */
+const DEFAULT_COLUMNS = 240;
+const DEFAULT_WINDOW_MS = 5000;
+
+export class EnvelopeBuffer {
+  readonly columns: number;
+  readonly windowMs: number;
+  readonly bucketMs: number;
+  readonly min: Float32Array;
+  readonly max: Float32Array;
+  // Bumped on every change, so a renderer can skip frames with nothing new
+  version = 0;
+  private head = -1; // Column of the newest bucket
+  private filled = 0;
+  private bucketEnd = 0; // ms, exclusive
+
+  constructor(columns = DEFAULT_COLUMNS, windowMs = DEFAULT_WINDOW_MS) {
+    this.columns = columns;
+    this.windowMs = windowMs;
+    this.bucketMs = windowMs / columns;
+    this.min = new Float32Array(columns);
+    this.max = new Float32Array(columns);
+  }
+
+  /** Columns holding data or gaps, at most columns */
+  get length(): number {
+    return this.filled;
+  }
+
+  push(timestamp: number, value: number): void {
+    if (this.filled === 0 || timestamp < this.bucketEnd - 2 * this.bucketMs) {
+      // First sample, or the clock jumped back, e.g. when time sync kicks in
+      this.reset();
+      this.advance(1);
+      this.bucketEnd = timestamp + this.bucketMs;
+    } else if (timestamp >= this.bucketEnd) {
+      const steps = Math.floor((timestamp - this.bucketEnd) / this.bucketMs) + 1;
+      this.advance(Math.min(steps, this.columns));
+      this.bucketEnd += steps * this.bucketMs;
+    }
+
+    const head = this.head;
+    // NaN compares false, so an empty bucket takes the first value as is
+    if (!(value >= this.min[head])) {
+      this.min[head] = value;
+    }
+    if (!(value <= this.max[head])) {
+      this.max[head] = value;
+    }
+    this.version++;
+  }
+
+  reset(): void {
+    this.head = -1;
+    this.filled = 0;
+    this.bucketEnd = 0;
+    this.version++;
+  }
+
+  /** Visits columns oldest first; gaps have NaN bounds */
+  forEachColumn(visit: (index: number, min: number, max: number) => void): void {
+    const first = this.head - this.filled + 1 + this.columns;
+    for (let i = 0; i < this.filled; i++) {
+      const column = (first + i) % this.columns;
+      visit(i, this.min[column], this.max[column]);
+    }
+  }
+
+  /** Smallest and largest value in the history, or null if it is empty */
+  range(): { min: number; max: number } | null {
+    let min = Infinity;
+    let max = -Infinity;
+    this.forEachColumn((_, low, high) => {
+      // NaN gaps fail both comparisons
+      if (low < min) {
+        min = low;
+      }
+      if (high > max) {
+        max = high;
+      }
+    });
+    return min <= max ? { min, max } : null;
+  }
+
+  private advance(steps: number): void {
+    for (let i = 0; i < steps; i++) {
+      this.head = (this.head + 1) % this.columns;
+      this.min[this.head] = NaN;
+      this.max[this.head] = NaN;
+    }
+    this.filled = Math.min(this.filled + steps, this.columns);
+  }
+}
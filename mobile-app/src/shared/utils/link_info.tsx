@@ -0,0 +1,33 @@
+/**
+ * Decoder for the link characteristic.
+ *
+ * Mirrors embedded/src/ble/linkProtocol.h. The device notifies the
+ * connection parameters it actually runs with whenever one of them changes.
+ */
+export interface LinkInfo {
+  mtu: number; // ATT MTU
+  connIntervalMs: number;
+  latency: number; // Connection events the device may skip
+  supervisionTimeoutMs: number;
+  txDataLength: number; // LL payload bytes, 27 without data length extension
+  phy: number; // 1 = LE 1M, 2 = LE 2M
+}
+
+const LINK_INFO_SIZE = 11;
+
+/** Parses one notification, returns null for malformed packets */
+export const parseLinkInfo = (bytes: Uint8Array): LinkInfo | null => {
+  if (bytes.length < LINK_INFO_SIZE) {
+    return null;
+  }
+
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  return {
+    mtu: view.getUint16(0, true),
+    connIntervalMs: view.getUint16(2, true) * 1.25,
+    latency: view.getUint16(4, true),
+    supervisionTimeoutMs: view.getUint16(6, true) * 10,
+    txDataLength: view.getUint16(8, true),
+    phy: view.getUint8(10),
+  };
+};
@@ -49,3 +49,20 @@ export class OrientationFilter {
     return { ...this.orientation };
   }
 }
+
+/**
+ * Converts a sensor-to-world quaternion to roll, pitch and yaw in radians
+ */
+export const quaternionToEuler = (q: {
+  w: number;
+  x: number;
+  y: number;
+  z: number;
+}): { x: number; y: number; z: number } => {
+  const sinPitch = Math.max(-1, Math.min(1, 2 * (q.w * q.y - q.z * q.x)));
+  return {
+    x: Math.atan2(2 * (q.w * q.x + q.y * q.z), 1 - 2 * (q.x * q.x + q.y * q.y)),
+    y: Math.asin(sinPitch),
+    z: Math.atan2(2 * (q.w * q.z + q.x * q.y), 1 - 2 * (q.y * q.y + q.z * q.z)),
+  };
+};
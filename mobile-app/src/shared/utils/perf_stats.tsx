@@ -0,0 +1,90 @@
+/**
+ * Decoder for the perf characteristic.
+ *
+ * Mirrors embedded/src/perf/perfProtocol.h. The device builds the snapshot
+ * when the characteristic is read; writing any value resets the timers.
+ */
+export interface PerfTimer {
+  count: number;
+  meanUs: number;
+  minUs: number;
+  maxUs: number;
+  histogram: number[]; // Bucket i counts durations below 16 * 4^i µs
+}
+
+export interface PerfStats {
+  version: number;
+  uptimeMs: number;
+  fifoDropped: number; // Samples lost to IMU FIFO overflows
+  fifoOverflows: number;
+  ringOverflows: number; // Samples the comms task did not consume in time
+  ringHighWater: number;
+  ringCapacity: number;
+  freeHeap: number;
+  minFreeHeap: number;
+  freePsram: number;
+  imuRead: PerfTimer;
+  correction: PerfTimer;
+  fusion: PerfTimer;
+  notify: PerfTimer;
+  sensorPeriod: PerfTimer;
+  commsPeriod: PerfTimer;
+  // Absent in older firmware
+  integration?: PerfTimer;
+  repDetection?: PerfTimer;
+}
+
+const PERF_HEADER_SIZE = 34;
+const PERF_TIMER_SIZE = 32;
+const PERF_HISTOGRAM_BUCKETS = 8;
+const PERF_TIMER_COUNT = 6;
+
+const parseTimer = (view: DataView, offset: number): PerfTimer => {
+  const histogram: number[] = [];
+  for (let i = 0; i < PERF_HISTOGRAM_BUCKETS; i++) {
+    histogram.push(view.getUint16(offset + 16 + i * 2, true));
+  }
+  return {
+    count: view.getUint32(offset, true),
+    meanUs: view.getUint32(offset + 4, true),
+    minUs: view.getUint32(offset + 8, true),
+    maxUs: view.getUint32(offset + 12, true),
+    histogram,
+  };
+};
+
+/** Parses one read, returns null for malformed or truncated packets */
+export const parsePerfStats = (bytes: Uint8Array): PerfStats | null => {
+  if (bytes.length < PERF_HEADER_SIZE) {
+    return null;
+  }
+
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  const timerCount = view.getUint8(1);
+  const size = PERF_HEADER_SIZE + timerCount * PERF_TIMER_SIZE;
+  if (timerCount < PERF_TIMER_COUNT || bytes.length < size) {
+    return null;
+  }
+
+  const timer = (i: number) => parseTimer(view, PERF_HEADER_SIZE + i * PERF_TIMER_SIZE);
+  return {
+    version: view.getUint8(0),
+    uptimeMs: view.getUint32(2, true),
+    fifoDropped: view.getUint32(6, true),
+    fifoOverflows: view.getUint32(10, true),
+    ringOverflows: view.getUint32(14, true),
+    ringHighWater: view.getUint16(18, true),
+    ringCapacity: view.getUint16(20, true),
+    freeHeap: view.getUint32(22, true),
+    minFreeHeap: view.getUint32(26, true),
+    freePsram: view.getUint32(30, true),
+    imuRead: timer(0),
+    correction: timer(1),
+    fusion: timer(2),
+    notify: timer(3),
+    sensorPeriod: timer(4),
+    commsPeriod: timer(5),
+    integration: timerCount > 6 ? timer(6) : undefined,
+    repDetection: timerCount > 7 ? timer(7) : undefined,
+  };
+};
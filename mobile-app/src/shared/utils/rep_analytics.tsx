@@ -0,0 +1,351 @@
+import type { ChunkSample } from './sample_chunk';
+
+/**
+ * Rep and set metrics derived from recorded samples, for the history view.
+ *
+ * Follows the device pipeline (embedded/src/integration/velocityIntegrator.h,
+ * analysis/repDetector.h and analysis/setTracker.h) over stored samples:
+ * vertical acceleration is integrated into velocity between zero-velocity
+ * updates, the drift left at each update is removed linearly from its motion
+ * segment, and segments are split into eccentric and concentric phases.
+ * Stored samples carry no orientation, so gravity is tracked in the sensor
+ * frame by rotating it with the gyro and pulling it towards the
+ * accelerometer whenever the sensor is close to still. Fusion recordings already
+ * hold world-frame linear acceleration with zero rotation rates and use
+ * their z axis as is.
+ *
+ * Bump ANALYTICS_VERSION with any change that alters results; metrics cached
+ * by an older version are recomputed.
+ */
+export const ANALYTICS_VERSION = 1;
+
+const GRAVITY = 9.80665; // m/s² per g
+// Same thresholds as embedded/src/config/config.h
+const STILL_GYRO = 5.1; // °/s, Calibration::STILLNESS_THRESHOLD
+const STILL_ACCEL = 0.05; // g of linear acceleration considered still
+const STILL_DURATION = 150; // ms of stillness for a zero-velocity update
+const MIN_VELOCITY = 0.05; // m/s peak for a phase to count as motion
+const MIN_RANGE = 0.1; // m of concentric travel to count a rep
+const MAX_PHASE_DURATION = 8000; // ms before a phase is discarded as drift
+const SET_REST_TIMEOUT = 30000; // ms without reps before a new set starts
+// Phone-side additions
+const MAX_GAP = 100; // ms between samples before the open segment is dropped as broken
+const MAX_SEGMENT_SAMPLES = 60000; // A minute at 1 kHz, the tail of longer motion is ignored
+const GRAVITY_TIME_CONSTANT = 0.1; // s for the gravity estimate to settle on a still accelerometer
+const FUSED_MAX_ACCEL = 0.5; // g; raw samples read about 1 g, fused ones far less
+const DEG_TO_RAD = Math.PI / 180;
+
+export interface RepAnalytics {
+  setIndex: number;
+  startTime: number; // ms, start of the eccentric phase before the rep, if any
+  endTime: number; // ms, top of the rep
+  meanVelocity: number; // m/s, mean concentric velocity
+  peakVelocity: number; // m/s
+  rangeOfMotion: number; // m
+  concentricMs: number;
+  timeUnderTensionMs: number;
+}
+
+export interface SetAnalytics {
+  startTime: number;
+  endTime: number;
+  repCount: number;
+  bestMeanVelocity: number; // m/s
+  lastMeanVelocity: number; // m/s
+  velocityLoss: number; // Percent of the fastest rep lost by the last one
+}
+
+export interface SessionAnalytics {
+  repCount: number;
+  setCount: number;
+  meanVelocity: number; // m/s, over all reps
+  peakVelocity: number; // m/s
+  meanRangeOfMotion: number; // m
+  timeUnderTensionMs: number; // Sum over all reps
+  maxVelocityLoss: number; // Percent, worst set
+}
+
+export interface AnalyticsResult {
+  summary: SessionAnalytics;
+  sets: SetAnalytics[];
+  reps: RepAnalytics[];
+}
+
+/**
+ * Feed samples in time order with add(), then read the result with finish()
+ */
+export class RepAnalyzer {
+  private gravity = { x: 0, y: 0, z: 1 }; // Unit vector, sensor frame
+  private lastTimestamp: number | null = null;
+  private velocity = 0;
+  private inMotion = false;
+  private quiet = false;
+  private quietSince = 0;
+  // Open motion segment, one entry per sample
+  private segmentTimes: number[] = [];
+  private segmentSteps: number[] = []; // s since the previous sample
+  private segmentVelocity: number[] = [];
+  private reps: RepAnalytics[] = [];
+  private sets: SetAnalytics[] = [];
+
+  add(sample: ChunkSample): void {
+    const { accX, accY, accZ, gyrX, gyrY, gyrZ, timestamp } = sample;
+    const accel = Math.sqrt(accX * accX + accY * accY + accZ * accZ);
+
+    if (this.lastTimestamp === null) {
+      if (accel > 0) {
+        this.gravity = { x: accX / accel, y: accY / accel, z: accZ / accel };
+      }
+      this.lastTimestamp = timestamp;
+      return;
+    }
+
+    const stepMs = timestamp - this.lastTimestamp;
+    this.lastTimestamp = timestamp;
+    if (stepMs <= 0 || stepMs > MAX_GAP) {
+      // Lost samples would integrate into a wrong velocity
+      this.discardSegment();
+      return;
+    }
+    const dt = stepMs / 1000;
+
+    let vertical: number; // g, gravity-free, up
+    let linear: number; // g, magnitude of the gravity-free acceleration
+    let rotation = 0; // °/s
+    if (gyrX === 0 && gyrY === 0 && gyrZ === 0 && accel < FUSED_MAX_ACCEL) {
+      vertical = accZ;
+      linear = accel;
+    } else {
+      const g = this.trackGravity(accX, accY, accZ, accel, gyrX, gyrY, gyrZ, dt);
+      const along = accX * g.x + accY * g.y + accZ * g.z;
+      vertical = along - 1;
+      linear = Math.sqrt(Math.max(0, accel * accel - 2 * along + 1));
+      rotation = Math.sqrt(gyrX * gyrX + gyrY * gyrY + gyrZ * gyrZ);
+    }
+
+    if (this.detectStill(timestamp, rotation, linear)) {
+      if (this.inMotion) {
+        this.closeSegment();
+      }
+      this.velocity = 0;
+      return;
+    }
+
+    if (!this.inMotion) {
+      // Quiet samples right after a zero-velocity update do not open a segment
+      if (this.quiet) {
+        return;
+      }
+      this.inMotion = true;
+      this.velocity = 0;
+    }
+
+    this.velocity += vertical * GRAVITY * dt;
+    if (this.segmentTimes.length < MAX_SEGMENT_SAMPLES) {
+      this.segmentTimes.push(timestamp);
+      this.segmentSteps.push(dt);
+      this.segmentVelocity.push(this.velocity);
+    }
+  }
+
+  /**
+   * Motion still open at the end of the recording has no zero-velocity
+   * update to correct its drift and is left out, as on the device
+   */
+  finish(): AnalyticsResult {
+    this.discardSegment();
+
+    const reps = this.reps;
+    const count = reps.length;
+    const sum = (value: (rep: RepAnalytics) => number) =>
+      reps.reduce((total, rep) => total + value(rep), 0);
+
+    return {
+      summary: {
+        repCount: count,
+        setCount: this.sets.length,
+        meanVelocity: count > 0 ? sum((rep) => rep.meanVelocity) / count : 0,
+        peakVelocity: reps.reduce((peak, rep) => Math.max(peak, rep.peakVelocity), 0),
+        meanRangeOfMotion: count > 0 ? sum((rep) => rep.rangeOfMotion) / count : 0,
+        timeUnderTensionMs: sum((rep) => rep.timeUnderTensionMs),
+        maxVelocityLoss: this.sets.reduce((worst, set) => Math.max(worst, set.velocityLoss), 0),
+      },
+      sets: this.sets,
+      reps,
+    };
+  }
+
+  private trackGravity(
+    accX: number,
+    accY: number,
+    accZ: number,
+    accel: number,
+    gyrX: number,
+    gyrY: number,
+    gyrZ: number,
+    dt: number,
+  ) {
+    // A fixed world vector seen from the rotating sensor: dg/dt = -ω × g
+    const wx = gyrX * DEG_TO_RAD * dt;
+    const wy = gyrY * DEG_TO_RAD * dt;
+    const wz = gyrZ * DEG_TO_RAD * dt;
+    const g = this.gravity;
+    let x = g.x - (wy * g.z - wz * g.y);
+    let y = g.y - (wz * g.x - wx * g.z);
+    let z = g.z - (wx * g.y - wy * g.x);
+
+    // Only a sensor close to still measures gravity alone; anything looser
+    // lets slow lifts leak into the estimate
+    const rotation = Math.sqrt(gyrX * gyrX + gyrY * gyrY + gyrZ * gyrZ);
+    if (rotation < STILL_GYRO && Math.abs(accel - 1) < STILL_ACCEL) {
+      const gain = Math.min(1, dt / GRAVITY_TIME_CONSTANT);
+      x += gain * (accX / accel - x);
+      y += gain * (accY / accel - y);
+      z += gain * (accZ / accel - z);
+    }
+
+    const norm = Math.sqrt(x * x + y * y + z * z);
+    if (norm > 0) {
+      this.gravity = { x: x / norm, y: y / norm, z: z / norm };
+    }
+    return this.gravity;
+  }
+
+  private detectStill(timestamp: number, rotation: number, linear: number): boolean {
+    if (!(rotation < STILL_GYRO && linear < STILL_ACCEL)) {
+      this.quiet = false;
+      return false;
+    }
+    if (!this.quiet) {
+      this.quiet = true;
+      this.quietSince = timestamp;
+    }
+    return timestamp - this.quietSince >= STILL_DURATION;
+  }
+
+  private discardSegment(): void {
+    this.inMotion = false;
+    this.quiet = false;
+    this.velocity = 0;
+    this.segmentTimes = [];
+    this.segmentSteps = [];
+    this.segmentVelocity = [];
+  }
+
+  private closeSegment(): void {
+    const times = this.segmentTimes;
+    const steps = this.segmentSteps;
+    const velocity = this.segmentVelocity;
+
+    // Whatever velocity is left at the zero-velocity update is drift, assumed
+    // to have grown linearly over the segment
+    const duration = steps.reduce((total, step) => total + step, 0);
+    let elapsed = 0;
+    for (let i = 0; i < velocity.length; i++) {
+      elapsed += steps[i];
+      velocity[i] -= duration > 0 ? (this.velocity * elapsed) / duration : 0;
+    }
+
+    this.findReps(times, steps, velocity);
+    this.discardSegment();
+  }
+
+  /** Splits a segment at velocity zero crossings, like RepDetector::analyze */
+  private findReps(times: number[], steps: number[], velocity: number[]): void {
+    const count = velocity.length;
+    let eccentricPending = false;
+    let eccentricStart = 0;
+
+    // Current phase [phaseStart, i); active* bound the entries above MIN_VELOCITY
+    let phaseStart = 0;
+    let activeStart = 0;
+    let activeEnd = 0;
+    let active = false;
+    let displacement = 0;
+    let peak = 0;
+
+    for (let i = 0; i <= count; i++) {
+      const end = i === count;
+      if (!end && i > phaseStart && (velocity[i] < 0) === (velocity[phaseStart] < 0)) {
+        const speed = Math.abs(velocity[i]);
+        displacement += velocity[i] * steps[i];
+        peak = Math.max(peak, speed);
+        if (speed >= MIN_VELOCITY) {
+          if (!active) {
+            activeStart = i;
+          }
+          active = true;
+          activeEnd = i + 1;
+        }
+        continue;
+      }
+
+      // A sign change or the end of the segment closes the phase
+      if (active) {
+        const startTime = times[activeStart] - steps[activeStart] * 1000;
+        const lengthMs = times[activeEnd - 1] - startTime;
+
+        if (lengthMs > MAX_PHASE_DURATION) {
+          // A phase this long is drift, not a rep
+          eccentricPending = false;
+        } else if (displacement < 0) {
+          if (!eccentricPending) {
+            eccentricStart = activeStart;
+          }
+          eccentricPending = true;
+        } else if (displacement >= MIN_RANGE) {
+          const tensionStart = eccentricPending ? eccentricStart : activeStart;
+          const tensionStartTime = times[tensionStart] - steps[tensionStart] * 1000;
+          this.addRep({
+            setIndex: 0,
+            startTime: tensionStartTime,
+            endTime: times[activeEnd - 1],
+            meanVelocity: displacement / (lengthMs / 1000),
+            peakVelocity: peak,
+            rangeOfMotion: displacement,
+            concentricMs: lengthMs,
+            timeUnderTensionMs: times[activeEnd - 1] - tensionStartTime,
+          });
+          eccentricPending = false;
+        }
+      }
+
+      if (!end) {
+        phaseStart = i;
+        displacement = velocity[i] * steps[i];
+        peak = Math.abs(velocity[i]);
+        active = peak >= MIN_VELOCITY;
+        activeStart = i;
+        activeEnd = i + 1;
+      }
+    }
+  }
+
+  /** Groups reps into sets like SetTracker */
+  private addRep(rep: RepAnalytics): void {
+    let set = this.sets[this.sets.length - 1];
+    if (!set || rep.endTime - set.endTime > SET_REST_TIMEOUT) {
+      set = {
+        startTime: rep.startTime,
+        endTime: rep.endTime,
+        repCount: 0,
+        bestMeanVelocity: 0,
+        lastMeanVelocity: 0,
+        velocityLoss: 0,
+      };
+      this.sets.push(set);
+    }
+
+    set.repCount++;
+    set.endTime = rep.endTime;
+    set.lastMeanVelocity = rep.meanVelocity;
+    set.bestMeanVelocity = Math.max(set.bestMeanVelocity, rep.meanVelocity);
+    set.velocityLoss =
+      set.bestMeanVelocity > 0
+        ? ((set.bestMeanVelocity - set.lastMeanVelocity) / set.bestMeanVelocity) * 100
+        : 0;
+
+    rep.setIndex = this.sets.length - 1;
+    this.reps.push(rep);
+  }
+}
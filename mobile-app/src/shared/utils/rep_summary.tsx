@@ -0,0 +1,37 @@
+/**
+ * Decoder for the rep characteristic.
+ *
+ * Mirrors embedded/src/analysis/repProtocol.h. The device detects reps itself
+ * and notifies one little-endian summary per rep, so the app can show rep
+ * metrics without subscribing to the high-rate stream.
+ */
+export interface RepSummary {
+  repNumber: number;
+  endTime: number; // Device time in ms at the top of the rep
+  phoneEndTime?: number; // endTime on the phone clock, set once the clocks are synced
+  meanVelocity: number; // m/s, mean concentric velocity
+  peakVelocity: number; // m/s
+  rangeOfMotion: number; // m
+  concentricMs: number;
+  timeUnderTensionMs: number;
+}
+
+const REP_SUMMARY_SIZE = 16;
+
+/** Parses one notification, returns null for malformed packets */
+export const parseRepSummary = (bytes: Uint8Array): RepSummary | null => {
+  if (bytes.length < REP_SUMMARY_SIZE) {
+    return null;
+  }
+
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  return {
+    repNumber: view.getUint16(0, true),
+    endTime: view.getUint32(2, true),
+    meanVelocity: view.getUint16(6, true) / 1000,
+    peakVelocity: view.getUint16(8, true) / 1000,
+    rangeOfMotion: view.getUint16(10, true) / 1000,
+    concentricMs: view.getUint16(12, true),
+    timeUnderTensionMs: view.getUint16(14, true),
+  };
+};
@@ -0,0 +1,200 @@
+import { SAMPLE_CHANNELS } from './sample_ring';
+
+/**
+ * Packed storage blocks for recorded samples.
+ *
+ * Uses the firmware's INT16_DELTA encoding (embedded/src/stream/sampleBatcher.h):
+ * one absolute int16 sample, then zig-zag LEB128 varint deltas per channel.
+ * Phone timestamps are not evenly spaced once lost frames and clock sync are
+ * involved, so each sample also carries the change of its timestamp step in
+ * microseconds, which is zero for a steady stream.
+ *
+ * Chunk layout (little-endian):
+ *   uint8   version
+ *   uint8   reserved
+ *   uint16  sampleCount
+ *   float32 accelLsbPerG
+ *   float32 gyroLsbPerDps
+ *   float64 firstTimestamp (ms)
+ *   int16   accX, accY, accZ, gyrX, gyrY, gyrZ of the first sample
+ *   per later sample: varint timestamp step change, then six varint channel deltas
+ */
+export interface ChunkSample {
+  accX: number;
+  accY: number;
+  accZ: number;
+  gyrX: number;
+  gyrY: number;
+  gyrZ: number;
+  timestamp: number; // ms
+}
+
+const CHUNK_VERSION = 1;
+const CHUNK_HEADER_SIZE = 20;
+const FIRST_SAMPLE_SIZE = 12;
+const MAX_VARINT_SIZE = 8; // Enough for any timestamp step a chunk can hold
+const INT16_MAX = 32767;
+// Finest resolution of the IMU (±2 g, ±250 °/s), nothing is gained beyond this
+const MAX_ACCEL_LSB_PER_G = 16384;
+const MAX_GYRO_LSB_PER_DPS = 131;
+
+/**
+ * Largest scale that keeps channels [first, first + 3) of every sample inside int16
+ */
+const chooseScale = (
+  values: Float32Array,
+  start: number,
+  count: number,
+  first: number,
+  finest: number,
+) => {
+  let maxAbs = 0;
+  for (let i = start; i < start + count; i++) {
+    const base = i * SAMPLE_CHANNELS + first;
+    for (let c = 0; c < 3; c++) {
+      maxAbs = Math.max(maxAbs, Math.abs(values[base + c]));
+    }
+  }
+  // One LSB of headroom for the float32 rounding of the stored scale
+  return maxAbs > 0 ? Math.min(finest, (INT16_MAX - 1) / maxAbs) : finest;
+};
+
+// Arithmetic rather than bitwise, timestamp steps can exceed 32 bits
+const zigZag = (value: number): number => (value >= 0 ? value * 2 : -value * 2 - 1);
+const unZigZag = (value: number): number => (value % 2 === 0 ? value / 2 : -(value + 1) / 2);
+
+/**
+ * Packs samples [start, start + count) of columns like SampleRing's:
+ * timestamps in ms, and SAMPLE_CHANNELS values per sample
+ */
+export const encodeSampleChunk = (
+  timestamps: Float64Array,
+  values: Float32Array,
+  start: number,
+  count: number,
+): Uint8Array => {
+  const buffer = new Uint8Array(
+    CHUNK_HEADER_SIZE + FIRST_SAMPLE_SIZE + Math.max(count - 1, 0) * 7 * MAX_VARINT_SIZE,
+  );
+  const view = new DataView(buffer.buffer);
+
+  view.setUint8(0, CHUNK_VERSION);
+  view.setUint16(2, count, true);
+  view.setFloat32(4, chooseScale(values, start, count, 0, MAX_ACCEL_LSB_PER_G), true);
+  view.setFloat32(8, chooseScale(values, start, count, 3, MAX_GYRO_LSB_PER_DPS), true);
+  if (count === 0) {
+    return buffer.slice(0, CHUNK_HEADER_SIZE);
+  }
+
+  // Scale as stored, so decoding multiplies by exactly the inverse
+  const scales = [view.getFloat32(4, true), view.getFloat32(8, true)];
+  const quantize = (sample: number, c: number) =>
+    Math.round(values[sample * SAMPLE_CHANNELS + c] * scales[c < 3 ? 0 : 1]);
+
+  const firstTimestamp = timestamps[start];
+  view.setFloat64(12, firstTimestamp, true);
+  const channels = [0, 0, 0, 0, 0, 0];
+  for (let c = 0; c < SAMPLE_CHANNELS; c++) {
+    channels[c] = quantize(start, c);
+    view.setInt16(CHUNK_HEADER_SIZE + c * 2, channels[c], true);
+  }
+
+  let offset = CHUNK_HEADER_SIZE + FIRST_SAMPLE_SIZE;
+  const writeVarint = (signed: number) => {
+    let value = zigZag(signed);
+    while (value >= 0x80) {
+      buffer[offset++] = (value % 0x80) | 0x80;
+      value = Math.floor(value / 0x80);
+    }
+    buffer[offset++] = value;
+  };
+
+  let lastUs = 0;
+  let lastStepUs = 0;
+  for (let i = start + 1; i < start + count; i++) {
+    const us = Math.round((timestamps[i] - firstTimestamp) * 1000);
+    writeVarint(us - lastUs - lastStepUs);
+    lastStepUs = us - lastUs;
+    lastUs = us;
+
+    for (let c = 0; c < SAMPLE_CHANNELS; c++) {
+      const next = quantize(i, c);
+      writeVarint(next - channels[c]);
+      channels[c] = next;
+    }
+  }
+  return buffer.slice(0, offset);
+};
+
+/** Returns fewer samples than the header states if the chunk is truncated */
+export const decodeSampleChunk = (bytes: Uint8Array): ChunkSample[] => {
+  if (bytes.length < CHUNK_HEADER_SIZE) {
+    return [];
+  }
+
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  const count = view.getUint16(2, true);
+  if (view.getUint8(0) !== CHUNK_VERSION || count === 0) {
+    return [];
+  }
+  if (bytes.length < CHUNK_HEADER_SIZE + FIRST_SAMPLE_SIZE) {
+    return [];
+  }
+
+  const accelRes = 1 / view.getFloat32(4, true);
+  const gyroRes = 1 / view.getFloat32(8, true);
+  const firstTimestamp = view.getFloat64(12, true);
+  const channels = [0, 0, 0, 0, 0, 0];
+  for (let c = 0; c < 6; c++) {
+    channels[c] = view.getInt16(CHUNK_HEADER_SIZE + c * 2, true);
+  }
+
+  let offset = CHUNK_HEADER_SIZE + FIRST_SAMPLE_SIZE;
+  const readVarint = (): number | null => {
+    let value = 0;
+    let scale = 1;
+    let byte = 0;
+    do {
+      if (offset >= bytes.length) {
+        return null;
+      }
+      byte = bytes[offset++];
+      value += (byte & 0x7f) * scale;
+      scale *= 0x80;
+    } while (byte & 0x80);
+    return unZigZag(value);
+  };
+
+  const samples: ChunkSample[] = new Array(count);
+  let us = 0;
+  let stepUs = 0;
+  for (let i = 0; i < count; i++) {
+    if (i > 0) {
+      const stepChange = readVarint();
+      if (stepChange === null) {
+        return samples.slice(0, i);
+      }
+      stepUs += stepChange;
+      us += stepUs;
+
+      for (let c = 0; c < 6; c++) {
+        const delta = readVarint();
+        if (delta === null) {
+          return samples.slice(0, i);
+        }
+        channels[c] += delta;
+      }
+    }
+
+    samples[i] = {
+      accX: channels[0] * accelRes,
+      accY: channels[1] * accelRes,
+      accZ: channels[2] * accelRes,
+      gyrX: channels[3] * gyroRes,
+      gyrY: channels[4] * gyroRes,
+      gyrZ: channels[5] * gyroRes,
+      timestamp: firstTimestamp + us / 1000,
+    };
+  }
+  return samples;
+};
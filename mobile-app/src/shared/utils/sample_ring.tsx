@@ -0,0 +1,145 @@
+import type { SensorData } from '../services/ble_context';
+
+/**
+ * Preallocated columnar buffer of decoded stream samples.
+ *
+ * The stream decoder writes samples straight into these typed arrays, so a
+ * notification costs no per-sample objects. Samples are numbered from zero
+ * in arrival order and sample n lives in slot n & mask until it is
+ * overwritten capacity samples later. Listeners get the ring with the range
+ * of new sample numbers and read the columns in place, or copy them out.
+ */
+export const SAMPLE_CHANNELS = 6; // accX, accY, accZ, gyrX, gyrY, gyrZ
+const QUATERNION_CHANNELS = 4; // w, x, y, z
+const DEFAULT_CAPACITY = 8192; // Over 8 s at 1 kHz
+
+export type SampleListener = (ring: SampleRing, start: number, count: number) => void;
+
+export class SampleRing {
+  readonly capacity: number;
+  readonly mask: number;
+  readonly timestamps: Float64Array; // ms
+  readonly values: Float32Array; // SAMPLE_CHANNELS per slot
+  // Set for on-device fusion samples, whose values are then world-frame
+  // linear acceleration and zero rotation rates
+  readonly quaternions: Float32Array; // QUATERNION_CHANNELS per slot
+  readonly hasQuaternion: Uint8Array;
+  written = 0; // Samples committed so far, the number of the next sample
+
+  /** @param capacity Rounded up to a power of two */
+  constructor(capacity = DEFAULT_CAPACITY) {
+    let size = 1;
+    while (size < capacity) {
+      size *= 2;
+    }
+    this.capacity = size;
+    this.mask = size - 1;
+    this.timestamps = new Float64Array(size);
+    this.values = new Float32Array(size * SAMPLE_CHANNELS);
+    this.quaternions = new Float32Array(size * QUATERNION_CHANNELS);
+    this.hasQuaternion = new Uint8Array(size);
+  }
+
+  /** Oldest sample number still held */
+  get oldest(): number {
+    return Math.max(0, this.written - this.capacity);
+  }
+
+  slot(sample: number): number {
+    return sample & this.mask;
+  }
+
+  /**
+   * Writes the sample after the last committed one plus offset; writers fill
+   * a whole frame this way and commit it at once, so truncated frames leave
+   * nothing behind
+   */
+  set(
+    offset: number,
+    timestamp: number,
+    accX: number,
+    accY: number,
+    accZ: number,
+    gyrX: number,
+    gyrY: number,
+    gyrZ: number,
+  ): void {
+    const slot = (this.written + offset) & this.mask;
+    const base = slot * SAMPLE_CHANNELS;
+    this.timestamps[slot] = timestamp;
+    this.values[base] = accX;
+    this.values[base + 1] = accY;
+    this.values[base + 2] = accZ;
+    this.values[base + 3] = gyrX;
+    this.values[base + 4] = gyrY;
+    this.values[base + 5] = gyrZ;
+    this.hasQuaternion[slot] = 0;
+  }
+
+  setQuaternion(offset: number, w: number, x: number, y: number, z: number): void {
+    const slot = (this.written + offset) & this.mask;
+    const base = slot * QUATERNION_CHANNELS;
+    this.quaternions[base] = w;
+    this.quaternions[base + 1] = x;
+    this.quaternions[base + 2] = y;
+    this.quaternions[base + 3] = z;
+    this.hasQuaternion[slot] = 1;
+  }
+
+  commit(count: number): void {
+    this.written += count;
+  }
+
+  reset(): void {
+    this.written = 0;
+  }
+
+  /** Builds an object for one sample, for consumers that still need one */
+  toSensorData(sample: number): SensorData {
+    const slot = sample & this.mask;
+    const base = slot * SAMPLE_CHANNELS;
+    const data: SensorData = {
+      accX: this.values[base],
+      accY: this.values[base + 1],
+      accZ: this.values[base + 2],
+      gyrX: this.values[base + 3],
+      gyrY: this.values[base + 4],
+      gyrZ: this.values[base + 5],
+      timestamp: this.timestamps[slot],
+    };
+    if (this.hasQuaternion[slot]) {
+      const q = slot * QUATERNION_CHANNELS;
+      data.quaternion = {
+        w: this.quaternions[q],
+        x: this.quaternions[q + 1],
+        y: this.quaternions[q + 2],
+        z: this.quaternions[q + 3],
+      };
+    }
+    return data;
+  }
+
+  /**
+   * Copies samples [start, start + count) into columns at offset, in at most
+   * two block copies across the wrap
+   */
+  copyTo(
+    start: number,
+    count: number,
+    timestamps: Float64Array,
+    values: Float32Array,
+    offset: number,
+  ): void {
+    let copied = 0;
+    while (copied < count) {
+      const slot = (start + copied) & this.mask;
+      const run = Math.min(count - copied, this.capacity - slot);
+      timestamps.set(this.timestamps.subarray(slot, slot + run), offset + copied);
+      values.set(
+        this.values.subarray(slot * SAMPLE_CHANNELS, (slot + run) * SAMPLE_CHANNELS),
+        (offset + copied) * SAMPLE_CHANNELS,
+      );
+      copied += run;
+    }
+  }
+}
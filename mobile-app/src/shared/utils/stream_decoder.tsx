@@ -0,0 +1,344 @@
+import type { SensorData } from '../services/ble_context';
+import { AcquisitionProfile } from '../types/acquisition';
+import { UnitRole } from '../types/unit';
+import { SampleRing } from './sample_ring';
+
+/**
+ * Decoder for the batched sample stream characteristic.
+ *
+ * Frame layout (little-endian), mirrors embedded/src/stream/streamProtocol.h:
+ *   uint8  format
+ *   uint8  sampleCount
+ *   uint16 sequence
+ *   uint32 baseTimestampUs
+ *   uint16 samplePeriodUs
+ *   uint8  unit (session version 2 and later: role and low unit ID bits)
+ *   sampleCount samples in the given format
+ *
+ * A session header frame (first byte SESSION_HEADER) describes the scale of
+ * quantized formats, the calibration applied on the device and the unit.
+ */
+export enum StreamFormat {
+  FLOAT32 = 1,
+  INT16 = 2,
+  INT16_DELTA = 3,
+  FUSION = 4,
+  SESSION_HEADER = 0x80,
+}
+
+export interface StreamSession {
+  version: number;
+  sampleFormat: StreamFormat;
+  profile?: AcquisitionProfile; // Missing on firmware without profile support
+  role?: UnitRole; // Missing on firmware without multi-unit support
+  unitId?: number;
+  accelLsbPerG: number;
+  gyroLsbPerDps: number;
+  calibration: {
+    isValid: boolean;
+    accelScale: number;
+    accelBias: [number, number, number];
+    gyroBias: [number, number, number];
+  };
+}
+
+const HEADER_SIZE_V1 = 10;
+const HEADER_SIZE = 11;
+const SESSION_HEADER_SIZE = 40;
+const SESSION_HEADER_PROFILE_OFFSET = 40;
+const SESSION_HEADER_UNIT_OFFSET = 41; // role, then uint32 unit ID
+const SESSION_HEADER_UNIT_SIZE = 46;
+const FLOAT32_SAMPLE_SIZE = 24;
+const INT16_SAMPLE_SIZE = 12;
+const FUSION_SAMPLE_SIZE = 14;
+const QUATERNION_SCALE = 16384; // Q14
+const UINT32_RANGE = 0x100000000;
+const MAX_FRAME_SAMPLES = 255; // sampleCount is one byte
+
+// Firmware defaults (±8 g, ±250 °/s), used until a session header arrives
+const DEFAULT_ACCEL_LSB_PER_G = 4096;
+const DEFAULT_GYRO_LSB_PER_DPS = 131;
+
+export class StreamDecoder {
+  private lastSequence: number | null = null;
+  private lastBaseUs = 0;
+  private wrapOffsetUs = 0;
+  lostFrames = 0;
+  bytesReceived = 0;
+  samplesReceived = 0;
+  session: StreamSession | null = null;
+  private frameRing = new SampleRing(MAX_FRAME_SAMPLES);
+  private channels = new Int32Array(6);
+  private viewBytes: Uint8Array | null = null;
+  private view: DataView | null = null;
+
+  reset(): void {
+    this.lastSequence = null;
+    this.lastBaseUs = 0;
+    this.wrapOffsetUs = 0;
+    this.lostFrames = 0;
+    this.bytesReceived = 0;
+    this.samplesReceived = 0;
+    this.session = null;
+  }
+
+  /** Float32 sample bytes per byte received, as reported by the firmware */
+  get compressionRatio(): number {
+    return this.bytesReceived > 0
+      ? (this.samplesReceived * FLOAT32_SAMPLE_SIZE) / this.bytesReceived
+      : 0;
+  }
+
+  /**
+   * Decodes one notification into samples with millisecond timestamps.
+   * Returns an empty array for malformed or unsupported frames.
+   */
+  decode(bytes: Uint8Array): SensorData[] {
+    const count = this.decodeInto(bytes, bytes.length, this.frameRing);
+    const samples: SensorData[] = new Array(count);
+    const start = this.frameRing.written - count;
+    for (let i = 0; i < count; i++) {
+      samples[i] = this.frameRing.toSensorData(start + i);
+    }
+    return samples;
+  }
+
+  /**
+   * Decodes the first length bytes of one notification into ring, without
+   * creating any objects. The frame is committed whole or not at all.
+   * @returns Samples committed, zero for headers and malformed frames
+   */
+  decodeInto(bytes: Uint8Array, length: number, ring: SampleRing): number {
+    if (length < 1) {
+      return 0;
+    }
+
+    // The same receive buffer comes back for every notification
+    if (this.viewBytes !== bytes) {
+      this.viewBytes = bytes;
+      this.view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    }
+    const view = this.view!;
+    const format = view.getUint8(0);
+
+    if (format === StreamFormat.SESSION_HEADER) {
+      this.decodeSessionHeader(view, length);
+      return 0;
+    }
+    // Version 1 frames have no unit byte
+    const headerSize = (this.session?.version ?? 1) >= 2 ? HEADER_SIZE : HEADER_SIZE_V1;
+    if (length < headerSize) {
+      return 0;
+    }
+
+    const sampleCount = view.getUint8(1);
+    const sequence = view.getUint16(2, true);
+    const baseUs = view.getUint32(4, true);
+    const periodUs = view.getUint16(8, true);
+
+    if (format === StreamFormat.INT16_DELTA) {
+      // Variable length; only the absolute first sample has a fixed size
+      if (sampleCount > 0 && length < headerSize + INT16_SAMPLE_SIZE) {
+        return 0;
+      }
+    } else {
+      const sampleSize =
+        format === StreamFormat.FLOAT32
+          ? FLOAT32_SAMPLE_SIZE
+          : format === StreamFormat.INT16
+            ? INT16_SAMPLE_SIZE
+            : format === StreamFormat.FUSION
+              ? FUSION_SAMPLE_SIZE
+              : 0;
+      if (sampleSize === 0 || length < headerSize + sampleCount * sampleSize) {
+        return 0;
+      }
+    }
+
+    const baseMs = this.unwrapTimestamp(baseUs) / 1000;
+    const periodMs = periodUs / 1000;
+    const accelRes = 1 / (this.session?.accelLsbPerG ?? DEFAULT_ACCEL_LSB_PER_G);
+    const gyroRes = 1 / (this.session?.gyroLsbPerDps ?? DEFAULT_GYRO_LSB_PER_DPS);
+
+    if (format === StreamFormat.INT16_DELTA) {
+      const complete = this.decodeDeltaSamples(
+        bytes,
+        length,
+        headerSize,
+        sampleCount,
+        baseMs,
+        periodMs,
+        ring,
+      );
+      if (!complete) {
+        return 0;
+      }
+    } else if (format === StreamFormat.FLOAT32) {
+      for (let i = 0; i < sampleCount; i++) {
+        const offset = headerSize + i * FLOAT32_SAMPLE_SIZE;
+        ring.set(
+          i,
+          baseMs + i * periodMs,
+          view.getFloat32(offset, true),
+          view.getFloat32(offset + 4, true),
+          view.getFloat32(offset + 8, true),
+          view.getFloat32(offset + 12, true),
+          view.getFloat32(offset + 16, true),
+          view.getFloat32(offset + 20, true),
+        );
+      }
+    } else if (format === StreamFormat.FUSION) {
+      for (let i = 0; i < sampleCount; i++) {
+        const offset = headerSize + i * FUSION_SAMPLE_SIZE;
+        ring.set(
+          i,
+          baseMs + i * periodMs,
+          view.getInt16(offset + 8, true) * accelRes,
+          view.getInt16(offset + 10, true) * accelRes,
+          view.getInt16(offset + 12, true) * accelRes,
+          0,
+          0,
+          0,
+        );
+        ring.setQuaternion(
+          i,
+          view.getInt16(offset, true) / QUATERNION_SCALE,
+          view.getInt16(offset + 2, true) / QUATERNION_SCALE,
+          view.getInt16(offset + 4, true) / QUATERNION_SCALE,
+          view.getInt16(offset + 6, true) / QUATERNION_SCALE,
+        );
+      }
+    } else {
+      for (let i = 0; i < sampleCount; i++) {
+        const offset = headerSize + i * INT16_SAMPLE_SIZE;
+        ring.set(
+          i,
+          baseMs + i * periodMs,
+          view.getInt16(offset, true) * accelRes,
+          view.getInt16(offset + 2, true) * accelRes,
+          view.getInt16(offset + 4, true) * accelRes,
+          view.getInt16(offset + 6, true) * gyroRes,
+          view.getInt16(offset + 8, true) * gyroRes,
+          view.getInt16(offset + 10, true) * gyroRes,
+        );
+      }
+    }
+
+    ring.commit(sampleCount);
+    this.trackSequence(sequence);
+    this.bytesReceived += length;
+    this.samplesReceived += sampleCount;
+    return sampleCount;
+  }
+
+  /**
+   * Decodes an INT16_DELTA payload: one absolute int16 sample followed by
+   * zig-zag LEB128 varint deltas per channel.
+   * @returns False if the frame is truncated
+   */
+  private decodeDeltaSamples(
+    bytes: Uint8Array,
+    length: number,
+    headerSize: number,
+    sampleCount: number,
+    baseMs: number,
+    periodMs: number,
+    ring: SampleRing,
+  ): boolean {
+    const view = this.view!;
+    const accelRes = 1 / (this.session?.accelLsbPerG ?? DEFAULT_ACCEL_LSB_PER_G);
+    const gyroRes = 1 / (this.session?.gyroLsbPerDps ?? DEFAULT_GYRO_LSB_PER_DPS);
+    const channels = this.channels;
+
+    let offset = headerSize;
+    for (let c = 0; c < 6; c++) {
+      channels[c] = view.getInt16(offset + c * 2, true);
+    }
+    offset += INT16_SAMPLE_SIZE;
+
+    for (let i = 0; i < sampleCount; i++) {
+      if (i > 0) {
+        for (let c = 0; c < 6; c++) {
+          let value = 0;
+          let shift = 0;
+          let byte = 0;
+          do {
+            if (offset >= length) {
+              return false;
+            }
+            byte = bytes[offset++];
+            value |= (byte & 0x7f) << shift;
+            shift += 7;
+          } while (byte & 0x80);
+          channels[c] += (value >>> 1) ^ -(value & 1); // zig-zag decode
+        }
+      }
+
+      ring.set(
+        i,
+        baseMs + i * periodMs,
+        channels[0] * accelRes,
+        channels[1] * accelRes,
+        channels[2] * accelRes,
+        channels[3] * gyroRes,
+        channels[4] * gyroRes,
+        channels[5] * gyroRes,
+      );
+    }
+    return true;
+  }
+
+  private decodeSessionHeader(view: DataView, length: number): void {
+    if (length < SESSION_HEADER_SIZE) {
+      return;
+    }
+
+    this.session = {
+      version: view.getUint8(1),
+      sampleFormat: view.getUint8(2),
+      profile:
+        length > SESSION_HEADER_PROFILE_OFFSET
+          ? view.getUint8(SESSION_HEADER_PROFILE_OFFSET)
+          : undefined,
+      ...(length >= SESSION_HEADER_UNIT_SIZE
+        ? {
+            role: view.getUint8(SESSION_HEADER_UNIT_OFFSET),
+            unitId: view.getUint32(SESSION_HEADER_UNIT_OFFSET + 1, true),
+          }
+        : {}),
+      accelLsbPerG: view.getFloat32(4, true),
+      gyroLsbPerDps: view.getFloat32(8, true),
+      calibration: {
+        isValid: view.getUint8(3) !== 0,
+        accelScale: view.getFloat32(12, true),
+        accelBias: [
+          view.getFloat32(16, true),
+          view.getFloat32(20, true),
+          view.getFloat32(24, true),
+        ],
+        gyroBias: [
+          view.getFloat32(28, true),
+          view.getFloat32(32, true),
+          view.getFloat32(36, true),
+        ],
+      },
+    };
+  }
+
+  private trackSequence(sequence: number): void {
+    if (this.lastSequence !== null) {
+      const gap = (sequence - this.lastSequence - 1) & 0xffff;
+      this.lostFrames += gap;
+    }
+    this.lastSequence = sequence;
+  }
+
+  // Device timestamps are 32-bit microseconds and wrap every ~71 minutes
+  private unwrapTimestamp(baseUs: number): number {
+    if (baseUs < this.lastBaseUs && this.lastBaseUs - baseUs > UINT32_RANGE / 2) {
+      this.wrapOffsetUs += UINT32_RANGE;
+    }
+    this.lastBaseUs = baseUs;
+    return baseUs + this.wrapOffsetUs;
+  }
+}
@@ -0,0 +1,108 @@
+import type { SampleRing } from './sample_ring';
+
+// A unit silent for this long no longer holds back the others, e.g. after a dropout
+const MAX_LAG_MS = 200;
+
+export type MergedSampleListener = (unit: number, ring: SampleRing, sample: number) => void;
+
+// Samples [next, end) of the unit's ring, pushed but not emitted yet
+interface UnitQueue {
+  ring: SampleRing;
+  next: number;
+  end: number;
+}
+
+/**
+ * Interleaves the streams of several units in phone time.
+ *
+ * Samples must already be on the phone clock (ClockSync.toPhoneTime), so
+ * they line up without resampling. Each unit decodes into its own
+ * SampleRing and pushes the range of sample numbers it added; the merger
+ * only keeps the range not emitted yet, so nothing is copied. Each unit
+ * arrives in order but in frames of its own timing, so samples are held
+ * until every active unit has streamed past them and then emitted in
+ * timestamp order with the unit they came from.
+ */
+export class StreamMerger {
+  private queues = new Map<number, UnitQueue>();
+  private latest = new Map<number, number>(); // Newest timestamp per unit
+
+  constructor(private emit: MergedSampleListener) {}
+
+  get unitCount(): number {
+    return this.queues.size;
+  }
+
+  addUnit(unit: number, ring: SampleRing): void {
+    if (!this.queues.has(unit)) {
+      this.queues.set(unit, { ring, next: ring.written, end: ring.written });
+    }
+  }
+
+  /** Emits what the unit still held back the others for, then forgets it */
+  removeUnit(unit: number): void {
+    this.queues.delete(unit);
+    this.latest.delete(unit);
+    this.drain(Infinity);
+  }
+
+  reset(): void {
+    this.queues.clear();
+    this.latest.clear();
+  }
+
+  /** Takes samples [start, start + count) of the unit's ring */
+  push(unit: number, start: number, count: number): void {
+    const queue = this.queues.get(unit);
+    if (!queue || count === 0) {
+      return;
+    }
+
+    if (start !== queue.end) {
+      // Not contiguous with what is held, e.g. after a ring reset: start over from here
+      queue.next = start;
+    }
+    queue.end = start + count;
+    const ring = queue.ring;
+    this.latest.set(unit, ring.timestamps[ring.slot(queue.end - 1)]);
+
+    // Everything up to the slowest unit still streaming is complete
+    const newest = Math.max(...this.latest.values());
+    let watermark = Infinity;
+    for (const unitId of this.queues.keys()) {
+      const timestamp = this.latest.get(unitId);
+      if (timestamp !== undefined && newest - timestamp <= MAX_LAG_MS) {
+        watermark = Math.min(watermark, timestamp);
+      } else if (timestamp === undefined && this.latest.size < this.queues.size) {
+        // Waits for a unit that has not streamed yet, up to the lag limit
+        watermark = Math.min(watermark, newest - MAX_LAG_MS);
+      }
+    }
+    this.drain(watermark);
+  }
+
+  private drain(watermark: number): void {
+    for (;;) {
+      let nextUnit = -1;
+      let next: UnitQueue | undefined;
+      let nextTimestamp = Infinity;
+      for (const [unit, queue] of this.queues) {
+        // A unit held back so long that its ring wrapped loses the overwritten samples
+        queue.next = Math.max(queue.next, queue.ring.oldest);
+        if (queue.next >= queue.end) {
+          continue;
+        }
+        const timestamp = queue.ring.timestamps[queue.ring.slot(queue.next)];
+        if (!next || timestamp < nextTimestamp) {
+          nextUnit = unit;
+          next = queue;
+          nextTimestamp = timestamp;
+        }
+      }
+      if (!next || nextTimestamp > watermark) {
+        return;
+      }
+      this.emit(nextUnit, next.ring, next.next++);
+    }
+  }
+}
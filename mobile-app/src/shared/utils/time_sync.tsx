@@ -0,0 +1,157 @@
+/**
+ * Clock mapping for the time sync characteristic.
+ *
+ * Mirrors embedded/src/ble/timeSyncProtocol.h. The app writes pings and the
+ * device echoes each one with its receive and transmit times in microseconds
+ * of the clock the sample timestamps use. ClockSync turns these exchanges
+ * into the offset and skew between that clock and the phone's, so streamed
+ * samples get phone timestamps that do not slowly drift apart.
+ */
+export interface TimeSyncEcho {
+  version: number;
+  sequence: number;
+  receiveUs: number; // Device time the ping arrived
+  transmitUs: number; // Device time the echo was sent
+}
+
+interface SyncPoint {
+  deviceUs: number; // Midpoint of the device receive and transmit times
+  phoneMs: number; // Midpoint of the phone send and receive times
+  roundTripMs: number; // Excluding the time the device held the ping
+}
+
+const TIME_SYNC_ECHO_SIZE = 19;
+const UINT32_RANGE = 0x100000000;
+// Exchanges kept for the fit; at one ping every few seconds this spans minutes
+const MAX_POINTS = 64;
+// Device time the kept exchanges must span before a skew is estimated
+const MIN_SKEW_SPAN_MS = 20000;
+// Crystal tolerances on both sides stay well below this
+const MAX_SKEW = 500e-6;
+
+export const encodeTimeSyncPing = (sequence: number): Uint8Array =>
+  new Uint8Array([sequence & 0xff, (sequence >> 8) & 0xff]);
+
+/** Parses one notification, returns null for malformed packets */
+export const parseTimeSyncEcho = (bytes: Uint8Array): TimeSyncEcho | null => {
+  if (bytes.length < TIME_SYNC_ECHO_SIZE) {
+    return null;
+  }
+
+  const view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+  // Two 32-bit halves instead of BigInt; exact for centuries of uptime
+  const readUint64 = (offset: number) =>
+    view.getUint32(offset, true) + view.getUint32(offset + 4, true) * UINT32_RANGE;
+  return {
+    version: view.getUint8(0),
+    sequence: view.getUint16(1, true),
+    receiveUs: readUint64(3),
+    transmitUs: readUint64(11),
+  };
+};
+
+/** Monotonic phone clock in ms, used for both ends of every ping */
+export const phoneNow = (): number => performance.now();
+
+/**
+ * Estimates phone time = device time + offset + skew * elapsed device time.
+ *
+ * Only the exchanges with the shortest round trips are fitted: their
+ * midpoints carry the least queueing delay from connection events. The
+ * offset comes from the mean of those exchanges until they span long
+ * enough for a least squares line to give the skew as well.
+ */
+export class ClockSync {
+  private points: SyncPoint[] = [];
+  private referenceDeviceUs = 0;
+  private offsetMs = 0; // phone - device at referenceDeviceUs
+  private skew = 0; // Phone ms per device ms, minus one
+  private wallClockOffsetMs = Date.now() - phoneNow();
+
+  get isSynced(): boolean {
+    return this.points.length > 0;
+  }
+
+  /** Shortest round trip seen, an upper bound on twice the offset error */
+  get bestRoundTripMs(): number {
+    return this.points.reduce((best, p) => Math.min(best, p.roundTripMs), Infinity);
+  }
+
+  get skewPpm(): number {
+    return this.skew * 1e6;
+  }
+
+  reset(): void {
+    this.points = [];
+    this.referenceDeviceUs = 0;
+    this.offsetMs = 0;
+    this.skew = 0;
+    this.wallClockOffsetMs = Date.now() - phoneNow();
+  }
+
+  /**
+   * Adds one ping exchange
+   * @param sentMs phoneNow() right before the ping was written
+   * @param receivedMs phoneNow() when the echo arrived
+   */
+  addExchange(sentMs: number, receivedMs: number, echo: TimeSyncEcho): void {
+    const heldMs = (echo.transmitUs - echo.receiveUs) / 1000;
+    const roundTripMs = receivedMs - sentMs - heldMs;
+    if (roundTripMs < 0) {
+      return;
+    }
+
+    this.points.push({
+      deviceUs: (echo.receiveUs + echo.transmitUs) / 2,
+      phoneMs: (sentMs + receivedMs) / 2,
+      roundTripMs,
+    });
+    if (this.points.length > MAX_POINTS) {
+      this.points.shift();
+    }
+    this.fit();
+  }
+
+  /**
+   * Converts device time to wall-clock ms on the phone clock.
+   *
+   * Also accepts device time truncated to 32-bit microseconds, like stream
+   * frame timestamps: it is taken to be the wrap closest to the last sync.
+   */
+  toPhoneTime(deviceMs: number): number {
+    let deviceUs = deviceMs * 1000;
+    const wraps = Math.round((this.referenceDeviceUs - deviceUs) / UINT32_RANGE);
+    if (wraps > 0) {
+      deviceUs += wraps * UINT32_RANGE;
+    }
+
+    const elapsedMs = (deviceUs - this.referenceDeviceUs) / 1000;
+    return deviceUs / 1000 + this.offsetMs + this.skew * elapsedMs + this.wallClockOffsetMs;
+  }
+
+  private fit(): void {
+    const sorted = [...this.points].sort((a, b) => a.roundTripMs - b.roundTripMs);
+    const best = sorted.slice(0, Math.max(1, Math.ceil(sorted.length / 2)));
+
+    this.referenceDeviceUs = Math.max(...best.map((p) => p.deviceUs));
+    const x = best.map((p) => (p.deviceUs - this.referenceDeviceUs) / 1000);
+    const y = best.map((p) => p.phoneMs - p.deviceUs / 1000);
+    const meanX = x.reduce((sum, v) => sum + v, 0) / x.length;
+    const meanY = y.reduce((sum, v) => sum + v, 0) / y.length;
+
+    let skew = 0;
+    if (-Math.min(...x) >= MIN_SKEW_SPAN_MS) {
+      let covariance = 0;
+      let variance = 0;
+      for (let i = 0; i < x.length; i++) {
+        covariance += (x[i] - meanX) * (y[i] - meanY);
+        variance += (x[i] - meanX) * (x[i] - meanX);
+      }
+      skew = variance > 0 ? covariance / variance : 0;
+      skew = Math.max(-MAX_SKEW, Math.min(MAX_SKEW, skew));
+    }
+
+    this.skew = skew;
+    this.offsetMs = meanY - skew * meanX;
+  }
+}